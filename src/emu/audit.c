@@ -28,6 +28,8 @@ media_auditor::media_auditor(const driver_enumerator &enumerator)
 		m_validation(AUDIT_VALIDATE_FULL),
 		m_searchpath(NULL)
 {
+	// reuse hashes from earlier audits if there is a cache
+	g_hash_cache.configure(m_enumerator.options());
 }
 
 
@@ -436,7 +438,7 @@ audit_record *media_auditor::audit_one_rom(const rom_entry *rom)
 		// if it worked, get the actual length and hashes, then stop
 		if (filerr == FILERR_NONE)
 		{
-			record.set_actual(file.hashes(m_validation), file.size());
+			record.set_actual(g_hash_cache.hashes(file, m_validation), file.size());
 			break;
 		}
 	}
@@ -0,0 +1,181 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    benchmark.c
+
+    Per-frame timing of headless benchmark runs.
+
+***************************************************************************/
+
+#include "emu.h"
+
+
+
+//**************************************************************************
+//  FRAME BENCHMARK
+//**************************************************************************
+
+//-------------------------------------------------
+//  frame_benchmark - constructor
+//-------------------------------------------------
+
+frame_benchmark::frame_benchmark(running_machine &machine, int frames, const char *filename)
+	: m_machine(machine),
+		m_frames(frames),
+		m_filename(filename),
+		m_ticks_per_second(osd_ticks_per_second()),
+		m_record(frames),
+		m_recorded(0),
+		m_started(false),
+		m_start_time(attotime::zero),
+		m_last_wall(0),
+		m_last_video(0),
+		m_last_sound(0),
+		m_video_ticks(0),
+		m_sound_ticks(0)
+{
+	// find all the executing devices
+	execute_interface_iterator iter(machine.root_device());
+	for (device_execute_interface *exec = iter.first(); exec != NULL; exec = iter.next())
+		m_device.append(exec);
+	m_device_ticks.resize(frames * m_device.count());
+	m_last_device.resize_and_clear(m_device.count());
+
+	// have the scheduler time each device, and get called at the end of each frame
+	machine.scheduler().set_execution_timing(true);
+	machine.add_notifier(MACHINE_NOTIFY_FRAME, machine_notify_delegate(FUNC(frame_benchmark::frame_update), this));
+	machine.add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(FUNC(frame_benchmark::write_results), this));
+}
+
+
+//-------------------------------------------------
+//  frame_update - record the timings for the
+//  frame that just ended
+//-------------------------------------------------
+
+void frame_benchmark::frame_update()
+{
+	// only count frames that actually ran
+	if (machine().phase() != MACHINE_PHASE_RUNNING || machine().paused() || m_recorded >= m_frames)
+		return;
+
+	// the first frame just establishes the starting point
+	osd_ticks_t now = osd_ticks();
+	if (m_started)
+	{
+		frame_record &record = m_record[m_recorded];
+		record.m_time = machine().time();
+		record.m_wall = now - m_last_wall;
+		record.m_video = m_video_ticks - m_last_video;
+		record.m_sound = m_sound_ticks - m_last_sound;
+		for (int devnum = 0; devnum < m_device.count(); devnum++)
+			m_device_ticks[m_recorded * m_device.count() + devnum] = m_device[devnum]->execution_ticks() - m_last_device[devnum];
+
+		// when we have enough, we're done
+		if (++m_recorded == m_frames)
+			machine().schedule_exit();
+	}
+	else
+	{
+		m_start_time = machine().time();
+		m_started = true;
+	}
+
+	// remember where we are for next time
+	m_last_wall = now;
+	m_last_video = m_video_ticks;
+	m_last_sound = m_sound_ticks;
+	for (int devnum = 0; devnum < m_device.count(); devnum++)
+		m_last_device[devnum] = m_device[devnum]->execution_ticks();
+}
+
+
+//-------------------------------------------------
+//  write_results - summarize the results and
+//  write them to the output file
+//-------------------------------------------------
+
+void frame_benchmark::write_results()
+{
+	if (m_recorded == 0)
+	{
+		osd_printf_warning("Benchmark: no frames were recorded\n");
+		return;
+	}
+
+	// print a summary
+	osd_ticks_t totalwall = 0;
+	for (int framenum = 0; framenum < m_recorded; framenum++)
+		totalwall += m_record[framenum].m_wall;
+	double emuseconds = (m_record[m_recorded - 1].m_time - m_start_time).as_double();
+	double wallseconds = double(totalwall) / double(m_ticks_per_second);
+	osd_printf_info("Benchmark: %d frames, %.3f emulated seconds in %.3f seconds (%.2f%%), %.1f us per frame\n",
+		m_recorded, emuseconds, wallseconds, (wallseconds > 0) ? (emuseconds * 100.0 / wallseconds) : 0.0, to_usec(totalwall) / m_recorded);
+
+	// write the per-frame results
+	if (!m_filename)
+		return;
+	emu_file file(OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file.open(m_filename) != FILERR_NONE)
+	{
+		osd_printf_error("Benchmark: unable to open '%s' for writing\n", m_filename.cstr());
+		return;
+	}
+
+	astring extension(m_filename);
+	int dot = extension.rchr(0, '.');
+	if (dot != -1 && core_stricmp(extension.substr(dot, extension.len() - dot), ".json") == 0)
+		write_json(file);
+	else
+		write_csv(file);
+}
+
+
+//-------------------------------------------------
+//  write_csv - write one line per frame, with a
+//  column for each device
+//-------------------------------------------------
+
+void frame_benchmark::write_csv(emu_file &file)
+{
+	// header
+	file.printf("frame,emu_time,wall_us,video_us,sound_us");
+	for (int devnum = 0; devnum < m_device.count(); devnum++)
+		file.printf(",%s_us", m_device[devnum]->device().tag());
+	file.printf("\n");
+
+	// one row per frame
+	for (int framenum = 0; framenum < m_recorded; framenum++)
+	{
+		const frame_record &record = m_record[framenum];
+		file.printf("%d,%.9f,%.1f,%.1f,%.1f", framenum, record.m_time.as_double(), to_usec(record.m_wall), to_usec(record.m_video), to_usec(record.m_sound));
+		for (int devnum = 0; devnum < m_device.count(); devnum++)
+			file.printf(",%.1f", to_usec(m_device_ticks[framenum * m_device.count() + devnum]));
+		file.printf("\n");
+	}
+}
+
+
+//-------------------------------------------------
+//  write_json - write an object describing the
+//  run, with an array of frames
+//-------------------------------------------------
+
+void frame_benchmark::write_json(emu_file &file)
+{
+	file.printf("{\n");
+	file.printf("\t\"system\": \"%s\",\n", machine().system().name);
+	file.printf("\t\"frames\": [\n");
+	for (int framenum = 0; framenum < m_recorded; framenum++)
+	{
+		const frame_record &record = m_record[framenum];
+		file.printf("\t\t{ \"frame\": %d, \"emu_time\": %.9f, \"wall_us\": %.1f, \"video_us\": %.1f, \"sound_us\": %.1f, \"devices\": {",
+			framenum, record.m_time.as_double(), to_usec(record.m_wall), to_usec(record.m_video), to_usec(record.m_sound));
+		for (int devnum = 0; devnum < m_device.count(); devnum++)
+			file.printf("%s \"%s\": %.1f", (devnum == 0) ? "" : ",", m_device[devnum]->device().tag(), to_usec(m_device_ticks[framenum * m_device.count() + devnum]));
+		file.printf(" } }%s\n", (framenum == m_recorded - 1) ? "" : ",");
+	}
+	file.printf("\t]\n");
+	file.printf("}\n");
+}
@@ -0,0 +1,104 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    benchmark.h
+
+    Per-frame timing of headless benchmark runs.
+
+****************************************************************************
+
+    When -bench_frames is set, the machine runs for that many video
+    frames with rendering, sound output and throttling disabled, and
+    then exits. For each frame, the following are recorded:
+
+        - the emulated time at the end of the frame
+        - the wall-clock time taken by the frame
+        - the time spent executing each CPU (and other executing device)
+        - the time spent rendering screen updates
+        - the time spent in the periodic sound update
+
+    Device time is measured around each call into the device's execute
+    loop. Screen updates and sound stream updates that a device forces
+    in the middle of its timeslice are counted against that device as
+    well as against video or sound.
+
+    The results are written to the file named by -bench_output when the
+    machine exits: as JSON if the name ends in .json, or as CSV
+    otherwise. All times are in microseconds.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __EMU_H__
+#error Dont include this file directly; include emu.h instead.
+#endif
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+
+
+//**************************************************************************
+//  TYPE DEFINITIONS
+//**************************************************************************
+
+// ======================> frame_benchmark
+
+class frame_benchmark
+{
+public:
+	// construction/destruction
+	frame_benchmark(running_machine &machine, int frames, const char *filename);
+
+	// getters
+	running_machine &machine() const { return m_machine; }
+	int frames_recorded() const { return m_recorded; }
+
+	// timing accumulation
+	void add_video_ticks(osd_ticks_t ticks) { m_video_ticks += ticks; }
+	void add_sound_ticks(osd_ticks_t ticks) { m_sound_ticks += ticks; }
+
+private:
+	// a single frame's worth of results
+	struct frame_record
+	{
+		attotime            m_time;                 // emulated time at the end of the frame
+		osd_ticks_t         m_wall;                 // wall-clock time for the whole frame
+		osd_ticks_t         m_video;                // time spent rendering screens
+		osd_ticks_t         m_sound;                // time spent updating sound
+	};
+
+	// internal helpers
+	void frame_update();
+	void write_results();
+	void write_csv(emu_file &file);
+	void write_json(emu_file &file);
+	double to_usec(osd_ticks_t ticks) const { return double(ticks) * 1000000.0 / double(m_ticks_per_second); }
+
+	// internal state
+	running_machine &       m_machine;              // reference to our machine
+	int                     m_frames;               // number of frames to run
+	astring                 m_filename;             // name of the output file
+	osd_ticks_t             m_ticks_per_second;     // cached tick rate
+	dynamic_array<device_execute_interface *> m_device; // list of executing devices
+	dynamic_array<frame_record> m_record;           // per-frame results
+	dynamic_array<osd_ticks_t> m_device_ticks;      // per-frame, per-device execution time
+	int                     m_recorded;             // number of frames recorded so far
+	bool                    m_started;              // true once the first frame has gone by
+	attotime                m_start_time;           // emulated time at the first frame
+
+	// running totals at the last frame boundary
+	osd_ticks_t             m_last_wall;            // wall-clock time
+	osd_ticks_t             m_last_video;           // video ticks
+	osd_ticks_t             m_last_sound;           // sound ticks
+	dynamic_array<osd_ticks_t> m_last_device;       // execution ticks of each device
+
+	// running totals
+	osd_ticks_t             m_video_ticks;          // time spent rendering screens
+	osd_ticks_t             m_sound_ticks;          // time spent updating sound
+};
+
+
+#endif  /* __BENCHMARK_H__ */
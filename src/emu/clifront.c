@@ -944,8 +944,9 @@ void cli_frontend::verifyroms(const char *gamename)
 		}
 	}
 
-	// clear out any cached files
+	// clear out any cached files, and save any hashes we computed
 	zip_file_cache_clear();
+	g_hash_cache.flush();
 
 	// return an error if none found
 	if (matched == 0)
@@ -1036,8 +1037,9 @@ void cli_frontend::verifysamples(const char *gamename)
 		}
 	}
 
-	// clear out any cached files
+	// clear out any cached files, and save any hashes we computed
 	zip_file_cache_clear();
+	g_hash_cache.flush();
 
 	// return an error if none found
 	if (matched == 0)
@@ -1353,8 +1355,9 @@ void cli_frontend::verifysoftware(const char *gamename)
 					}
 	}
 
-	// clear out any cached files
+	// clear out any cached files, and save any hashes we computed
 	zip_file_cache_clear();
+	g_hash_cache.flush();
 
 	// return an error if none found
 	if (matched == 0)
@@ -1475,8 +1478,9 @@ void cli_frontend::verifysoftlist(const char *gamename)
 				}
 	}
 
-	// clear out any cached files
+	// clear out any cached files, and save any hashes we computed
 	zip_file_cache_clear();
+	g_hash_cache.flush();
 
 	// return an error if none found
 	if (matched == 0)
@@ -28,10 +28,12 @@ CPUOBJS += $(CPUOBJ)/vtlb.o
 #-------------------------------------------------
 
 DRCOBJ = \
+	$(CPUOBJ)/drcasync.o \
 	$(CPUOBJ)/drcbec.o \
 	$(CPUOBJ)/drcbeut.o \
 	$(CPUOBJ)/drccache.o \
 	$(CPUOBJ)/drcfe.o \
+	$(CPUOBJ)/drcpcache.o \
 	$(CPUOBJ)/drcuml.o \
 	$(CPUOBJ)/uml.o \
 	$(CPUOBJ)/i386/i386dasm.o \
@@ -40,10 +42,12 @@ DRCOBJ = \
 	$(CPUOBJ)/drcbex64.o \
 
 DRCDEPS = \
+	$(CPUSRC)/drcasync.h \
 	$(CPUSRC)/drcbec.h \
 	$(CPUSRC)/drcbeut.h \
 	$(CPUSRC)/drccache.h \
 	$(CPUSRC)/drcfe.h \
+	$(CPUSRC)/drcpcache.h \
 	$(CPUSRC)/drcuml.h \
 	$(CPUSRC)/drcumlsh.h \
 	$(CPUSRC)/uml.h \
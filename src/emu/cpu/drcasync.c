@@ -0,0 +1,179 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    drcasync.c
+
+    Background compilation of code blocks for dynamic recompilers.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "drcasync.h"
+
+
+
+//**************************************************************************
+//  BACKGROUND COMPILER
+//**************************************************************************
+
+//-------------------------------------------------
+//  drc_async_compiler - constructor
+//-------------------------------------------------
+
+drc_async_compiler::drc_async_compiler(device_t &device, drcuml_state &drcuml, drc_describe_delegate describe, drc_generate_delegate generate)
+	: m_device(device),
+		m_drcuml(drcuml),
+		m_describe(describe),
+		m_generate(generate),
+		m_queue(osd_work_queue_alloc(0)),
+		m_in_background(false),
+		m_flush_needed(false),
+		m_queued(0),
+		m_duplicates(0),
+		m_synchronous(0),
+		m_wait_ticks(0)
+{
+	for (int reqnum = 0; reqnum < MAX_PENDING; reqnum++)
+	{
+		m_request[reqnum].m_owner = this;
+		m_request[reqnum].m_frontend = NULL;
+		m_request[reqnum].m_mode = 0;
+		m_request[reqnum].m_pc = 0;
+		m_request[reqnum].m_desclist = NULL;
+		m_request[reqnum].m_busy = 0;
+	}
+}
+
+
+//-------------------------------------------------
+//  ~drc_async_compiler - destructor
+//-------------------------------------------------
+
+drc_async_compiler::~drc_async_compiler()
+{
+	// this waits for anything still in flight
+	if (m_queue != NULL)
+		osd_work_queue_free(m_queue);
+
+	osd_printf_verbose("DRC background compiler '%s': %d blocks queued, %d duplicate requests, %d compiled synchronously, %d ms waiting\n",
+		m_device.tag(), m_queued, m_duplicates, m_synchronous, (int)(m_wait_ticks * 1000 / osd_ticks_per_second()));
+}
+
+
+//-------------------------------------------------
+//  request - queue a block for compilation;
+//  returns false if the caller must compile it
+//  itself, in which case all background work has
+//  already been finished
+//-------------------------------------------------
+
+bool drc_async_compiler::request(UINT8 mode, offs_t pc)
+{
+	// nothing more can be compiled until the cache is flushed
+	if (m_queue == NULL || m_flush_needed)
+	{
+		wait();
+		m_synchronous++;
+		return false;
+	}
+
+	// look for the same block already in flight, and a free slot
+	int freeslot = -1;
+	for (int reqnum = 0; reqnum < MAX_PENDING; reqnum++)
+	{
+		compile_request &req = m_request[reqnum];
+		if (req.m_busy == 0)
+		{
+			if (freeslot == -1)
+				freeslot = reqnum;
+		}
+		else if (req.m_mode == mode && req.m_pc == pc)
+		{
+			m_duplicates++;
+			return true;
+		}
+	}
+
+	// if we're out of slots, finish everything and let the caller handle it
+	if (freeslot == -1)
+	{
+		wait();
+		m_synchronous++;
+		return false;
+	}
+
+	// describe it here, where the memory and translation state can be used safely
+	compile_request &req = m_request[freeslot];
+	assert(req.m_frontend != NULL);
+	const opcode_desc *desclist = m_describe(*req.m_frontend, mode, pc);
+	if (desclist == NULL)
+	{
+		wait();
+		m_synchronous++;
+		return false;
+	}
+
+	// then hand it to the worker
+	req.m_mode = mode;
+	req.m_pc = pc;
+	req.m_desclist = desclist;
+	atomic_exchange32(&req.m_busy, 1);
+	osd_work_item_queue(m_queue, compile_callback, &req, WORK_ITEM_FLAG_AUTO_RELEASE);
+	m_queued++;
+	return true;
+}
+
+
+//-------------------------------------------------
+//  wait - wait for all background compiles to
+//  finish
+//-------------------------------------------------
+
+void drc_async_compiler::wait()
+{
+	if (m_queue == NULL)
+		return;
+
+	osd_ticks_t start = osd_ticks();
+	while (!osd_work_queue_wait(m_queue, osd_ticks_per_second()))
+		;
+	m_wait_ticks += osd_ticks() - start;
+}
+
+
+//-------------------------------------------------
+//  reset - wait for all background compiles to
+//  finish and clear any pending flush request;
+//  called just before the cache is flushed
+//-------------------------------------------------
+
+void drc_async_compiler::reset()
+{
+	wait();
+	m_flush_needed = false;
+}
+
+
+//-------------------------------------------------
+//  compile_callback - generate code for a single
+//  described block on the worker thread
+//-------------------------------------------------
+
+void *drc_async_compiler::compile_callback(void *param, int threadid)
+{
+	compile_request &req = *reinterpret_cast<compile_request *>(param);
+	drc_async_compiler &owner = *req.m_owner;
+
+	// skip it if the cache is full, or if the block was picked up along the way
+	if (!owner.m_flush_needed && !owner.m_drcuml.hash_exists(req.m_mode, req.m_pc))
+	{
+		owner.m_in_background = true;
+		owner.m_generate(req.m_mode, req.m_pc, req.m_desclist);
+		owner.m_in_background = false;
+	}
+
+	// free up the slot
+	atomic_exchange32(&req.m_busy, 0);
+	return NULL;
+}
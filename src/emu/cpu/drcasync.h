@@ -0,0 +1,129 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    drcasync.h
+
+    Background compilation of code blocks for dynamic recompilers.
+
+****************************************************************************
+
+    Concepts:
+
+    Normally, when the recompiled code runs into a PC with no code, the
+    CPU core compiles the block right there on the emulation thread,
+    stalling everything else until it is done. When background
+    compilation is enabled, the core instead queues the block here and
+    runs its interpreter until the compiled code shows up in the hash
+    table.
+
+    Each block is compiled in two stages. Describing it fetches opcodes
+    through the CPU's direct access and translation state, which the
+    interpreter is changing at the same time, so that stage runs on the
+    emulation thread when the block is queued. Every queue slot has its
+    own frontend, so its description stays intact until the slot is
+    reused. Only the UML generation and the backend run on the worker,
+    and they must not touch memory or translation state: anything they
+    need from there is looked up while describing.
+
+    All generation happens one block at a time on a single worker
+    thread, so the UML block and backend only ever see one compile at a
+    time, exactly as before. The emulation thread never compiles or
+    flushes while a background compile is in flight: anything that
+    needs to do that must call reset() or wait() first.
+
+    A background compile must not flush the cache itself, since the
+    emulation thread may be running code in it. If it runs out of space
+    it calls cache_full() and returns; the core then flushes the cache
+    from the emulation thread the next time through its execute loop.
+
+    The hash table only publishes new entries once a block has been
+    completely generated, so the emulation thread can never jump into a
+    half-written block.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __DRCASYNC_H__
+#define __DRCASYNC_H__
+
+#include "drcuml.h"
+#include "drcfe.h"
+
+
+//**************************************************************************
+//  TYPE DEFINITIONS
+//**************************************************************************
+
+// callback used to describe a block on the emulation thread
+typedef delegate<const opcode_desc *(drc_frontend &, UINT8, offs_t)> drc_describe_delegate;
+
+// callback used to generate code for a described block
+typedef delegate<void (UINT8, offs_t, const opcode_desc *)> drc_generate_delegate;
+
+
+// drc_async_compiler
+class drc_async_compiler
+{
+public:
+	// maximum number of compiles in flight
+	static const int MAX_PENDING = 16;
+
+	// construction/destruction
+	drc_async_compiler(device_t &device, drcuml_state &drcuml, drc_describe_delegate describe, drc_generate_delegate generate);
+	~drc_async_compiler();
+
+	// configuration; every slot needs its own frontend
+	void set_frontend(int slot, drc_frontend &frontend) { m_request[slot].m_frontend = &frontend; }
+
+	// getters
+	bool in_background() const { return m_in_background; }
+	bool flush_needed() const { return m_flush_needed; }
+
+	// queue a block; returns false if the caller must compile it itself
+	bool request(UINT8 mode, offs_t pc);
+
+	// called by a background compile that ran out of cache space
+	void cache_full() { m_flush_needed = true; }
+
+	// wait for all background compiles to finish
+	void wait();
+
+	// wait, then forget any pending flush request
+	void reset();
+
+private:
+	// a single queued compile
+	struct compile_request
+	{
+		drc_async_compiler *m_owner;            // pointer back to the compiler
+		drc_frontend *      m_frontend;         // frontend that describes blocks for this slot
+		UINT8               m_mode;             // mode to compile
+		offs_t              m_pc;               // PC to compile
+		const opcode_desc * m_desclist;         // description of the block, owned by the frontend
+		volatile INT32      m_busy;             // non-zero until the compile is done
+	};
+
+	// internal helpers
+	static void *compile_callback(void *param, int threadid);
+
+	// internal state
+	device_t &              m_device;           // CPU device we are associated with
+	drcuml_state &          m_drcuml;           // UML state owning the cache
+	drc_describe_delegate   m_describe;         // callback to describe a block
+	drc_generate_delegate   m_generate;         // callback to generate code for a block
+	osd_work_queue *        m_queue;            // queue feeding the worker thread
+	compile_request         m_request[MAX_PENDING]; // slots for compiles in flight
+	volatile bool           m_in_background;    // true while the worker is compiling
+	volatile bool           m_flush_needed;     // true if a background compile ran out of space
+
+	// statistics
+	UINT32                  m_queued;           // blocks handed to the worker
+	UINT32                  m_duplicates;       // requests for blocks already queued
+	UINT32                  m_synchronous;      // requests bounced back to the caller
+	osd_ticks_t             m_wait_ticks;       // time the emulation thread spent waiting
+};
+
+
+#endif /* __DRCASYNC_H__ */
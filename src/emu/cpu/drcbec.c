@@ -455,10 +455,11 @@ void drcbe_c::generate(drcuml_block &block, const instruction *instlist, UINT32
 	*cachetop = (drccodeptr)dst;
 	m_cache.end_codegen();
 
-	// tell all of our utility objects that the block is finished
-	m_hash.block_end(block);
+	// tell all of our utility objects that the block is finished;
+	// the hash table goes last, since that makes the code reachable
 	m_labels.block_end(block);
 	m_map.block_end(block);
+	m_hash.block_end(block);
 }
 
 
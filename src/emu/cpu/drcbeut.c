@@ -22,6 +22,25 @@ using namespace uml;
 
 
 
+//**************************************************************************
+//  INLINE FUNCTIONS
+//**************************************************************************
+
+//-------------------------------------------------
+//  publish - store a pointer that running code
+//  may read at any time, making sure everything
+//  written before it is visible first
+//-------------------------------------------------
+
+template<typename _PtrType>
+inline void publish(_PtrType &slot, _PtrType value)
+{
+	void * volatile *target = reinterpret_cast<void * volatile *>(&slot);
+	compare_exchange_ptr(target, *target, (void *)value);
+}
+
+
+
 //**************************************************************************
 //  DRC HASH TABLE
 //**************************************************************************
@@ -41,42 +60,52 @@ drc_hash_table::drc_hash_table(drc_cache &cache, UINT32 modes, UINT8 addrbits, U
 		m_l1mask((1 << m_l1bits) - 1),
 		m_l2mask((1 << m_l2bits) - 1),
 		m_base(reinterpret_cast<drccodeptr ***>(cache.alloc(modes * sizeof(**m_base)))),
-		m_emptyl1(NULL),
-		m_emptyl2(NULL)
+		m_emptyl1(reinterpret_cast<drccodeptr **>(cache.alloc(sizeof(drccodeptr *) << m_l1bits))),
+		m_emptyl2(reinterpret_cast<drccodeptr *>(cache.alloc(sizeof(drccodeptr) << m_l2bits))),
+		m_freel1(NULL),
+		m_freel2(NULL),
+		m_deferring(false)
 {
+	// the empty tables are shared by all modes, so we never need to reallocate them
+	for (int modenum = 0; modenum < m_modes; modenum++)
+		m_base[modenum] = m_emptyl1;
 	reset();
+
+	// drop references to code as it is evicted from the cache
+	cache.set_eviction_callback(drc_evict_delegate(FUNC(drc_hash_table::evict_range), this));
 }
 
 
 //-------------------------------------------------
-//  reset - flush existing hash tables and create
-//  new ones
+//  reset - flush existing hash tables, recycling
+//  their memory for future use
 //-------------------------------------------------
 
 bool drc_hash_table::reset()
 {
-	// allocate an empty l2 hash table
-	m_emptyl2 = (drccodeptr *)m_cache.alloc_temporary(sizeof(drccodeptr) << m_l2bits);
-	if (m_emptyl2 == NULL)
-		return false;
+	// the tables live in permanent memory so that they survive eviction;
+	// hand any populated ones back to the free lists
+	for (int modenum = 0; modenum < m_modes; modenum++)
+		if (m_base[modenum] != m_emptyl1)
+		{
+			for (int l1entry = 0; l1entry < (1 << m_l1bits); l1entry++)
+				if (m_base[modenum][l1entry] != m_emptyl2)
+					free_table_to(m_freel2, m_base[modenum][l1entry]);
+			free_table_to(m_freel1, m_base[modenum]);
+			m_base[modenum] = m_emptyl1;
+		}
 
-	// populate it with pointers to the recompile_exit code
+	// populate the empty l2 table with pointers to the recompile_exit code
 	for (int entry = 0; entry < (1 << m_l2bits); entry++)
 		m_emptyl2[entry] = m_nocodeptr;
 
-	// allocate an empty l1 hash table
-	m_emptyl1 = (drccodeptr **)m_cache.alloc_temporary(sizeof(drccodeptr *) << m_l1bits);
-	if (m_emptyl1 == NULL)
-		return false;
-
-	// populate it with pointers to the empty l2 table
+	// populate the empty l1 table with pointers to the empty l2 table
 	for (int entry = 0; entry < (1 << m_l1bits); entry++)
 		m_emptyl1[entry] = m_emptyl2;
 
-	// reset the hash tables
-	for (int modenum = 0; modenum < m_modes; modenum++)
-		m_base[modenum] = m_emptyl1;
-
+	// forget any block that was abandoned partway through
+	m_pending.reset();
+	m_deferring = false;
 	return true;
 }
 
@@ -87,18 +116,22 @@ bool drc_hash_table::reset()
 
 void drc_hash_table::block_begin(drcuml_block &block, const uml::instruction *instlist, UINT32 numinst)
 {
-	// before generating code, pre-allocate any hash entries; we do this by setting dummy hash values
+	// before generating code, pre-allocate any hash entries; we do this by rewriting the
+	// current values, since the new ones aren't published until the block is complete
+	m_pending.reset();
+	m_deferring = false;
 	for (int inum = 0; inum < numinst; inum++)
 	{
 		const uml::instruction &inst = instlist[inum];
 
-		// if the opcode is a hash, verify that it makes sense and then set a NULL entry
+		// if the opcode is a hash, verify that it makes sense and then make sure the entry exists
 		if (inst.opcode() == OP_HASH)
 		{
 			assert(inst.numparams() == 2);
 
 			// if we fail to allocate, we must abort the block
-			if (!set_codeptr(inst.param(0).immediate(), inst.param(1).immediate(), NULL))
+			drccodeptr code = get_codeptr(inst.param(0).immediate(), inst.param(1).immediate());
+			if (!set_codeptr(inst.param(0).immediate(), inst.param(1).immediate(), code))
 				block.abort();
 		}
 
@@ -111,6 +144,9 @@ void drc_hash_table::block_begin(drcuml_block &block, const uml::instruction *in
 				block.abort();
 		}
 	}
+
+	// hold on to new entries until the block is complete
+	m_deferring = true;
 }
 
 
@@ -120,7 +156,14 @@ void drc_hash_table::block_begin(drcuml_block &block, const uml::instruction *in
 
 void drc_hash_table::block_end(drcuml_block &block)
 {
-	// nothing to do here, yet
+	// the code is complete; make it reachable
+	m_deferring = false;
+	for (int entnum = 0; entnum < m_pending.count(); entnum++)
+	{
+		const pending_entry &entry = m_pending[entnum];
+		publish(m_base[entry.mode][(entry.pc >> m_l1shift) & m_l1mask][(entry.pc >> m_l2shift) & m_l2mask], entry.code);
+	}
+	m_pending.reset();
 }
 
 
@@ -159,35 +202,99 @@ void drc_hash_table::set_default_codeptr(drccodeptr nocodeptr)
 
 bool drc_hash_table::set_codeptr(UINT32 mode, UINT32 pc, drccodeptr code)
 {
-	// copy-on-write for the l1 hash table
+	// while generating a block, just remember the entry; block_begin() has already allocated it
 	assert(mode < m_modes);
+	if (m_deferring)
+	{
+		assert(m_base[mode] != m_emptyl1 && m_base[mode][(pc >> m_l1shift) & m_l1mask] != m_emptyl2);
+		pending_entry &entry = m_pending.append();
+		entry.mode = mode;
+		entry.pc = pc;
+		entry.code = code;
+		return true;
+	}
+
+	// copy-on-write for the l1 hash table
 	if (m_base[mode] == m_emptyl1)
 	{
-		drccodeptr **newtable = (drccodeptr **)m_cache.alloc_temporary(sizeof(drccodeptr *) << m_l1bits);
+		drccodeptr **newtable = (drccodeptr **)alloc_table(m_freel1, sizeof(drccodeptr *) << m_l1bits);
 		if (newtable == NULL)
 			return false;
 		memcpy(newtable, m_emptyl1, sizeof(drccodeptr *) << m_l1bits);
-		m_base[mode] = newtable;
+		publish(m_base[mode], newtable);
 	}
 
 	// copy-on-write for the l2 hash table
 	UINT32 l1 = (pc >> m_l1shift) & m_l1mask;
 	if (m_base[mode][l1] == m_emptyl2)
 	{
-		drccodeptr *newtable = (drccodeptr *)m_cache.alloc_temporary(sizeof(drccodeptr) << m_l2bits);
+		drccodeptr *newtable = (drccodeptr *)alloc_table(m_freel2, sizeof(drccodeptr) << m_l2bits);
 		if (newtable == NULL)
 			return false;
 		memcpy(newtable, m_emptyl2, sizeof(drccodeptr) << m_l2bits);
-		m_base[mode][l1] = newtable;
+		publish(m_base[mode][l1], newtable);
 	}
 
 	// set the new entry
 	UINT32 l2 = (pc >> m_l2shift) & m_l2mask;
-	m_base[mode][l1][l2] = code;
+	publish(m_base[mode][l1][l2], code);
 	return true;
 }
 
 
+//-------------------------------------------------
+//  evict_range - point all entries that refer to
+//  code in the given range back to the default
+//  codeptr
+//-------------------------------------------------
+
+void drc_hash_table::evict_range(drccodeptr start, drccodeptr end)
+{
+	// the tables themselves stay put, since generated code refers to them directly
+	for (int modenum = 0; modenum < m_modes; modenum++)
+		if (m_base[modenum] != m_emptyl1)
+			for (int l1entry = 0; l1entry < (1 << m_l1bits); l1entry++)
+				if (m_base[modenum][l1entry] != m_emptyl2)
+				{
+					drccodeptr *l2table = m_base[modenum][l1entry];
+					for (int l2entry = 0; l2entry < (1 << m_l2bits); l2entry++)
+						if (l2table[l2entry] >= start && l2table[l2entry] < end)
+							l2table[l2entry] = m_nocodeptr;
+				}
+}
+
+
+//-------------------------------------------------
+//  alloc_table - allocate a hash table, either
+//  from the free list or from permanent cache
+//  memory
+//-------------------------------------------------
+
+void *drc_hash_table::alloc_table(free_table *&freelist, size_t bytes)
+{
+	free_table *table = freelist;
+	if (table != NULL)
+	{
+		freelist = table->m_next;
+		return table;
+	}
+	return m_cache.alloc(bytes);
+}
+
+
+//-------------------------------------------------
+//  free_table_to - return a hash table to the
+//  given free list
+//-------------------------------------------------
+
+void drc_hash_table::free_table_to(free_table *&freelist, void *table)
+{
+	free_table *entry = reinterpret_cast<free_table *>(table);
+	entry->m_next = freelist;
+	freelist = entry;
+}
+
+
 
 //**************************************************************************
 //  DRC MAP VARIABLES
@@ -243,8 +350,9 @@ void drc_map_variables::block_end(drcuml_block &block)
 	if (m_entry_list.first() == NULL)
 		return;
 
-	// begin "code generation" aligned to an 8-byte boundary
-	drccodeptr *top = m_cache.begin_codegen(sizeof(UINT64) + sizeof(UINT32) + 2 * sizeof(UINT32) * m_entry_list.count());
+	// begin "code generation" aligned to an 8-byte boundary; the table must
+	// directly follow the code, so don't evict anything to make room for it
+	drccodeptr *top = m_cache.begin_codegen(sizeof(UINT64) + sizeof(UINT32) + 2 * sizeof(UINT32) * m_entry_list.count(), false);
 	if (top == NULL)
 		block.abort();
 	UINT32 *dest = (UINT32 *)(((FPTR)*top + 7) & ~7);
@@ -356,7 +464,7 @@ UINT32 drc_map_variables::get_value(drccodeptr codebase, UINT32 mapvar) const
 
 	// get an aligned pointer to start scanning
 	UINT64 *curscan = (UINT64 *)(((FPTR)codebase | 7) + 1);
-	UINT64 *endscan = (UINT64 *)m_cache.top();
+	UINT64 *endscan = (UINT64 *)m_cache.code_end(codebase);
 
 	// look for the signature
 	while (curscan < endscan && *curscan++ != m_uniquevalue) ;
@@ -52,7 +52,28 @@ public:
 	drccodeptr get_codeptr(UINT32 mode, UINT32 pc) { assert(mode < m_modes); return m_base[mode][(pc >> m_l1shift) & m_l1mask][(pc >> m_l2shift) & m_l2mask]; }
 	bool code_exists(UINT32 mode, UINT32 pc) { return get_codeptr(mode, pc) != m_nocodeptr; }
 
+	// eviction
+	void evict_range(drccodeptr start, drccodeptr end);
+
 private:
+	// a recycled table, linked through its first entry
+	struct free_table
+	{
+		free_table *        m_next;         // pointer to the next free table
+	};
+
+	// an entry waiting for its block to be completed
+	struct pending_entry
+	{
+		UINT32          mode;               // mode of the entry
+		UINT32          pc;                 // PC of the entry
+		drccodeptr      code;               // code it will point to
+	};
+
+	// internal helpers
+	void *alloc_table(free_table *&freelist, size_t bytes);
+	void free_table_to(free_table *&freelist, void *table);
+
 	// internal state
 	drc_cache &     m_cache;                // cache where allocations come from
 	UINT32          m_modes;                // number of modes supported
@@ -69,6 +90,16 @@ private:
 	drccodeptr ***  m_base;                 // pointer to the l1 table for each mode
 	drccodeptr **   m_emptyl1;              // pointer to empty l1 hash table
 	drccodeptr *    m_emptyl2;              // pointer to empty l2 hash table
+
+	free_table *    m_freel1;               // recycled l1 hash tables
+	free_table *    m_freel2;               // recycled l2 hash tables
+
+	// only the hash table needs to defer its entries: the emulation thread reads it while a
+	// block is generated in the background; drc_label_list and drc_map_variables are only
+	// touched by the generating thread, and a block's map table is only read by code that
+	// the hash table has already published
+	bool            m_deferring;            // true while a block is being generated
+	dynamic_array<pending_entry> m_pending; // entries to publish at the end of the block
 };
 
 
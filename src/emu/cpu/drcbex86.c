@@ -806,10 +806,11 @@ void drcbe_x86::generate(drcuml_block &block, const instruction *instlist, UINT3
 	if (m_log != NULL)
 		x86log_disasm_code_range(m_log, (blockname == NULL) ? "Unknown block" : blockname, base, m_cache.top());
 
-	// tell all of our utility objects that the block is finished
-	m_hash.block_end(block);
+	// tell all of our utility objects that the block is finished;
+	// the hash table goes last, since that makes the code reachable
 	m_labels.block_end(block);
 	m_map.block_end(block);
+	m_hash.block_end(block);
 }
 
 
@@ -38,10 +38,21 @@ drc_cache::drc_cache(size_t bytes)
 		m_top(m_base),
 		m_end(m_near + bytes),
 		m_codegen(0),
-		m_size(bytes)
+		m_size(bytes),
+		m_regions(0),
+		m_curregion(0),
+		m_evict_disabled(false),
+		m_static_top(NULL),
+		m_highwater(m_base),
+		m_region_size(0),
+		m_flushes(0),
+		m_evictions(0),
+		m_bytes_reclaimed(0),
+		m_bytes_generated(0)
 {
 	memset(m_free, 0, sizeof(m_free));
 	memset(m_nearfree, 0, sizeof(m_nearfree));
+	memset(m_region_top, 0, sizeof(m_region_top));
 }
 
 
@@ -68,6 +79,68 @@ void drc_cache::flush()
 
 	// just reset the top back to the base and re-seed
 	m_top = m_base;
+	m_highwater = m_base;
+	m_flushes++;
+
+	// the static code needs to be regenerated, so nothing is evictable
+	m_static_top = NULL;
+	m_curregion = 0;
+	m_evict_disabled = false;
+	g_profiler.count(PROFILER_DRC_FLUSH);
+}
+
+
+//-------------------------------------------------
+//  set_eviction_regions - split the dynamic part
+//  of the cache into regions that are retired
+//  oldest first when the cache fills, instead of
+//  flushing everything
+//-------------------------------------------------
+
+void drc_cache::set_eviction_regions(int regions)
+{
+	assert(m_static_top == NULL);
+	m_regions = MIN(regions, MAX_REGIONS);
+}
+
+
+//-------------------------------------------------
+//  end_static_code - note that everything
+//  generated so far is static code that must
+//  survive until the next flush
+//-------------------------------------------------
+
+void drc_cache::end_static_code()
+{
+	assert(m_codegen == NULL);
+	if (m_regions <= 1)
+		return;
+
+	// divide up what remains between the regions
+	m_static_top = (drccodeptr)ALIGN_PTR_UP(m_top);
+	m_region_size = ((m_end - m_static_top) / m_regions) & ~(CACHE_ALIGNMENT - 1);
+	for (int region = 0; region < m_regions; region++)
+		m_region_top[region] = region_start(region);
+	m_curregion = 0;
+	m_top = m_static_top;
+}
+
+
+//-------------------------------------------------
+//  code_end - return the end of the live code
+//  that contains the given pointer
+//-------------------------------------------------
+
+drccodeptr drc_cache::code_end(const void *ptr) const
+{
+	// the current region ends at the top; older regions at their saved top
+	if (evicting() && (drccodeptr)ptr >= m_static_top)
+	{
+		int region = ((drccodeptr)ptr - m_static_top) / m_region_size;
+		if (region != m_curregion && region < m_regions)
+			return m_region_top[region];
+	}
+	return m_top;
 }
 
 
@@ -94,7 +167,7 @@ void *drc_cache::alloc(size_t bytes)
 
 	// if no space, we just fail
 	drccodeptr ptr = (drccodeptr)ALIGN_PTR_DOWN(m_end - bytes);
-	if (m_top > ptr)
+	if (MAX(m_top, m_highwater) > ptr)
 		return NULL;
 
 	// otherwise update the end of the cache
@@ -145,13 +218,14 @@ void *drc_cache::alloc_temporary(size_t bytes)
 	// can't allocate in the middle of codegen
 	assert(m_codegen == NULL);
 
-	// if no space, we just fail
-	drccodeptr ptr = m_top;
-	if (ptr + bytes >= m_end)
+	// if no space, try to evict before failing
+	if (m_top + bytes >= limit() && !make_room(bytes))
 		return NULL;
 
 	// otherwise, update the cache top
+	drccodeptr ptr = m_top;
 	m_top = (drccodeptr)ALIGN_PTR_UP(ptr + bytes);
+	m_highwater = MAX(m_highwater, m_top);
 	return ptr;
 }
 
@@ -184,15 +258,14 @@ void drc_cache::dealloc(void *memory, size_t bytes)
 //  begin_codegen - begin code generation
 //-------------------------------------------------
 
-drccodeptr *drc_cache::begin_codegen(UINT32 reserve_bytes)
+drccodeptr *drc_cache::begin_codegen(UINT32 reserve_bytes, bool can_evict)
 {
 	// can't restart in the middle of codegen
 	assert(m_codegen == NULL);
 	assert(m_ooblist.first() == NULL);
 
-	// if still no space, we just fail
-	drccodeptr ptr = m_top;
-	if (ptr + reserve_bytes >= m_end)
+	// if no space, try to evict; if still no space, we just fail
+	if (m_top + reserve_bytes >= limit() && (!can_evict || !make_room(reserve_bytes)))
 		return NULL;
 
 	// otherwise, return a pointer to the cache top
@@ -223,6 +296,8 @@ drccodeptr drc_cache::end_codegen()
 
 	// update the cache top
 	m_top = (drccodeptr)ALIGN_PTR_UP(m_top);
+	m_highwater = MAX(m_highwater, m_top);
+	m_bytes_generated += m_top - m_codegen;
 	m_codegen = NULL;
 
 	return result;
@@ -250,3 +325,45 @@ void drc_cache::request_oob_codegen(drc_oob_delegate callback, void *param1, voi
 	// add to the tail
 	m_ooblist.append(*oob);
 }
+
+
+//-------------------------------------------------
+//  make_room - retire the oldest region of
+//  dynamic code to make room for a new
+//  allocation; returns false if that's not
+//  possible and the cache must be flushed; this
+//  is plain FIFO, so code that is still in use
+//  is retired along with everything else there
+//  and recompiled when it is next reached
+//-------------------------------------------------
+
+bool drc_cache::make_room(size_t bytes)
+{
+	// only possible once the static code is in place
+	if (!evicting() || m_evict_disabled || m_evict_callback.isnull() || bytes >= m_region_size)
+		return false;
+
+	g_profiler.start(PROFILER_DRC_FLUSH);
+
+	// close out the current region and advance to the oldest one
+	m_region_top[m_curregion] = m_top;
+	m_curregion = (m_curregion + 1) % m_regions;
+	drccodeptr start = region_start(m_curregion);
+	drccodeptr end = m_region_top[m_curregion];
+
+	// have everyone drop their references to the code there
+	if (end > start)
+	{
+		m_evict_callback(start, end);
+		m_evictions++;
+		m_bytes_reclaimed += end - start;
+		g_profiler.count(PROFILER_DRC_RECLAIM, end - start);
+	}
+	m_region_top[m_curregion] = start;
+	m_top = start;
+
+	g_profiler.stop();
+
+	// the last region may have been trimmed by permanent allocations
+	return (m_top + bytes < limit());
+}
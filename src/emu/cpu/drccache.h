@@ -36,6 +36,9 @@ typedef UINT8 *drccodeptr;
 // helper template for oob codegen
 typedef delegate<void (drccodeptr *, void *, void *)> drc_oob_delegate;
 
+// callback to release all references to a range of code being evicted
+typedef delegate<void (drccodeptr, drccodeptr)> drc_evict_delegate;
+
 
 // drc_cache
 class drc_cache
@@ -49,6 +52,16 @@ public:
 	drccodeptr near() const { return m_near; }
 	drccodeptr base() const { return m_base; }
 	drccodeptr top() const { return m_top; }
+	size_t size() const { return m_size; }
+	size_t bytes_free() const { return limit() - m_top; }
+	drccodeptr code_end(const void *ptr) const;
+	bool static_code_complete() const { return (m_static_top != NULL); }
+
+	// statistics
+	UINT32 flushes() const { return m_flushes; }
+	UINT32 evictions() const { return m_evictions; }
+	UINT64 bytes_reclaimed() const { return m_bytes_reclaimed; }
+	UINT64 bytes_generated() const { return m_bytes_generated; }
 
 	// pointer checking
 	bool contains_pointer(const void *ptr) const { return ((const drccodeptr)ptr >= m_near && (const drccodeptr)ptr < m_near + m_size); }
@@ -57,17 +70,27 @@ public:
 
 	// memory management
 	void flush();
+	void set_eviction_regions(int regions);
+	void set_eviction_callback(drc_evict_delegate callback) { m_evict_callback = callback; }
+	void end_static_code();
+	void disable_eviction() { m_evict_disabled = true; }
 	void *alloc(size_t bytes);
 	void *alloc_near(size_t bytes);
 	void *alloc_temporary(size_t bytes);
 	void dealloc(void *memory, size_t bytes);
 
 	// codegen helpers
-	drccodeptr *begin_codegen(UINT32 reserve_bytes);
+	drccodeptr *begin_codegen(UINT32 reserve_bytes, bool can_evict = true);
 	drccodeptr end_codegen();
 	void request_oob_codegen(drc_oob_delegate callback, void *param1 = NULL, void *param2 = NULL);
 
 private:
+	// internal helpers
+	bool evicting() const { return (m_regions > 1 && m_static_top != NULL); }
+	drccodeptr region_start(int region) const { return m_static_top + region * m_region_size; }
+	drccodeptr limit() const { return evicting() ? MIN(region_start(m_curregion + 1), m_end) : m_end; }
+	bool make_room(size_t bytes);
+
 	// largest block of code that can be generated at once
 	static const size_t CODEGEN_MAX_BYTES = 65536;
 
@@ -80,6 +103,9 @@ private:
 	// size of "near" area at the base of the cache
 	static const size_t NEAR_CACHE_SIZE = 65536;
 
+	// maximum number of eviction regions
+	static const int MAX_REGIONS = 16;
+
 	// core parameters
 	drccodeptr          m_near;             // pointer to the near part of the cache
 	drccodeptr          m_neartop;          // top of the near part of the cache
@@ -89,6 +115,22 @@ private:
 	drccodeptr          m_codegen;          // start of generated code
 	size_t              m_size;             // size of the cache in bytes
 
+	// region-based eviction
+	int                 m_regions;          // number of regions, or 0 to flush everything
+	int                 m_curregion;        // region currently being filled
+	bool                m_evict_disabled;   // true if static code showed up after dynamic code
+	drccodeptr          m_static_top;       // top of the static code that is never evicted
+	drccodeptr          m_highwater;        // highest live code pointer
+	size_t              m_region_size;      // size of each region
+	drccodeptr          m_region_top[MAX_REGIONS]; // top of the code in each region
+	drc_evict_delegate  m_evict_callback;   // callback to release references to evicted code
+
+	// statistics
+	UINT32              m_flushes;          // number of full flushes
+	UINT32              m_evictions;        // number of regions evicted
+	UINT64              m_bytes_reclaimed;  // total bytes reclaimed by eviction
+	UINT64              m_bytes_generated;  // total bytes of code generated, including out-of-band code
+
 	// oob management
 	struct oob_handler
 	{
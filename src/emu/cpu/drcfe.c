@@ -167,6 +167,7 @@ opcode_desc *drc_frontend::describe_one(offs_t curpc, const opcode_desc *prevdes
 	desc->physpc = curpc;
 	desc->targetpc = BRANCH_TARGET_DYNAMIC;
 	memset(&desc->opptr, 0x00, sizeof(desc->opptr));
+	desc->opbase = NULL;
 	desc->length = 0;
 	desc->delayslots = 0;
 	desc->skipslots = 0;
@@ -177,7 +178,12 @@ opcode_desc *drc_frontend::describe_one(offs_t curpc, const opcode_desc *prevdes
 	memset(desc->regreq, 0x00, sizeof(desc->regreq));
 
 	// call the callback to describe an instruction
-	if (!describe(*desc, prevdesc))
+	bool valid = describe(*desc, prevdesc);
+
+	// note code that may be modified, so that the generated code can validate it
+	if (m_program.get_write_ptr(desc->physpc) != NULL)
+		desc->flags |= OPFLAG_WRITEABLE_CODE;
+	if (!valid)
 	{
 		desc->flags |= OPFLAG_WILL_CAUSE_EXCEPTION | OPFLAG_INVALID_OPCODE;
 		return desc;
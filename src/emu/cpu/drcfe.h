@@ -67,6 +67,7 @@ const UINT32 OPFLAG_COMPILER_UNMAPPED       = 0x00002000;       // compiler hit
 // opcode flags
 const UINT32 OPFLAG_INVALID_OPCODE          = 0x00004000;       // instruction is invalid
 const UINT32 OPFLAG_VIRTUAL_NOOP            = 0x00008000;       // instruction is a virtual no-op
+const UINT32 OPFLAG_WRITEABLE_CODE          = 0x00400000;       // instruction lives in memory that can be written
 
 // opcode sequence flow flags
 const UINT32 OPFLAG_REDISPATCH              = 0x00010000;       // instruction must redispatch after completion
@@ -107,6 +108,7 @@ struct opcode_desc
 		UINT32      l[4];
 		UINT64      q[2];
 	} opptr;                                // pointer to opcode memory
+	void *          opbase;                 // pointer to the opcode in decrypted memory, or NULL
 
 	// information about this instruction's execution
 	UINT8           length;                 // length in bytes of this opcode
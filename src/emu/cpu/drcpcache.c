@@ -0,0 +1,329 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    drcpcache.c
+
+    Persistent on-disk index of recompiled code blocks.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "drcpcache.h"
+
+
+
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+// file signature
+static const char drcpcache_magic[8] = { 'M','A','M','E','D','R','C', 0 };
+
+// stop precompiling once the cache is down to this fraction of its size
+const int PRECOMPILE_RESERVE_SHIFT = 2;
+
+// maximum number of times to retry deferred blocks after each precompile
+const int PRECOMPILE_MAX_RETRIES = 4;
+
+
+
+//**************************************************************************
+//  PERSISTENT CACHE
+//**************************************************************************
+
+//-------------------------------------------------
+//  drc_persistent_cache - constructor
+//-------------------------------------------------
+
+drc_persistent_cache::drc_persistent_cache(device_t &device, drcuml_state &drcuml)
+	: m_device(device),
+		m_drcuml(drcuml),
+		m_dirty(false),
+		m_precompiling(false),
+		m_retry_pending(false),
+		m_retries(0),
+		m_expected(-1),
+		m_starttime(0),
+		m_hits(0),
+		m_misses(0),
+		m_stale(0),
+		m_precompile_ticks(0),
+		m_demand_ticks(0)
+{
+	for (int bucket = 0; bucket < HASH_BUCKETS; bucket++)
+		m_bucket[bucket] = -1;
+
+	// the file lives in a per-system subdirectory, named after the CPU tag
+	astring tag(device.tag());
+	tag.del(0, 1).replacechr(':', '_');
+	m_filename.cpy(device.machine().basename()).cat('\\').cat(tag).cat(".drc");
+
+	// read in whatever we learned last time
+	load();
+}
+
+
+//-------------------------------------------------
+//  ~drc_persistent_cache - destructor
+//-------------------------------------------------
+
+drc_persistent_cache::~drc_persistent_cache()
+{
+	// write out the updated list
+	if (m_dirty)
+		save();
+
+	// report the statistics
+	osd_ticks_t tps = osd_ticks_per_second();
+	osd_printf_verbose("DRC cache '%s': %d hits (%d ms at startup), %d misses (%d ms on demand), %d stale\n",
+		m_device.tag(), m_hits, (int)(m_precompile_ticks * 1000 / tps), m_misses, (int)(m_demand_ticks * 1000 / tps), m_stale);
+}
+
+
+//-------------------------------------------------
+//  precompile - compile every block in the
+//  persistent list that is not already present
+//  in the cache; called just after a flush
+//-------------------------------------------------
+
+void drc_persistent_cache::precompile(drc_precompile_delegate compile)
+{
+	m_retries = 0;
+	compile_entries(compile, false);
+}
+
+
+//-------------------------------------------------
+//  retry - compile the deferred blocks whose
+//  code has been loaded since; the caller must
+//  make sure no other compile is in flight
+//-------------------------------------------------
+
+void drc_persistent_cache::retry(drc_precompile_delegate compile)
+{
+	m_retries++;
+	compile_entries(compile, true);
+}
+
+
+//-------------------------------------------------
+//  block_described - note that a block has been
+//  described; returns false if precompiling and
+//  the code no longer matches what was recorded
+//-------------------------------------------------
+
+bool drc_persistent_cache::block_described(UINT8 mode, offs_t pc, const opcode_desc *desclist)
+{
+	UINT32 hash = hash_opcodes(desclist);
+
+	// when precompiling, reject code that has changed since the last run
+	if (m_precompiling && m_expected >= 0)
+	{
+		block_entry &entry = m_entry[m_expected];
+		if (entry.hash != hash)
+		{
+			// count it once, and keep it around in case the code shows up later
+			if (!entry.deferred)
+				m_stale++;
+			entry.deferred = true;
+			return false;
+		}
+		entry.deferred = false;
+	}
+
+	// otherwise, record it for next time
+	else
+	{
+		int index = find_entry(mode, pc);
+		if (index < 0)
+		{
+			add_entry(mode, pc, hash);
+			m_dirty = true;
+		}
+		else
+		{
+			// a deferred block showing up with its recorded code means the rest may be loaded too
+			block_entry &entry = m_entry[index];
+			if (entry.deferred && entry.hash == hash && m_retries < PRECOMPILE_MAX_RETRIES)
+				m_retry_pending = true;
+			entry.deferred = false;
+			if (entry.hash != hash)
+			{
+				entry.hash = hash;
+				m_dirty = true;
+			}
+		}
+	}
+
+	m_starttime = osd_ticks();
+	return true;
+}
+
+
+//-------------------------------------------------
+//  block_compiled - account for a completed
+//  compile
+//-------------------------------------------------
+
+void drc_persistent_cache::block_compiled()
+{
+	osd_ticks_t elapsed = osd_ticks() - m_starttime;
+	if (m_precompiling)
+	{
+		m_hits++;
+		m_precompile_ticks += elapsed;
+	}
+	else
+	{
+		m_misses++;
+		m_demand_ticks += elapsed;
+	}
+}
+
+
+//-------------------------------------------------
+//  compile_entries - compile the entries in the
+//  persistent list that are not already present
+//  in the cache, optionally only the deferred
+//  ones
+//-------------------------------------------------
+
+void drc_persistent_cache::compile_entries(drc_precompile_delegate compile, bool deferred_only)
+{
+	drc_cache &cache = m_drcuml.cache();
+
+	m_retry_pending = false;
+	m_precompiling = true;
+	for (m_expected = 0; m_expected < m_entry.count(); m_expected++)
+	{
+		// leave room for the blocks we don't know about yet
+		if (cache.bytes_free() < (cache.size() >> PRECOMPILE_RESERVE_SHIFT))
+			break;
+
+		// skip anything that was picked up as part of an earlier block
+		const block_entry &entry = m_entry[m_expected];
+		if (deferred_only && !entry.deferred)
+			continue;
+		if (!m_drcuml.hash_exists(entry.mode, entry.pc))
+			compile(entry.mode, entry.pc);
+	}
+	m_expected = -1;
+	m_precompiling = false;
+}
+
+
+//-------------------------------------------------
+//  hash_opcodes - compute a hash over all the
+//  opcode bytes in a description list
+//-------------------------------------------------
+
+UINT32 drc_persistent_cache::hash_opcodes(const opcode_desc *desclist)
+{
+	crc32_creator crc;
+	for (const opcode_desc *desc = desclist; desc != NULL; desc = desc->next())
+	{
+		crc.append(desc->opptr.b, MIN(desc->length, sizeof(desc->opptr)));
+		for (const opcode_desc *delay = desc->delay.first(); delay != NULL; delay = delay->next())
+			crc.append(delay->opptr.b, MIN(delay->length, sizeof(delay->opptr)));
+	}
+	return crc.finish();
+}
+
+
+//-------------------------------------------------
+//  find_entry - find the index of the entry for
+//  a mode/pc pair, or -1 if not present
+//-------------------------------------------------
+
+int drc_persistent_cache::find_entry(UINT8 mode, offs_t pc) const
+{
+	for (int index = m_bucket[(pc ^ mode) % HASH_BUCKETS]; index >= 0; index = m_entry[index].hashnext)
+		if (m_entry[index].pc == pc && m_entry[index].mode == mode)
+			return index;
+	return -1;
+}
+
+
+//-------------------------------------------------
+//  add_entry - append a new entry and link it
+//  into the hash table
+//-------------------------------------------------
+
+drc_persistent_cache::block_entry &drc_persistent_cache::add_entry(UINT8 mode, offs_t pc, UINT32 hash)
+{
+	int bucket = (pc ^ mode) % HASH_BUCKETS;
+	int index = m_entry.count();
+	block_entry &entry = m_entry.append();
+	entry.mode = mode;
+	entry.pc = pc;
+	entry.hash = hash;
+	entry.hashnext = m_bucket[bucket];
+	entry.deferred = false;
+	m_bucket[bucket] = index;
+	return entry;
+}
+
+
+//-------------------------------------------------
+//  load - read the list of blocks from the
+//  previous run
+//-------------------------------------------------
+
+void drc_persistent_cache::load()
+{
+	emu_file file(m_device.machine().options().drc_cache_directory(), OPEN_FLAG_READ);
+	if (file.open(m_filename) != FILERR_NONE)
+		return;
+
+	// validate the header
+	char magic[sizeof(drcpcache_magic)];
+	UINT32 header[2];
+	if (file.read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, drcpcache_magic, sizeof(magic)) != 0)
+		return;
+	if (file.read(header, sizeof(header)) != sizeof(header) || LITTLE_ENDIANIZE_INT32(header[0]) != FILE_VERSION)
+		return;
+
+	// read the entries
+	UINT32 count = LITTLE_ENDIANIZE_INT32(header[1]);
+	for (UINT32 entnum = 0; entnum < count; entnum++)
+	{
+		UINT32 data[3];
+		if (file.read(data, sizeof(data)) != sizeof(data))
+			break;
+		UINT8 mode = LITTLE_ENDIANIZE_INT32(data[0]);
+		offs_t pc = LITTLE_ENDIANIZE_INT32(data[1]);
+		if (find_entry(mode, pc) < 0)
+			add_entry(mode, pc, LITTLE_ENDIANIZE_INT32(data[2]));
+	}
+}
+
+
+//-------------------------------------------------
+//  save - write out the list of blocks for the
+//  next run
+//-------------------------------------------------
+
+void drc_persistent_cache::save()
+{
+	emu_file file(m_device.machine().options().drc_cache_directory(), OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file.open(m_filename) != FILERR_NONE)
+		return;
+
+	// write the header
+	UINT32 header[2];
+	header[0] = LITTLE_ENDIANIZE_INT32(FILE_VERSION);
+	header[1] = LITTLE_ENDIANIZE_INT32(m_entry.count());
+	file.write(drcpcache_magic, sizeof(drcpcache_magic));
+	file.write(header, sizeof(header));
+
+	// write the entries
+	for (int index = 0; index < m_entry.count(); index++)
+	{
+		UINT32 data[3];
+		data[0] = LITTLE_ENDIANIZE_INT32(m_entry[index].mode);
+		data[1] = LITTLE_ENDIANIZE_INT32(m_entry[index].pc);
+		data[2] = LITTLE_ENDIANIZE_INT32(m_entry[index].hash);
+		file.write(data, sizeof(data));
+	}
+}
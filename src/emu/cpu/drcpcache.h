@@ -0,0 +1,124 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    drcpcache.h
+
+    Persistent on-disk index of recompiled code blocks.
+
+****************************************************************************
+
+    Concepts:
+
+    The native code produced by a backend is full of absolute pointers
+    into the running machine (CPU state, memory accessors, the hash
+    tables), so it cannot be reused from one run to the next. What can
+    be reused is the knowledge of which blocks are hot.
+
+    Every time a CPU core compiles a block, the mode, start PC and a
+    hash of the opcode bytes the frontend described are recorded. The
+    list is written out when the CPU is stopped, and read back the next
+    time the same system is run. After each cache flush requested at
+    startup, the core walks the list and compiles every block whose
+    opcode bytes still hash to the recorded value, so that the work
+    happens up front instead of in the middle of gameplay.
+
+    Code that lives in RAM usually hasn't been loaded yet at that
+    point, so its blocks don't match and are set aside. The first time
+    one of them is compiled on demand with the recorded code, the rest
+    of the set-aside blocks are tried again, since the program they
+    belong to has most likely been loaded by then. Blocks whose code
+    really has changed are simply recorded again.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __DRCPCACHE_H__
+#define __DRCPCACHE_H__
+
+#include "drcuml.h"
+#include "drcfe.h"
+
+
+//**************************************************************************
+//  TYPE DEFINITIONS
+//**************************************************************************
+
+// callback used to compile a block from the persistent list
+typedef delegate<void (UINT8, offs_t)> drc_precompile_delegate;
+
+
+// drc_persistent_cache
+class drc_persistent_cache
+{
+public:
+	// construction/destruction
+	drc_persistent_cache(device_t &device, drcuml_state &drcuml);
+	~drc_persistent_cache();
+
+	// getters
+	bool precompiling() const { return m_precompiling; }
+	bool retry_pending() const { return m_retry_pending; }
+	UINT32 hits() const { return m_hits; }
+	UINT32 misses() const { return m_misses; }
+	UINT32 stale() const { return m_stale; }
+
+	// compile all the recorded blocks whose code is unchanged
+	void precompile(drc_precompile_delegate compile);
+
+	// try the blocks that didn't match when precompiling again
+	void retry(drc_precompile_delegate compile);
+
+	// called by the core once a block has been described
+	bool block_described(UINT8 mode, offs_t pc, const opcode_desc *desclist);
+
+	// called by the core once a block has been fully compiled
+	void block_compiled();
+
+private:
+	// persistent file format
+	static const UINT32 FILE_VERSION = 1;
+	static const UINT32 HASH_BUCKETS = 1024;
+
+	// an entry describing a single block
+	struct block_entry
+	{
+		UINT8           mode;               // mode the block was compiled in
+		offs_t          pc;                 // starting PC of the block
+		UINT32          hash;               // hash of the described opcode bytes
+		int             hashnext;           // index of next entry in the same bucket
+		bool            deferred;           // true if the code didn't match when precompiling
+	};
+
+	// internal helpers
+	void compile_entries(drc_precompile_delegate compile, bool deferred_only);
+	static UINT32 hash_opcodes(const opcode_desc *desclist);
+	int find_entry(UINT8 mode, offs_t pc) const;
+	block_entry &add_entry(UINT8 mode, offs_t pc, UINT32 hash);
+	void load();
+	void save();
+
+	// internal state
+	device_t &          m_device;           // CPU device we are associated with
+	drcuml_state &      m_drcuml;           // UML state owning the cache
+	astring             m_filename;         // name of the persistent file
+	dynamic_array<block_entry> m_entry;     // array of known blocks
+	int                 m_bucket[HASH_BUCKETS]; // head index of each hash bucket
+	bool                m_dirty;            // true if we need to write out the list
+	bool                m_precompiling;     // true while precompiling from the list
+	bool                m_retry_pending;    // true if deferred blocks should be tried again
+	int                 m_retries;          // number of retries since the last precompile
+	int                 m_expected;         // index of the entry being precompiled
+	osd_ticks_t         m_starttime;        // time the current compile started
+
+	// statistics
+	UINT32              m_hits;             // blocks compiled from the persistent list
+	UINT32              m_misses;           // blocks compiled on demand
+	UINT32              m_stale;            // recorded blocks whose code changed
+	osd_ticks_t         m_precompile_ticks; // time spent compiling from the list
+	osd_ticks_t         m_demand_ticks;     // time spent compiling on demand
+};
+
+
+#endif /* __DRCPCACHE_H__ */
@@ -11,7 +11,8 @@
     Future improvements/changes:
 
     * UML optimizer:
-        - constant folding
+        - constant propagation across labels
+        - dead store elimination
 
     * Write a back-end validator:
         - checks all combinations of memory/register/immediate on all params
@@ -124,8 +125,16 @@ drcuml_state::drcuml_state(device_t &device, drc_cache &cache, UINT32 flags, int
 		m_beintf(device.machine().options().drc_use_c() ?
 			*static_cast<drcbe_interface *>(auto_alloc(device.machine(), drcbe_c(*this, device, cache, flags, modes, addrbits, ignorebits))) :
 			*static_cast<drcbe_interface *>(auto_alloc(device.machine(), drcbe_native(*this, device, cache, flags, modes, addrbits, ignorebits)))),
-		m_umllog(NULL)
+		m_umllog(NULL),
+		m_optimize(parse_optimize_passes(device.machine().options().drc_optimize()))
 {
+	memset(&m_optstats, 0, sizeof(m_optstats));
+
+	// if requested, retire old code a region at a time instead of flushing everything;
+	// this can't be done while code is being compiled in the background
+	if (device.machine().options().drc_evict_regions() > 1 && !device.machine().options().drc_async_compile())
+		m_cache.set_eviction_regions(device.machine().options().drc_evict_regions());
+
 	// if we're to log, create the logfile
 	if (device.machine().options().drc_log_uml())
 	{
@@ -141,6 +150,18 @@ drcuml_state::drcuml_state(device_t &device, drc_cache &cache, UINT32 flags, int
 
 drcuml_state::~drcuml_state()
 {
+	// report what the optimizer accomplished
+	if (m_optstats.blocks != 0)
+	{
+		astring summary;
+		summary.printf("UML optimizer '%s': %d blocks, %d instructions, %d flag computations removed, %d loads forwarded, %d constants propagated, %d simplified (%d to nops); %" I64FMT "u bytes of native code, %.1f per block\n",
+			m_device.tag(), m_optstats.blocks, m_optstats.instructions, m_optstats.flags_removed, m_optstats.loads_forwarded, m_optstats.constants, m_optstats.simplified, m_optstats.nops,
+			m_optstats.code_bytes, (double)m_optstats.code_bytes / (double)m_optstats.blocks);
+		osd_printf_verbose("%s", summary.cstr());
+		if (logging())
+			log_printf("%s", summary.cstr());
+	}
+
 	// free the back-end
 	auto_free(m_device.machine(), &m_beintf);
 
@@ -188,6 +209,50 @@ void drcuml_state::reset()
 }
 
 
+//-------------------------------------------------
+//  parse_optimize_passes - convert a comma-
+//  separated list of pass names into a mask
+//-------------------------------------------------
+
+UINT32 drcuml_state::parse_optimize_passes(const char *passes)
+{
+	static const struct { const char *name; UINT32 mask; } s_passes[] =
+	{
+		{ "none",   0 },
+		{ "flags",  DRCUML_OPTIMIZE_FLAGS },
+		{ "memory", DRCUML_OPTIMIZE_MEMORY },
+		{ "const",  DRCUML_OPTIMIZE_CONST },
+		{ "all",    DRCUML_OPTIMIZE_ALL }
+	};
+
+	UINT32 result = 0;
+	while (*passes != 0)
+	{
+		// isolate the next name
+		const char *end = strchr(passes, ',');
+		if (end == NULL)
+			end = passes + strlen(passes);
+		astring name(passes, end - passes);
+		name.trimspace();
+		passes = (*end == ',') ? end + 1 : end;
+		if (name.len() == 0)
+			continue;
+
+		// look it up
+		int passnum;
+		for (passnum = 0; passnum < ARRAY_LENGTH(s_passes); passnum++)
+			if (name == s_passes[passnum].name)
+			{
+				result |= s_passes[passnum].mask;
+				break;
+			}
+		if (passnum == ARRAY_LENGTH(s_passes))
+			osd_printf_warning("Unknown UML optimization pass '%s'\n", name.cstr());
+	}
+	return result;
+}
+
+
 //-------------------------------------------------
 //  begin_block - begin a new code block
 //-------------------------------------------------
@@ -339,8 +404,22 @@ void drcuml_block::end()
 	if (m_drcuml.logging())
 		disassemble();
 
-	// generate the code via the back-end
+	// static code defines handles; the first block that doesn't marks the end of it
+	bool defines_handle = false;
+	for (int instnum = 0; instnum < m_nextinst && !defines_handle; instnum++)
+		defines_handle = (m_inst[instnum].opcode() == OP_HANDLE);
+	drc_cache &cache = m_drcuml.cache();
+	if (!cache.static_code_complete() && !defines_handle)
+		cache.end_static_code();
+
+	// static code generated after that can't be evicted safely, so stop evicting
+	else if (cache.static_code_complete() && defines_handle)
+		cache.disable_eviction();
+
+	// generate the code via the back-end, counting what it adds to the cache
+	UINT64 before = cache.bytes_generated();
 	m_drcuml.generate(*this, m_inst, m_nextinst);
+	m_drcuml.optimize_stats().code_bytes += cache.bytes_generated() - before;
 
 	// block is no longer in use
 	m_inuse = false;
@@ -403,6 +482,67 @@ void drcuml_block::append_comment(const char *format, ...)
 }
 
 
+//-------------------------------------------------
+//  is_entry_point - return true if code can enter
+//  at this instruction from elsewhere, so nothing
+//  is known about the machine state
+//-------------------------------------------------
+
+static bool is_entry_point(const instruction &inst)
+{
+	return (inst.opcode() == OP_HANDLE || inst.opcode() == OP_HASH || inst.opcode() == OP_LABEL);
+}
+
+
+//-------------------------------------------------
+//  is_straight_line - return false if anything we
+//  know about the machine state must be discarded
+//  after this instruction; this is true of control
+//  flow and anything that can run code we can't
+//  see
+//-------------------------------------------------
+
+static bool is_straight_line(const instruction &inst)
+{
+	switch (inst.opcode())
+	{
+		// entry points
+		case OP_HANDLE:
+		case OP_HASH:
+		case OP_LABEL:
+
+		// control flow, calls out to handles, C code, and the debugger
+		case OP_DEBUG:
+		case OP_EXIT:
+		case OP_HASHJMP:
+		case OP_JMP:
+		case OP_EXH:
+		case OP_CALLH:
+		case OP_RET:
+		case OP_CALLC:
+		case OP_RECOVER:
+
+		// wholesale changes to the machine state
+		case OP_SAVE:
+		case OP_RESTORE:
+
+		// indexed stores, and memory accesses that may end up in a handler
+		case OP_STORE:
+		case OP_FSTORE:
+		case OP_READ:
+		case OP_READM:
+		case OP_WRITE:
+		case OP_WRITEM:
+		case OP_FREAD:
+		case OP_FWRITE:
+			return false;
+
+		default:
+			return true;
+	}
+}
+
+
 //-------------------------------------------------
 //  optimize - apply various optimizations to a
 //  block of code
@@ -410,7 +550,44 @@ void drcuml_block::append_comment(const char *format, ...)
 
 void drcuml_block::optimize()
 {
-	UINT32 mapvar[MAPVAR_COUNT] = { 0 };
+	drcuml_optimize_stats &stats = m_drcuml.optimize_stats();
+	stats.blocks++;
+	stats.instructions += m_nextinst;
+
+	// flags must be settled first, since simplification depends on them
+	optimize_flags();
+
+	// mapvars are always converted, since the back-ends can't handle them
+	optimize_mapvars();
+
+	// forward stores before propagating constants so that the forwarded registers can be folded
+	if (m_drcuml.optimize_passes() & DRCUML_OPTIMIZE_MEMORY)
+		optimize_memory();
+
+	// constant propagation simplifies as it goes; otherwise do it separately
+	if (m_drcuml.optimize_passes() & DRCUML_OPTIMIZE_CONST)
+		optimize_constants();
+	else
+		optimize_simplify();
+}
+
+
+//-------------------------------------------------
+//  optimize_flags - compute the minimal set of
+//  flags each instruction must generate
+//-------------------------------------------------
+
+void drcuml_block::optimize_flags()
+{
+	drcuml_optimize_stats &stats = m_drcuml.optimize_stats();
+
+	// if disabled, every instruction generates everything it can
+	if (!(m_drcuml.optimize_passes() & DRCUML_OPTIMIZE_FLAGS))
+	{
+		for (int instnum = 0; instnum < m_nextinst; instnum++)
+			m_inst[instnum].set_flags(m_inst[instnum].output_flags());
+		return;
+	}
 
 	// iterate over instructions
 	for (int instnum = 0; instnum < m_nextinst; instnum++)
@@ -433,6 +610,25 @@ void drcuml_block::optimize()
 				remainingflags &= ~scan.modified_flags();
 		}
 		inst.set_flags(accumflags);
+		if ((inst.output_flags() & ~accumflags) != 0)
+			stats.flags_removed++;
+	}
+}
+
+
+//-------------------------------------------------
+//  optimize_mapvars - replace all mapvar
+//  parameters with their current values
+//-------------------------------------------------
+
+void drcuml_block::optimize_mapvars()
+{
+	UINT32 mapvar[MAPVAR_COUNT] = { 0 };
+
+	// iterate over instructions
+	for (int instnum = 0; instnum < m_nextinst; instnum++)
+	{
+		instruction &inst = m_inst[instnum];
 
 		// track mapvars
 		if (inst.opcode() == OP_MAPVAR)
@@ -443,9 +639,175 @@ void drcuml_block::optimize()
 			for (int pnum = 0; pnum < inst.numparams(); pnum++)
 				if (inst.param(pnum).is_mapvar())
 					inst.set_mapvar(pnum, mapvar[inst.param(pnum).mapvar() - MAPVAR_M0]);
+	}
+}
 
-		// now that flags are correct, simplify the instruction
-		inst.simplify();
+
+//-------------------------------------------------
+//  optimize_memory - replace loads from memory
+//  with the register last stored there (or loaded
+//  from there) when nothing could have changed
+//  either in between
+//-------------------------------------------------
+
+void drcuml_block::optimize_memory()
+{
+	drcuml_optimize_stats &stats = m_drcuml.optimize_stats();
+
+	// a memory location known to hold the same value as a register
+	struct mem_alias
+	{
+		UINT8 *     base;               // address of the memory
+		UINT8       size;               // size of the access
+		int         reg;                // register with the same value
+	};
+	mem_alias alias[16];
+	int aliases = 0;
+
+	// iterate over instructions
+	for (int instnum = 0; instnum < m_nextinst; instnum++)
+	{
+		instruction &inst = m_inst[instnum];
+		if (is_entry_point(inst))
+			aliases = 0;
+
+		// replace memory inputs with registers where possible
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+			if (inst.param(pnum).is_memory() && inst.param_is_input_only(pnum) && inst.param_accepts(pnum, parameter::PTYPE_INT_REGISTER))
+			{
+				UINT8 *base = reinterpret_cast<UINT8 *>(inst.param(pnum).memory());
+				for (int aliasnum = 0; aliasnum < aliases; aliasnum++)
+					if (alias[aliasnum].base == base && alias[aliasnum].size == inst.param_size(pnum))
+					{
+						inst.set_param(pnum, parameter::make_ireg(alias[aliasnum].reg));
+						stats.loads_forwarded++;
+						break;
+					}
+			}
+
+		// forget anything whose memory or register is overwritten
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+			if (inst.param_is_output(pnum))
+			{
+				const parameter &param = inst.param(pnum);
+				UINT8 *base = param.is_memory() ? reinterpret_cast<UINT8 *>(param.memory()) : NULL;
+				UINT8 size = inst.param_size(pnum);
+				for (int aliasnum = 0; aliasnum < aliases; aliasnum++)
+					if ((param.is_int_register() && alias[aliasnum].reg == param.ireg()) ||
+						(base != NULL && base < alias[aliasnum].base + alias[aliasnum].size && alias[aliasnum].base < base + size))
+						alias[aliasnum--] = alias[--aliases];
+			}
+
+		// an unconditional integer move between a register and memory creates a new alias
+		if (inst.opcode() == OP_MOV && inst.condition() == COND_ALWAYS && aliases < ARRAY_LENGTH(alias))
+		{
+			const parameter &dst = inst.param(0);
+			const parameter &src = inst.param(1);
+			if (dst.is_memory() && src.is_int_register())
+			{
+				alias[aliases].base = reinterpret_cast<UINT8 *>(dst.memory());
+				alias[aliases].size = inst.size();
+				alias[aliases++].reg = src.ireg();
+			}
+			else if (dst.is_int_register() && src.is_memory())
+			{
+				alias[aliases].base = reinterpret_cast<UINT8 *>(src.memory());
+				alias[aliases].size = inst.size();
+				alias[aliases++].reg = dst.ireg();
+			}
+		}
+
+		// past this point we know nothing
+		if (!is_straight_line(inst))
+			aliases = 0;
+	}
+}
+
+
+//-------------------------------------------------
+//  optimize_constants - replace integer register
+//  inputs with immediates where the register is
+//  known to hold a constant, simplifying as we go
+//  so that the results can be folded further
+//-------------------------------------------------
+
+void drcuml_block::optimize_constants()
+{
+	drcuml_optimize_stats &stats = m_drcuml.optimize_stats();
+
+	// per-register state: size of known value (0 if unknown) and the value itself
+	UINT8 known[REG_I_COUNT] = { 0 };
+	UINT64 value[REG_I_COUNT];
+
+	// iterate over instructions
+	for (int instnum = 0; instnum < m_nextinst; instnum++)
+	{
+		instruction &inst = m_inst[instnum];
+		if (is_entry_point(inst))
+			memset(known, 0, sizeof(known));
+
+		// replace register inputs with known values; 32-bit values are only usable by 32-bit consumers
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+			if (inst.param(pnum).is_int_register() && inst.param_is_input_only(pnum) && inst.param_accepts(pnum, parameter::PTYPE_IMMEDIATE))
+			{
+				int regnum = inst.param(pnum).ireg() - REG_I0;
+				UINT8 size = inst.param_size(pnum);
+				if (known[regnum] != 0 && size <= known[regnum])
+				{
+					inst.set_param(pnum, (size == 8) ? value[regnum] : (value[regnum] & 0xffffffff));
+					stats.constants++;
+				}
+			}
+
+		// now fold what we can
+		simplify(inst);
+
+		// any register outputs are now unknown, unless we just moved a constant into it
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+			if (inst.param_is_output(pnum) && inst.param(pnum).is_int_register())
+				known[inst.param(pnum).ireg() - REG_I0] = 0;
+		if (inst.opcode() == OP_MOV && inst.condition() == COND_ALWAYS && inst.param(0).is_int_register() && inst.param(1).is_immediate())
+		{
+			int regnum = inst.param(0).ireg() - REG_I0;
+			known[regnum] = inst.size();
+			value[regnum] = (inst.size() == 8) ? inst.param(1).immediate() : (inst.param(1).immediate() & 0xffffffff);
+		}
+
+		// past this point we know nothing
+		if (!is_straight_line(inst))
+			memset(known, 0, sizeof(known));
+	}
+}
+
+
+//-------------------------------------------------
+//  optimize_simplify - simplify each instruction
+//  in isolation
+//-------------------------------------------------
+
+void drcuml_block::optimize_simplify()
+{
+	for (int instnum = 0; instnum < m_nextinst; instnum++)
+		simplify(m_inst[instnum]);
+}
+
+
+//-------------------------------------------------
+//  simplify - simplify a single instruction and
+//  account for any change
+//-------------------------------------------------
+
+void drcuml_block::simplify(instruction &inst)
+{
+	drcuml_optimize_stats &stats = m_drcuml.optimize_stats();
+
+	opcode_t origop = inst.opcode();
+	inst.simplify();
+	if (inst.opcode() != origop)
+	{
+		stats.simplified++;
+		if (inst.opcode() == OP_NOP)
+			stats.nops++;
 	}
 }
 
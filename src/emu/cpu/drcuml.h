@@ -23,6 +23,15 @@
 
 // these options are passed into drcuml_alloc() and control global behaviors
 
+// optimization passes applied to each block, selected via -drc_optimize
+enum
+{
+	DRCUML_OPTIMIZE_FLAGS   = 0x01,             // only compute flags that are consumed later
+	DRCUML_OPTIMIZE_MEMORY  = 0x02,             // forward stored registers to later loads
+	DRCUML_OPTIMIZE_CONST   = 0x04,             // propagate constants through integer registers
+	DRCUML_OPTIMIZE_ALL     = 0x07
+};
+
 
 
 //**************************************************************************
@@ -39,6 +48,20 @@ typedef NATIVE_DRC drcbe_native;
 #endif
 
 
+// counters accumulated by the optimizer across all blocks
+struct drcuml_optimize_stats
+{
+	UINT32              blocks;             // number of blocks optimized
+	UINT32              instructions;       // number of instructions seen
+	UINT32              flags_removed;      // instructions with unneeded flags dropped
+	UINT32              loads_forwarded;    // memory operands replaced by registers
+	UINT32              constants;          // register operands replaced by immediates
+	UINT32              simplified;         // instructions rewritten by simplify()
+	UINT32              nops;               // instructions simplified away entirely
+	UINT64              code_bytes;         // native code the back-end generated for them
+};
+
+
 // opaque structure describing UML generation state
 class drcuml_state;
 
@@ -120,6 +143,12 @@ public:
 private:
 	// internal helpers
 	void optimize();
+	void optimize_flags();
+	void optimize_mapvars();
+	void optimize_memory();
+	void optimize_constants();
+	void optimize_simplify();
+	void simplify(uml::instruction &inst);
 	void disassemble();
 	const char *get_comment_text(const uml::instruction &inst, astring &comment);
 
@@ -179,6 +208,10 @@ public:
 	// code generation
 	drcuml_block *begin_block(UINT32 maxinst);
 
+	// optimizer
+	UINT32 optimize_passes() const { return m_optimize; }
+	drcuml_optimize_stats &optimize_stats() { return m_optstats; }
+
 	// back-end interface
 	void get_backend_info(drcbe_info &info) { m_beintf.get_info(info); }
 	bool hash_exists(UINT32 mode, UINT32 pc) { return m_beintf.hash_exists(mode, pc); }
@@ -198,6 +231,9 @@ public:
 	bool logging_native() const { return m_beintf.logging(); }
 
 private:
+	// internal helpers
+	static UINT32 parse_optimize_passes(const char *passes);
+
 	// symbol class
 	class symbol
 	{
@@ -228,6 +264,8 @@ private:
 	drc_cache &                 m_cache;            // pointer to the codegen cache
 	drcbe_interface &           m_beintf;           // backend interface pointer
 	FILE *                      m_umllog;           // handle to the UML logfile
+	UINT32                      m_optimize;         // mask of DRCUML_OPTIMIZE_* passes to run
+	drcuml_optimize_stats       m_optstats;         // optimizer statistics
 	simple_list<drcuml_block>   m_blocklist;        // list of active blocks
 	simple_list<uml::code_handle> m_handlelist;     // list of active handles
 	simple_list<symbol>         m_symlist;          // list of symbols
@@ -155,8 +155,11 @@ mips3_device::mips3_device(const machine_config &mconfig, device_type type, cons
 	, m_cache(CACHE_SIZE + sizeof(internal_mips3_state))
 	, m_drcuml(NULL)
 	, m_drcfe(NULL)
+	, m_drcpcache(NULL)
+	, m_drcasync(NULL)
 	, m_drcoptions(0)
 	, m_cache_dirty(0)
+	, m_compile_mode(0)
 	, m_entry(NULL)
 	, m_nocode(NULL)
 	, m_out_of_cycles(NULL)
@@ -202,6 +205,16 @@ void mips3_device::device_stop()
 		m_vtlb = NULL;
 	}
 
+	if (m_drcasync != NULL)
+	{
+		auto_free(machine(), m_drcasync);
+		m_drcasync = NULL;
+	}
+	if (m_drcpcache != NULL)
+	{
+		auto_free(machine(), m_drcpcache);
+		m_drcpcache = NULL;
+	}
 	if (m_drcfe != NULL)
 	{
 		auto_free(machine(), m_drcfe);
@@ -403,6 +416,18 @@ void mips3_device::device_start()
 	/* initialize the front-end helper */
 	m_drcfe = auto_alloc(machine(), mips3_frontend(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE));
 
+	/* if requested, remember compiled blocks across runs */
+	if (machine().options().drc_cache())
+		m_drcpcache = auto_alloc(machine(), drc_persistent_cache(*this, *m_drcuml));
+
+	/* if requested, compile in the background and interpret until the code is ready */
+	if (m_isdrc && machine().options().drc_async_compile())
+	{
+		m_drcasync = auto_alloc(machine(), drc_async_compiler(*this, *m_drcuml, drc_describe_delegate(FUNC(mips3_device::code_describe_block), this), drc_generate_delegate(FUNC(mips3_device::code_generate_block), this)));
+		for (int slot = 0; slot < drc_async_compiler::MAX_PENDING; slot++)
+			m_drcasync->set_frontend(slot, *auto_alloc(machine(), mips3_frontend(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE)));
+	}
+
 	/* allocate memory for cache-local state and initialize it */
 	memcpy(m_fpmode, fpmode_source, sizeof(fpmode_source));
 
@@ -2505,9 +2530,21 @@ void mips3_device::execute_run()
 	{
 		int execute_result;
 
-		/* reset the cache if dirty */
+		/* reset the cache if dirty, and precompile any remembered blocks */
 		if (m_cache_dirty)
+		{
 			code_flush_cache();
+			if (m_drcpcache != NULL)
+				m_drcpcache->precompile(drc_precompile_delegate(FUNC(mips3_device::code_compile_block), this));
+		}
+
+		/* once code in RAM turns up, try the remembered blocks that didn't match again */
+		else if (m_drcpcache != NULL && m_drcpcache->retry_pending())
+		{
+			if (m_drcasync != NULL)
+				m_drcasync->wait();
+			m_drcpcache->retry(drc_precompile_delegate(FUNC(mips3_device::code_compile_block), this));
+		}
 		m_cache_dirty = FALSE;
 
 		/* execute */
@@ -2516,10 +2553,19 @@ void mips3_device::execute_run()
 			/* run as much as we can */
 			execute_result = m_drcuml->execute(*m_entry);
 
-			/* if we need to recompile, do it */
+			/* if we need to recompile, do it, in the background if we can */
 			if (execute_result == EXECUTE_MISSING_CODE)
 			{
-				code_compile_block(m_core->mode, m_core->pc);
+				if (m_drcasync != NULL && m_drcasync->request(m_core->mode, m_core->pc))
+				{
+					/* interpret until the code shows up */
+					execute_interpreted();
+					m_core->mode = current_mode();
+					if (m_core->icount <= 0)
+						execute_result = EXECUTE_OUT_OF_CYCLES;
+				}
+				else
+					code_compile_block(m_core->mode, m_core->pc);
 			}
 			else if (execute_result == EXECUTE_UNMAPPED_CODE)
 			{
@@ -2530,6 +2576,10 @@ void mips3_device::execute_run()
 				code_flush_cache();
 			}
 
+			/* a background compile that ran out of space leaves the flush to us */
+			if (m_drcasync != NULL && m_drcasync->flush_needed())
+				code_flush_cache();
+
 		} while (execute_result != EXECUTE_OUT_OF_CYCLES);
 
 		return;
@@ -2545,6 +2595,38 @@ void mips3_device::execute_run()
 	/* check for IRQs */
 	check_irqs();
 
+	/* run until out of cycles */
+	execute_interpreted();
+
+	m_core->icount -= m_interrupt_cycles;
+	m_interrupt_cycles = 0;
+}
+
+
+/*-------------------------------------------------
+    current_mode - compute the recompiler mode
+    from the current state of SR, matching
+    generate_update_mode
+-------------------------------------------------*/
+
+UINT8 mips3_device::current_mode()
+{
+	UINT8 mode = (SR >> 2) & 0x06;
+	if (SR & (SR_EXL | SR_ERL))
+		mode = 0;
+	return mode | ((SR >> 26) & 0x01);
+}
+
+
+/*-------------------------------------------------
+    execute_interpreted - interpret instructions
+    until out of cycles; when standing in for the
+    recompiler, stop as soon as there is
+    compiled code for the current PC
+-------------------------------------------------*/
+
+void mips3_device::execute_interpreted()
+{
 	/* core execution loop */
 	do
 	{
@@ -2819,10 +2901,11 @@ void mips3_device::execute_run()
 		}
 		m_core->icount--;
 
-	} while (m_core->icount > 0 || m_nextpc != ~0);
+		/* hand back to the recompiler once it has caught up, but never in a delay slot */
+		if (m_drcasync != NULL && m_nextpc == ~0 && m_drcuml->hash_exists(current_mode(), m_core->pc))
+			break;
 
-	m_core->icount -= m_interrupt_cycles;
-	m_interrupt_cycles = 0;
+	} while (m_core->icount > 0 || m_nextpc != ~0);
 }
 
 
@@ -18,6 +18,8 @@
 #include "cpu/vtlb.h"
 #include "cpu/drcfe.h"
 #include "cpu/drcuml.h"
+#include "cpu/drcpcache.h"
+#include "cpu/drcasync.h"
 #include "cpu/drcumlsh.h"
 
 
@@ -410,10 +412,13 @@ private:
 	drc_cache           m_cache;                      /* pointer to the DRC code cache */
 	drcuml_state *      m_drcuml;                     /* DRC UML generator state */
 	mips3_frontend *    m_drcfe;                      /* pointer to the DRC front-end state */
+	drc_persistent_cache *m_drcpcache;                /* pointer to the persistent block list */
+	drc_async_compiler *m_drcasync;                   /* pointer to the background compiler */
 	UINT32              m_drcoptions;                 /* configurable DRC options */
 
 	/* internal stuff */
 	UINT8               m_cache_dirty;                /* true if we need to flush the cache */
+	UINT8               m_compile_mode;               /* mode of the block being compiled */
 
 	/* tables */
 	UINT8               m_fpmode[4];                  /* FPU mode table */
@@ -531,6 +536,10 @@ private:
 	void save_fast_iregs(drcuml_block *block);
 	void code_flush_cache();
 	void code_compile_block(UINT8 mode, offs_t pc);
+	const opcode_desc *code_describe_block(drc_frontend &frontend, UINT8 mode, offs_t pc);
+	void code_generate_block(UINT8 mode, offs_t pc, const opcode_desc *desclist);
+	void execute_interpreted();
+	UINT8 current_mode();
 public:
 	void func_get_cycles();
 	void func_printf_exception();
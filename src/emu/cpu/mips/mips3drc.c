@@ -45,7 +45,7 @@ using namespace uml;
 #define HI32                    R32(REG_HI)
 #define CPR032(reg)             mem(LOPTR(&m_core->cpr[0][reg]))
 #define CCR032(reg)             mem(LOPTR(&m_core->ccr[0][reg]))
-#define FPR32(reg)              mem(((m_core->mode & 1) == 0) ? &((float *)&m_core->cpr[1][0])[reg] : (float *)&m_core->cpr[1][reg])
+#define FPR32(reg)              mem(((m_compile_mode & 1) == 0) ? &((float *)&m_core->cpr[1][0])[reg] : (float *)&m_core->cpr[1][reg])
 #define CCR132(reg)             mem(LOPTR(&m_core->ccr[1][reg]))
 #define CPR232(reg)             mem(LOPTR(&m_core->cpr[2][reg]))
 #define CCR232(reg)             mem(LOPTR(&m_core->ccr[2][reg]))
@@ -55,7 +55,7 @@ using namespace uml;
 #define HI64                    R64(REG_HI)
 #define CPR064(reg)             mem(&m_core->cpr[0][reg])
 #define CCR064(reg)             mem(&m_core->ccr[0][reg])
-#define FPR64(reg)              mem(((m_core->mode & 1) == 0) ? (double *)&m_core->cpr[1][(reg)/2] : (double *)&m_core->cpr[1][reg])
+#define FPR64(reg)              mem(((m_compile_mode & 1) == 0) ? (double *)&m_core->cpr[1][(reg)/2] : (double *)&m_core->cpr[1][reg])
 #define CCR164(reg)             mem(&m_core->ccr[1][reg])
 #define CPR264(reg)             mem(&m_core->cpr[2][reg])
 #define CCR264(reg)             mem(&m_core->ccr[2][reg])
@@ -205,6 +205,10 @@ void mips3_device::code_flush_cache()
 {
 	int mode;
 
+	/* nothing can be compiling in the background while we do this */
+	if (m_drcasync != NULL)
+		m_drcasync->reset();
+
 	/* empty the transient cache contents */
 	m_drcuml->reset();
 
@@ -263,18 +267,55 @@ void mips3_device::code_flush_cache()
 -------------------------------------------------*/
 
 void mips3_device::code_compile_block(UINT8 mode, offs_t pc)
+{
+	g_profiler.start(PROFILER_DRC_COMPILE);
+
+	/* get a description of this sequence and generate code for it */
+	const opcode_desc *desclist = code_describe_block(*m_drcfe, mode, pc);
+	if (desclist != NULL)
+		code_generate_block(mode, pc, desclist);
+
+	g_profiler.stop();
+}
+
+
+/*-------------------------------------------------
+    code_describe_block - describe a block of the
+    given mode at the specified pc; this touches
+    memory, so it must run on the emulation thread
+-------------------------------------------------*/
+
+const opcode_desc *mips3_device::code_describe_block(drc_frontend &frontend, UINT8 mode, offs_t pc)
+{
+	const opcode_desc *desclist = frontend.describe_code(pc);
+
+	/* when precompiling, skip blocks whose code has changed since they were recorded */
+	if (m_drcpcache != NULL && !m_drcpcache->block_described(mode, pc, desclist))
+		return NULL;
+	return desclist;
+}
+
+
+/*-------------------------------------------------
+    code_generate_block - generate code for a
+    described block; this may run on the
+    background compiler's thread
+-------------------------------------------------*/
+
+void mips3_device::code_generate_block(UINT8 mode, offs_t pc, const opcode_desc *desclist)
 {
 	drcuml_state *drcuml = m_drcuml;
 	compiler_state compiler = { 0 };
 	const opcode_desc *seqhead, *seqlast;
-	const opcode_desc *desclist;
 	int override = FALSE;
 	drcuml_block *block;
 
-	g_profiler.start(PROFILER_DRC_COMPILE);
+	/* only the emulation thread may flush the cache */
+	bool foreground = (m_drcasync == NULL || !m_drcasync->in_background());
+
+	/* code is generated for the requested mode, not whatever mode we are in now */
+	m_compile_mode = mode;
 
-	/* get a description of this sequence */
-	desclist = m_drcfe->describe_code(pc);
 	if (drcuml->logging() || drcuml->logging_native())
 		log_opcode_desc(drcuml, desclist, 0);
 
@@ -319,13 +360,13 @@ void mips3_device::code_compile_block(UINT8 mode, offs_t pc)
 				else
 				{
 					UML_LABEL(block, seqhead->pc | 0x80000000);                             // label   seqhead->pc | 0x80000000
-					UML_HASHJMP(block, m_core->mode, seqhead->pc, *m_nocode);
+					UML_HASHJMP(block, m_compile_mode, seqhead->pc, *m_nocode);
 																							// hashjmp <mode>,seqhead->pc,nocode
 					continue;
 				}
 
 				/* validate this code block if we're not pointing into ROM */
-				if (m_program->get_write_ptr(seqhead->physpc) != NULL)
+				if (seqhead->flags & OPFLAG_WRITEABLE_CODE)
 					generate_checksum_block(block, &compiler, seqhead, seqlast);
 
 				/* label this instruction, if it may be jumped to locally */
@@ -352,17 +393,24 @@ void mips3_device::code_compile_block(UINT8 mode, offs_t pc)
 					UML_HASHJMP(block, mem(&m_core->mode), nextpc, *m_nocode);
 																							// hashjmp <mode>,nextpc,nocode
 				else if (seqlast->next() == NULL || seqlast->next()->pc != nextpc)
-					UML_HASHJMP(block, m_core->mode, nextpc, *m_nocode);
+					UML_HASHJMP(block, m_compile_mode, nextpc, *m_nocode);
 																							// hashjmp <mode>,nextpc,nocode
 			}
 
 			/* end the sequence */
 			block->end();
-			g_profiler.stop();
+			if (m_drcpcache != NULL && foreground)
+				m_drcpcache->block_compiled();
 			succeeded = true;
 		}
 		catch (drcuml_block::abort_compilation &)
 		{
+			/* the running code may live in the cache, so only the emulation thread can flush it */
+			if (!foreground)
+			{
+				m_drcasync->cache_full();
+				return;
+			}
 			code_flush_cache();
 		}
 	}
@@ -1079,12 +1127,12 @@ void mips3_device::generate_checksum_block(drcuml_block *block, compiler_state *
 		if (!(seqhead->flags & OPFLAG_VIRTUAL_NOOP))
 		{
 			UINT32 sum = seqhead->opptr.l[0];
-			void *base = m_direct->read_decrypted_ptr(seqhead->physpc);
+			void *base = seqhead->opbase;
 			UML_LOAD(block, I0, base, 0, SIZE_DWORD, SCALE_x4);         // load    i0,base,0,dword
 
 			if (seqhead->delay.first() != NULL && seqhead->physpc != seqhead->delay.first()->physpc)
 			{
-				base = m_direct->read_decrypted_ptr(seqhead->delay.first()->physpc);
+				base = seqhead->delay.first()->opbase;
 				assert(base != NULL);
 				UML_LOAD(block, I1, base, 0, SIZE_DWORD, SCALE_x4);                 // load    i1,base,dword
 				UML_ADD(block, I0, I0, I1);                     // add     i0,i0,i1
@@ -1104,20 +1152,20 @@ void mips3_device::generate_checksum_block(drcuml_block *block, compiler_state *
 		for (curdesc = seqhead->next(); curdesc != seqlast->next(); curdesc = curdesc->next())
 			if (!(curdesc->flags & OPFLAG_VIRTUAL_NOOP))
 			{
-				void *base = m_direct->read_decrypted_ptr(seqhead->physpc);
+				void *base = seqhead->opbase;
 				UML_LOAD(block, I0, base, 0, SIZE_DWORD, SCALE_x4);     // load    i0,base,0,dword
 				UML_CMP(block, I0, curdesc->opptr.l[0]);                    // cmp     i0,opptr[0]
 				UML_EXHc(block, COND_NE, *m_nocode, epc(seqhead));   // exne    nocode,seqhead->pc
 			}
 #else
 		UINT32 sum = 0;
-		void *base = m_direct->read_decrypted_ptr(seqhead->physpc);
+		void *base = seqhead->opbase;
 		UML_LOAD(block, I0, base, 0, SIZE_DWORD, SCALE_x4);             // load    i0,base,0,dword
 		sum += seqhead->opptr.l[0];
 		for (curdesc = seqhead->next(); curdesc != seqlast->next(); curdesc = curdesc->next())
 			if (!(curdesc->flags & OPFLAG_VIRTUAL_NOOP))
 			{
-				base = m_direct->read_decrypted_ptr(curdesc->physpc);
+				base = curdesc->opbase;
 				assert(base != NULL);
 				UML_LOAD(block, I1, base, 0, SIZE_DWORD, SCALE_x4);     // load    i1,base,dword
 				UML_ADD(block, I0, I0, I1);                         // add     i0,i0,i1
@@ -1125,7 +1173,7 @@ void mips3_device::generate_checksum_block(drcuml_block *block, compiler_state *
 
 				if (curdesc->delay.first() != NULL && (curdesc == seqlast || (curdesc->next() != NULL && curdesc->next()->physpc != curdesc->delay.first()->physpc)))
 				{
-					base = m_direct->read_decrypted_ptr(curdesc->delay.first()->physpc);
+					base = curdesc->delay.first()->opbase;
 					assert(base != NULL);
 					UML_LOAD(block, I1, base, 0, SIZE_DWORD, SCALE_x4); // load    i1,base,dword
 					UML_ADD(block, I0, I0, I1);                     // add     i0,i0,i1
@@ -1292,14 +1340,14 @@ void mips3_device::generate_delay_slot_and_branch(drcuml_block *block, compiler_
 		if (desc->flags & OPFLAG_INTRABLOCK_BRANCH)
 			UML_JMP(block, desc->targetpc | 0x80000000);                            // jmp     desc->targetpc | 0x80000000
 		else
-			UML_HASHJMP(block, m_core->mode, desc->targetpc, *m_nocode);
+			UML_HASHJMP(block, m_compile_mode, desc->targetpc, *m_nocode);
 																					// hashjmp <mode>,desc->targetpc,nocode
 	}
 	else
 	{
 		generate_update_cycles(block, &compiler_temp, mem(&m_core->jmpdest), TRUE);
 																					// <subtract cycles>
-		UML_HASHJMP(block, m_core->mode, mem(&m_core->jmpdest), *m_nocode);
+		UML_HASHJMP(block, m_compile_mode, mem(&m_core->jmpdest), *m_nocode);
 																					// hashjmp <mode>,<rsreg>,nocode
 	}
 
@@ -1460,7 +1508,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x20:  /* LB - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read8[m_core->mode >> 1]);  // callh   read8
+			UML_CALLH(block, *m_read8[m_compile_mode >> 1]);  // callh   read8
 			if (RTREG != 0)
 				UML_DSEXT(block, R64(RTREG), I0, SIZE_BYTE);                        // dsext   <rtreg>,i0,byte
 			if (!in_delay_slot)
@@ -1469,7 +1517,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x21:  /* LH - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read16[m_core->mode >> 1]); // callh   read16
+			UML_CALLH(block, *m_read16[m_compile_mode >> 1]); // callh   read16
 			if (RTREG != 0)
 				UML_DSEXT(block, R64(RTREG), I0, SIZE_WORD);                        // dsext   <rtreg>,i0,word
 			if (!in_delay_slot)
@@ -1478,7 +1526,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x23:  /* LW - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read32[m_core->mode >> 1]); // callh   read32
+			UML_CALLH(block, *m_read32[m_compile_mode >> 1]); // callh   read32
 			if (RTREG != 0)
 				UML_DSEXT(block, R64(RTREG), I0, SIZE_DWORD);                       // dsext   <rtreg>,i0
 			if (!in_delay_slot)
@@ -1487,7 +1535,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x30:  /* LL - MIPS II */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read32[m_core->mode >> 1]); // callh   read32
+			UML_CALLH(block, *m_read32[m_compile_mode >> 1]); // callh   read32
 			if (RTREG != 0)
 				UML_DSEXT(block, R64(RTREG), I0, SIZE_DWORD);                       // dsext   <rtreg>,i0
 			UML_MOV(block, mem(&m_core->llbit), 1);                              // mov     [llbit],1
@@ -1497,7 +1545,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x24:  /* LBU - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read8[m_core->mode >> 1]);  // callh   read8
+			UML_CALLH(block, *m_read8[m_compile_mode >> 1]);  // callh   read8
 			if (RTREG != 0)
 				UML_DAND(block, R64(RTREG), I0, 0xff);                  // dand    <rtreg>,i0,0xff
 			if (!in_delay_slot)
@@ -1506,7 +1554,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x25:  /* LHU - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read16[m_core->mode >> 1]); // callh   read16
+			UML_CALLH(block, *m_read16[m_compile_mode >> 1]); // callh   read16
 			if (RTREG != 0)
 				UML_DAND(block, R64(RTREG), I0, 0xffff);                    // dand    <rtreg>,i0,0xffff
 			if (!in_delay_slot)
@@ -1515,7 +1563,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x27:  /* LWU - MIPS III */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read32[m_core->mode >> 1]); // callh   read32
+			UML_CALLH(block, *m_read32[m_compile_mode >> 1]); // callh   read32
 			if (RTREG != 0)
 				UML_DAND(block, R64(RTREG), I0, 0xffffffff);                // dand    <rtreg>,i0,0xffffffff
 			if (!in_delay_slot)
@@ -1524,7 +1572,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x37:  /* LD - MIPS III */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read64[m_core->mode >> 1]); // callh   read64
+			UML_CALLH(block, *m_read64[m_compile_mode >> 1]); // callh   read64
 			if (RTREG != 0)
 				UML_DMOV(block, R64(RTREG), I0);                                // dmov    <rtreg>,i0
 			if (!in_delay_slot)
@@ -1533,7 +1581,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x34:  /* LLD - MIPS III */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read64[m_core->mode >> 1]); // callh   read64
+			UML_CALLH(block, *m_read64[m_compile_mode >> 1]); // callh   read64
 			if (RTREG != 0)
 				UML_DMOV(block, R64(RTREG), I0);                                // dmov    <rtreg>,i0
 			UML_MOV(block, mem(&m_core->llbit), 1);                              // mov     [llbit],1
@@ -1548,7 +1596,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			if (!m_bigendian)
 				UML_XOR(block, I1, I1, 0x18);                       // xor     i1,i1,0x18
 			UML_SHR(block, I2, ~0, I1);                             // shr     i2,~0,i1
-			UML_CALLH(block, *m_read32mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_read32mask[m_compile_mode >> 1]);
 																					// callh   read32mask
 			if (RTREG != 0)
 			{
@@ -1568,7 +1616,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			if (m_bigendian)
 				UML_XOR(block, I1, I1, 0x18);                       // xor     i1,i1,0x18
 			UML_SHL(block, I2, ~0, I1);                             // shl     i2,~0,i1
-			UML_CALLH(block, *m_read32mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_read32mask[m_compile_mode >> 1]);
 																					// callh   read32mask
 			if (RTREG != 0)
 			{
@@ -1589,7 +1637,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			if (!m_bigendian)
 				UML_XOR(block, I1, I1, 0x38);                       // xor     i1,i1,0x38
 			UML_DSHR(block, I2, (UINT64)~0, I1);                        // dshr    i2,~0,i1
-			UML_CALLH(block, *m_read64mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_read64mask[m_compile_mode >> 1]);
 																					// callh   read64mask
 			if (RTREG != 0)
 			{
@@ -1607,7 +1655,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			if (m_bigendian)
 				UML_XOR(block, I1, I1, 0x38);                       // xor     i1,i1,0x38
 			UML_DSHL(block, I2, (UINT64)~0, I1);                        // dshl    i2,~0,i1
-			UML_CALLH(block, *m_read64mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_read64mask[m_compile_mode >> 1]);
 																					// callh   read64mask
 			if (RTREG != 0)
 			{
@@ -1622,7 +1670,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x31:  /* LWC1 - MIPS I */
 			check_cop1_access(block);
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read32[m_core->mode >> 1]); // callh   read32
+			UML_CALLH(block, *m_read32[m_compile_mode >> 1]); // callh   read32
 			UML_MOV(block, FPR32(RTREG), I0);                                   // mov     <cpr1_rt>,i0
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1631,7 +1679,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x35:  /* LDC1 - MIPS III */
 			check_cop1_access(block);
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read64[m_core->mode >> 1]); // callh   read64
+			UML_CALLH(block, *m_read64[m_compile_mode >> 1]); // callh   read64
 			UML_DMOV(block, FPR64(RTREG), I0);                                  // dmov    <cpr1_rt>,i0
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1639,7 +1687,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x32:  /* LWC2 - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read32[m_core->mode >> 1]); // callh   read32
+			UML_CALLH(block, *m_read32[m_compile_mode >> 1]); // callh   read32
 			UML_DAND(block, CPR264(RTREG), I0, 0xffffffff);             // dand    <cpr2_rt>,i0,0xffffffff
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1647,7 +1695,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 
 		case 0x36:  /* LDC2 - MIPS II */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
-			UML_CALLH(block, *m_read64[m_core->mode >> 1]); // callh   read64
+			UML_CALLH(block, *m_read64[m_compile_mode >> 1]); // callh   read64
 			UML_DMOV(block, CPR264(RTREG), I0);                             // dmov    <cpr2_rt>,i0
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1659,7 +1707,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x28:  /* SB - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_MOV(block, I1, R32(RTREG));                                 // mov     i1,<rtreg>
-			UML_CALLH(block, *m_write8[m_core->mode >> 1]); // callh   write8
+			UML_CALLH(block, *m_write8[m_compile_mode >> 1]); // callh   write8
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1667,7 +1715,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x29:  /* SH - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_MOV(block, I1, R32(RTREG));                                 // mov     i1,<rtreg>
-			UML_CALLH(block, *m_write16[m_core->mode >> 1]);    // callh   write16
+			UML_CALLH(block, *m_write16[m_compile_mode >> 1]);    // callh   write16
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1675,7 +1723,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x2b:  /* SW - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_MOV(block, I1, R32(RTREG));                                 // mov     i1,<rtreg>
-			UML_CALLH(block, *m_write32[m_core->mode >> 1]);    // callh   write32
+			UML_CALLH(block, *m_write32[m_compile_mode >> 1]);    // callh   write32
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1685,7 +1733,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			UML_JMPc(block, COND_E, skip = compiler->labelnum++);                       // je      skip
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_MOV(block, I1, R32(RTREG));                                 // mov     i1,<rtreg>
-			UML_CALLH(block, *m_write32[m_core->mode >> 1]);    // callh   write32
+			UML_CALLH(block, *m_write32[m_compile_mode >> 1]);    // callh   write32
 			UML_LABEL(block, skip);                                             // skip:
 			UML_DSEXT(block, R64(RTREG), mem(&m_core->llbit), SIZE_DWORD);               // dsext   <rtreg>,[llbit],dword
 			if (!in_delay_slot)
@@ -1695,7 +1743,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x3f:  /* SD - MIPS III */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_DMOV(block, I1, R64(RTREG));                                    // dmov    i1,<rtreg>
-			UML_CALLH(block, *m_write64[m_core->mode >> 1]);    // callh   write64
+			UML_CALLH(block, *m_write64[m_compile_mode >> 1]);    // callh   write64
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1705,7 +1753,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			UML_JMPc(block, COND_E, skip = compiler->labelnum++);                       // je      skip
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_DMOV(block, I1, R64(RTREG));                                    // dmov    i1,<rtreg>
-			UML_CALLH(block, *m_write64[m_core->mode >> 1]);    // callh   write64
+			UML_CALLH(block, *m_write64[m_compile_mode >> 1]);    // callh   write64
 			UML_LABEL(block, skip);                                             // skip:
 			UML_DSEXT(block, R64(RTREG), mem(&m_core->llbit), SIZE_DWORD);               // dsext   <rtreg>,[llbit],dword
 			if (!in_delay_slot)
@@ -1721,7 +1769,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 				UML_XOR(block, I3, I3, 0x18);                       // xor     i3,i3,0x18
 			UML_SHR(block, I2, ~0, I3);                             // shr     i2,~0,i3
 			UML_SHR(block, I1, I1, I3);                             // shr     i1,i1,i3
-			UML_CALLH(block, *m_write32mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_write32mask[m_compile_mode >> 1]);
 																					// callh   write32mask
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1736,7 +1784,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 				UML_XOR(block, I3, I3, 0x18);                       // xor     i3,i3,0x18
 			UML_SHL(block, I2, ~0, I3);                             // shl     i2,~0,i3
 			UML_SHL(block, I1, I1, I3);                             // shl     i1,i1,i3
-			UML_CALLH(block, *m_write32mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_write32mask[m_compile_mode >> 1]);
 																					// callh   write32mask
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1751,7 +1799,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 				UML_XOR(block, I3, I3, 0x38);                       // xor     i3,i3,0x38
 			UML_DSHR(block, I2, (UINT64)~0, I3);                        // dshr    i2,~0,i3
 			UML_DSHR(block, I1, I1, I3);                                // dshr    i1,i1,i3
-			UML_CALLH(block, *m_write64mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_write64mask[m_compile_mode >> 1]);
 																					// callh   write64mask
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1766,7 +1814,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 				UML_XOR(block, I3, I3, 0x38);                       // xor     i3,i3,0x38
 			UML_DSHL(block, I2, (UINT64)~0, I3);                        // dshl    i2,~0,i3
 			UML_DSHL(block, I1, I1, I3);                                // dshl    i1,i1,i3
-			UML_CALLH(block, *m_write64mask[m_core->mode >> 1]);
+			UML_CALLH(block, *m_write64mask[m_compile_mode >> 1]);
 																					// callh   write64mask
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -1776,7 +1824,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			check_cop1_access(block);
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_MOV(block, I1, FPR32(RTREG));                                   // mov     i1,<cpr1_rt>
-			UML_CALLH(block, *m_write32[m_core->mode >> 1]);    // callh   write32
+			UML_CALLH(block, *m_write32[m_compile_mode >> 1]);    // callh   write32
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1785,7 +1833,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 			check_cop1_access(block);
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_DMOV(block, I1, FPR64(RTREG));                                  // dmov    i1,<cpr1_rt>
-			UML_CALLH(block, *m_write64[m_core->mode >> 1]);    // callh   write64
+			UML_CALLH(block, *m_write64[m_compile_mode >> 1]);    // callh   write64
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1793,7 +1841,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x3a:  /* SWC2 - MIPS I */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_MOV(block, I1, CPR232(RTREG));                                  // mov     i1,<cpr2_rt>
-			UML_CALLH(block, *m_write32[m_core->mode >> 1]);    // callh   write32
+			UML_CALLH(block, *m_write32[m_compile_mode >> 1]);    // callh   write32
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -1801,7 +1849,7 @@ int mips3_device::generate_opcode(drcuml_block *block, compiler_state *compiler,
 		case 0x3e:  /* SDC2 - MIPS II */
 			UML_ADD(block, I0, R32(RSREG), SIMMVAL);                        // add     i0,<rsreg>,SIMMVAL
 			UML_DMOV(block, I1, CPR264(RTREG));                             // dmov    i1,<cpr2_rt>
-			UML_CALLH(block, *m_write64[m_core->mode >> 1]);    // callh   write64
+			UML_CALLH(block, *m_write64[m_compile_mode >> 1]);    // callh   write64
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -2495,7 +2543,7 @@ void mips3_device::generate_badcop(drcuml_block *block, const int cop)
 
 void mips3_device::check_cop0_access(drcuml_block *block)
 {
-	if ((m_core->mode >> 1) != MODE_KERNEL)
+	if ((m_compile_mode >> 1) != MODE_KERNEL)
 	{
 		generate_badcop(block, 0);
 	}
@@ -2512,7 +2560,7 @@ int mips3_device::generate_cop0(drcuml_block *block, compiler_state *compiler, c
 	int skip;
 
 	/* generate an exception if COP0 is disabled unless we are in kernel mode */
-	if ((m_core->mode >> 1) != MODE_KERNEL)
+	if ((m_compile_mode >> 1) != MODE_KERNEL)
 	{
 		UML_TEST(block, CPR032(COP0_Status), SR_COP0);                          // test    [Status],SR_COP0
 		UML_EXHc(block, COND_Z, *m_exception[EXCEPTION_BADCOP], 0);// exh     cop,0,Z
@@ -3037,7 +3085,7 @@ int mips3_device::generate_cop1x(drcuml_block *block, compiler_state *compiler,
 	{
 		case 0x00:      /* LWXC1 - MIPS IV */
 			UML_ADD(block, I0, R32(RSREG), R32(RTREG));                     // add     i0,<rsreg>,<rtreg>
-			UML_CALLH(block, *m_read32[m_core->mode >> 1]); // callh   read32
+			UML_CALLH(block, *m_read32[m_compile_mode >> 1]); // callh   read32
 			UML_MOV(block, FPR32(FDREG), I0);                                   // mov     <cpr1_fd>,i0
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -3045,7 +3093,7 @@ int mips3_device::generate_cop1x(drcuml_block *block, compiler_state *compiler,
 
 		case 0x01:      /* LDXC1 - MIPS IV */
 			UML_ADD(block, I0, R32(RSREG), R32(RTREG));                     // add     i0,<rsreg>,<rtreg>
-			UML_CALLH(block, *m_read64[m_core->mode >> 1]); // callh   read64
+			UML_CALLH(block, *m_read64[m_compile_mode >> 1]); // callh   read64
 			UML_DMOV(block, FPR64(FDREG), I0);                                  // dmov    <cpr1_fd>,i0
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
@@ -3054,7 +3102,7 @@ int mips3_device::generate_cop1x(drcuml_block *block, compiler_state *compiler,
 		case 0x08:      /* SWXC1 - MIPS IV */
 			UML_ADD(block, I0, R32(RSREG), R32(RTREG));                     // add     i0,<rsreg>,<rtreg>
 			UML_MOV(block, I1, FPR32(FSREG));                                   // mov     i1,<cpr1_fs>
-			UML_CALLH(block, *m_write32[m_core->mode >> 1]);    // callh   write32
+			UML_CALLH(block, *m_write32[m_compile_mode >> 1]);    // callh   write32
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
@@ -3062,7 +3110,7 @@ int mips3_device::generate_cop1x(drcuml_block *block, compiler_state *compiler,
 		case 0x09:      /* SDXC1 - MIPS IV */
 			UML_ADD(block, I0, R32(RSREG), R32(RTREG));                     // add     i0,<rsreg>,<rtreg>
 			UML_DMOV(block, I1, FPR64(FSREG));                                  // dmov    i1,<cpr1_fs>
-			UML_CALLH(block, *m_write64[m_core->mode >> 1]);    // callh   write64
+			UML_CALLH(block, *m_write64[m_compile_mode >> 1]);    // callh   write64
 			if (!in_delay_slot)
 				generate_update_cycles(block, compiler, desc->pc + 4, TRUE);
 			return TRUE;
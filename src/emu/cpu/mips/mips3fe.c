@@ -44,12 +44,14 @@ bool mips3_frontend::describe(opcode_desc &desc, const opcode_desc *prev)
 		// uh-oh: a page fault; leave the description empty and just if this is the first instruction, leave it empty and
 		// mark as needing to validate; otherwise, just end the sequence here
 		desc.flags |= OPFLAG_VALIDATE_TLB | OPFLAG_CAN_CAUSE_EXCEPTION | OPFLAG_COMPILER_PAGE_FAULT | OPFLAG_VIRTUAL_NOOP | OPFLAG_END_SEQUENCE;
+		desc.opbase = m_mips3->m_direct->read_decrypted_ptr(desc.physpc);
 		return true;
 	}
 
 	// fetch the opcode
 	assert((desc.physpc & 3) == 0);
 	op = desc.opptr.l[0] = m_mips3->m_direct->read_decrypted_dword(desc.physpc);
+	desc.opbase = m_mips3->m_direct->read_decrypted_ptr(desc.physpc);
 
 	// all instructions are 4 bytes and default to a single cycle each
 	desc.length = 4;
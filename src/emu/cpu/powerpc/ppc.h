@@ -18,6 +18,7 @@
 #include "cpu/vtlb.h"
 #include "cpu/drcfe.h"
 #include "cpu/drcuml.h"
+#include "cpu/drcpcache.h"
 #include "cpu/drcumlsh.h"
 
 
@@ -538,6 +539,7 @@ protected:
 	drc_cache           m_cache;                      /* pointer to the DRC code cache */
 	drcuml_state *      m_drcuml;                     /* DRC UML generator state */
 	ppc_frontend *      m_drcfe;                      /* pointer to the DRC front-end state */
+	drc_persistent_cache *m_drcpcache;                /* pointer to the persistent block list */
 	UINT32              m_drcoptions;                 /* configurable DRC options */
 
 	/* parameters for subroutines */
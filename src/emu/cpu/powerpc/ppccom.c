@@ -220,6 +220,7 @@ ppc_device::ppc_device(const machine_config &mconfig, device_type type, const ch
 	, m_cache(CACHE_SIZE + sizeof(internal_ppc_state))
 	, m_drcuml(NULL)
 	, m_drcfe(NULL)
+	, m_drcpcache(NULL)
 	, m_drcoptions(0)
 {
 	m_program_config.m_logaddr_width = 32;
@@ -930,6 +931,10 @@ void ppc_device::device_start()
 	/* initialize the front-end helper */
 	m_drcfe = auto_alloc(machine(), ppc_frontend(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE));
 
+	/* if requested, remember compiled blocks across runs */
+	if (machine().options().drc_cache())
+		m_drcpcache = auto_alloc(machine(), drc_persistent_cache(*this, *m_drcuml));
+
 	/* compute the register parameters */
 	for (int regnum = 0; regnum < 32; regnum++)
 	{
@@ -1153,6 +1158,8 @@ void ppc_device::device_stop()
 	m_vtlb = NULL;
 
 	/* clean up the DRC */
+	if (m_drcpcache != NULL)
+		auto_free(machine(), m_drcpcache);
 	auto_free(machine(), m_drcfe);
 	auto_free(machine(), m_drcuml);
 }
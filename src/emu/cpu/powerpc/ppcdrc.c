@@ -208,9 +208,17 @@ void ppc_device::execute_run()
 {
 	int execute_result;
 
-	/* reset the cache if dirty */
+	/* reset the cache if dirty, and precompile any remembered blocks */
 	if (m_cache_dirty)
+	{
 		code_flush_cache();
+		if (m_drcpcache != NULL)
+			m_drcpcache->precompile(drc_precompile_delegate(FUNC(ppc_device::code_compile_block), this));
+	}
+
+	/* once code in RAM turns up, try the remembered blocks that didn't match again */
+	else if (m_drcpcache != NULL && m_drcpcache->retry_pending())
+		m_drcpcache->retry(drc_precompile_delegate(FUNC(ppc_device::code_compile_block), this));
 	m_cache_dirty = FALSE;
 
 	/* execute */
@@ -371,6 +379,13 @@ void ppc_device::code_compile_block(UINT8 mode, offs_t pc)
 	if (m_drcuml->logging() || m_drcuml->logging_native())
 		log_opcode_desc(m_drcuml, desclist, 0);
 
+	/* when precompiling, skip blocks whose code has changed since they were recorded */
+	if (m_drcpcache != NULL && !m_drcpcache->block_described(mode, pc, desclist))
+	{
+		g_profiler.stop();
+		return;
+	}
+
 	bool succeeded = false;
 	while (!succeeded)
 	{
@@ -448,6 +463,8 @@ void ppc_device::code_compile_block(UINT8 mode, offs_t pc)
 
 			/* end the sequence */
 			block->end();
+			if (m_drcpcache != NULL)
+				m_drcpcache->block_compiled();
 			g_profiler.stop();
 			succeeded = true;
 		}
@@ -169,6 +169,8 @@ sh2_device::sh2_device(const machine_config &mconfig, const char *tag, device_t
 	, m_drcuml(NULL)
 //  , m_drcuml(*this, m_cache, 0, 1, 32, 1)
 	, m_drcfe(NULL)
+	, m_drcpcache(NULL)
+	, m_drcasync(NULL)
 	, m_drcoptions(0)
 	, m_sh2_state(NULL)
 	, m_entry(NULL)
@@ -190,6 +192,14 @@ sh2_device::sh2_device(const machine_config &mconfig, const char *tag, device_t
 void sh2_device::device_stop()
 {
 	/* clean up the DRC */
+	if ( m_drcasync )
+	{
+		auto_free(machine(), m_drcasync);
+	}
+	if ( m_drcpcache )
+	{
+		auto_free(machine(), m_drcpcache);
+	}
 	if ( m_drcuml )
 	{
 		auto_free(machine(), m_drcuml);
@@ -206,6 +216,8 @@ sh2_device::sh2_device(const machine_config &mconfig, device_type type, const ch
 	, m_drcuml(NULL)
 //  , m_drcuml(*this, m_cache, 0, 1, 32, 1)
 	, m_drcfe(NULL)
+	, m_drcpcache(NULL)
+	, m_drcasync(NULL)
 	, m_drcoptions(0)
 	, m_sh2_state(NULL)
 	, m_entry(NULL)
@@ -2343,6 +2355,13 @@ void sh2_device::execute_run()
 	}
 #endif
 
+	execute_interpreted();
+}
+
+
+/* Interpret until out of cycles; when standing in for the recompiler, stop as soon as there is compiled code for the current PC */
+void sh2_device::execute_interpreted()
+{
 	do
 	{
 		UINT32 opcode;
@@ -2381,15 +2400,50 @@ void sh2_device::execute_run()
 		default: op1111(opcode); break;
 		}
 
-		if(m_test_irq && !m_delay)
+		/* when standing in for the recompiler, take interrupts the way its code does */
+		if (m_isdrc)
+		{
+			if (!m_delay)
+				check_pending_irq_drc();
+		}
+		else if(m_test_irq && !m_delay)
 		{
 			CHECK_PENDING_IRQ("mame_sh2_execute");
 			m_test_irq = 0;
 		}
 		m_sh2_state->icount--;
+
+		/* hand back to the recompiler once it has caught up, but never in a delay slot */
+		if (m_drcasync != NULL && !m_delay && m_drcuml->hash_exists(0, m_sh2_state->pc))
+			break;
 	} while( m_sh2_state->icount > 0 );
 }
 
+/* Take any pending NMI or interrupt while interpreting in place of the recompiler; this mirrors the check in the recompiled code */
+void sh2_device::check_pending_irq_drc()
+{
+	/* an NMI has already set up evec */
+	if (m_sh2_state->pending_nmi)
+		m_sh2_state->pending_nmi = 0;
+	else
+	{
+		m_sh2_state->evec = 0xffffffff;
+		if (m_sh2_state->pending_irq != 0 || m_sh2_state->internal_irq_level != -1)
+			CHECK_PENDING_IRQ("sh2_interpreted");
+	}
+
+	/* push SR and PC, then go to the handler */
+	if (m_sh2_state->evec != 0xffffffff)
+	{
+		m_sh2_state->r[15] -= 4;
+		WL( m_sh2_state->r[15], m_sh2_state->irqsr );
+		m_sh2_state->r[15] -= 4;
+		WL( m_sh2_state->r[15], m_sh2_state->pc );
+		m_sh2_state->pc = m_sh2_state->evec;
+		m_sh2_state->evec = 0xffffffff;
+	}
+}
+
 void sh2_device::device_start()
 {
 	/* allocate the implementation-specific state from the full cache */
@@ -2579,6 +2633,18 @@ void sh2_device::device_start()
 	/* initialize the front-end helper */
 	m_drcfe = auto_alloc(machine(), sh2_frontend(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE));
 
+	/* if requested, remember compiled blocks across runs */
+	if (machine().options().drc_cache())
+		m_drcpcache = auto_alloc(machine(), drc_persistent_cache(*this, *m_drcuml));
+
+	/* if requested, compile in the background and interpret until the code is ready */
+	if (m_isdrc && machine().options().drc_async_compile())
+	{
+		m_drcasync = auto_alloc(machine(), drc_async_compiler(*this, *m_drcuml, drc_describe_delegate(FUNC(sh2_device::code_describe_block), this), drc_generate_delegate(FUNC(sh2_device::code_generate_block), this)));
+		for (int slot = 0; slot < drc_async_compiler::MAX_PENDING; slot++)
+			m_drcasync->set_frontend(slot, *auto_alloc(machine(), sh2_frontend(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE)));
+	}
+
 	/* compute the register parameters */
 	for (int regnum = 0; regnum < 16; regnum++)
 	{
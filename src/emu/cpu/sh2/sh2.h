@@ -32,6 +32,8 @@
 
 #include "cpu/drcfe.h"
 #include "cpu/drcuml.h"
+#include "cpu/drcpcache.h"
+#include "cpu/drcasync.h"
 
 
 #define SH2_INT_NONE    -1
@@ -246,6 +248,8 @@ private:
 	drc_cache           m_cache;                  /* pointer to the DRC code cache */
 	drcuml_state *      m_drcuml;                 /* DRC UML generator state */
 	sh2_frontend *      m_drcfe;                  /* pointer to the DRC front-end state */
+	drc_persistent_cache *m_drcpcache;            /* pointer to the persistent block list */
+	drc_async_compiler *m_drcasync;               /* pointer to the background compiler */
 	UINT32              m_drcoptions;         /* configurable DRC options */
 
 	internal_sh2_state *m_sh2_state;
@@ -474,7 +478,11 @@ private:
 
 	void code_flush_cache();
 	void execute_run_drc();
+	void execute_interpreted();
+	void check_pending_irq_drc();
 	void code_compile_block(UINT8 mode, offs_t pc);
+	const opcode_desc *code_describe_block(drc_frontend &frontend, UINT8 mode, offs_t pc);
+	void code_generate_block(UINT8 mode, offs_t pc, const opcode_desc *desclist);
 	void static_generate_entry_point();
 	void static_generate_nocode_handler();
 	void static_generate_out_of_cycles();
@@ -587,6 +587,10 @@ void sh2_device::code_flush_cache()
 {
 	drcuml_state *drcuml = m_drcuml;
 
+	/* nothing can be compiling in the background while we do this */
+	if (m_drcasync != NULL)
+		m_drcasync->reset();
+
 	/* empty the transient cache contents */
 	drcuml->reset();
 
@@ -631,9 +635,21 @@ void sh2_device::execute_run_drc()
 	}
 #endif
 
-	/* reset the cache if dirty */
+	/* reset the cache if dirty, and precompile any remembered blocks */
 	if (m_cache_dirty)
+	{
 		code_flush_cache();
+		if (m_drcpcache != NULL)
+			m_drcpcache->precompile(drc_precompile_delegate(FUNC(sh2_device::code_compile_block), this));
+	}
+
+	/* once code in RAM turns up, try the remembered blocks that didn't match again */
+	else if (m_drcpcache != NULL && m_drcpcache->retry_pending())
+	{
+		if (m_drcasync != NULL)
+			m_drcasync->wait();
+		m_drcpcache->retry(drc_precompile_delegate(FUNC(sh2_device::code_compile_block), this));
+	}
 
 	/* execute */
 	do
@@ -641,10 +657,18 @@ void sh2_device::execute_run_drc()
 		/* run as much as we can */
 		execute_result = drcuml->execute(*m_entry);
 
-		/* if we need to recompile, do it */
+		/* if we need to recompile, do it, in the background if we can */
 		if (execute_result == EXECUTE_MISSING_CODE)
 		{
-			code_compile_block(0, m_sh2_state->pc);
+			if (m_drcasync != NULL && m_drcasync->request(0, m_sh2_state->pc))
+			{
+				/* interpret until the code shows up */
+				execute_interpreted();
+				if (m_sh2_state->icount <= 0)
+					execute_result = EXECUTE_OUT_OF_CYCLES;
+			}
+			else
+				code_compile_block(0, m_sh2_state->pc);
 		}
 		else if (execute_result == EXECUTE_UNMAPPED_CODE)
 		{
@@ -654,6 +678,10 @@ void sh2_device::execute_run_drc()
 		{
 			code_flush_cache();
 		}
+
+		/* a background compile that ran out of space leaves the flush to us */
+		if (m_drcasync != NULL && m_drcasync->flush_needed())
+			code_flush_cache();
 	} while (execute_result != EXECUTE_OUT_OF_CYCLES);
 }
 
@@ -663,18 +691,52 @@ void sh2_device::execute_run_drc()
 -------------------------------------------------*/
 
 void sh2_device::code_compile_block(UINT8 mode, offs_t pc)
+{
+	g_profiler.start(PROFILER_DRC_COMPILE);
+
+	/* get a description of this sequence and generate code for it */
+	const opcode_desc *desclist = code_describe_block(*m_drcfe, mode, pc);
+	if (desclist != NULL)
+		code_generate_block(mode, pc, desclist);
+
+	g_profiler.stop();
+}
+
+
+/*-------------------------------------------------
+    code_describe_block - describe a block of the
+    given mode at the specified pc; this touches
+    memory, so it must run on the emulation thread
+-------------------------------------------------*/
+
+const opcode_desc *sh2_device::code_describe_block(drc_frontend &frontend, UINT8 mode, offs_t pc)
+{
+	const opcode_desc *desclist = frontend.describe_code(pc);
+
+	/* when precompiling, skip blocks whose code has changed since they were recorded */
+	if (m_drcpcache != NULL && !m_drcpcache->block_described(mode, pc, desclist))
+		return NULL;
+	return desclist;
+}
+
+
+/*-------------------------------------------------
+    code_generate_block - generate code for a
+    described block; this may run on the
+    background compiler's thread
+-------------------------------------------------*/
+
+void sh2_device::code_generate_block(UINT8 mode, offs_t pc, const opcode_desc *desclist)
 {
 	drcuml_state *drcuml = m_drcuml;
 	compiler_state compiler = { 0 };
 	const opcode_desc *seqhead, *seqlast;
-	const opcode_desc *desclist;
 	int override = FALSE;
 	drcuml_block *block;
 
-	g_profiler.start(PROFILER_DRC_COMPILE);
+	/* only the emulation thread may flush the cache */
+	bool foreground = (m_drcasync == NULL || !m_drcasync->in_background());
 
-	/* get a description of this sequence */
-	desclist = m_drcfe->describe_code(pc);
 	if (drcuml->logging() || drcuml->logging_native())
 		log_opcode_desc(drcuml, desclist, 0);
 
@@ -724,7 +786,7 @@ void sh2_device::code_compile_block(UINT8 mode, offs_t pc)
 				}
 
 				/* validate this code block if we're not pointing into ROM */
-				if (m_program->get_write_ptr(seqhead->physpc) != NULL)
+				if (seqhead->flags & OPFLAG_WRITEABLE_CODE)
 					generate_checksum_block(block, &compiler, seqhead, seqlast);
 
 				/* label this instruction, if it may be jumped to locally */
@@ -763,11 +825,18 @@ void sh2_device::code_compile_block(UINT8 mode, offs_t pc)
 
 			/* end the sequence */
 			block->end();
-			g_profiler.stop();
+			if (m_drcpcache != NULL && foreground)
+				m_drcpcache->block_compiled();
 			succeeded = true;
 		}
 		catch (drcuml_block::abort_compilation &)
 		{
+			/* the running code may live in the cache, so only the emulation thread can flush it */
+			if (!foreground)
+			{
+				m_drcasync->cache_full();
+				return;
+			}
 			code_flush_cache();
 		}
 	}
@@ -1309,7 +1378,7 @@ void sh2_device::generate_checksum_block(drcuml_block *block, compiler_state *co
 	{
 		if (!(seqhead->flags & OPFLAG_VIRTUAL_NOOP))
 		{
-			void *base = m_direct->read_decrypted_ptr(seqhead->physpc, SH2_CODE_XOR(0));
+			void *base = seqhead->opbase;
 			UML_LOAD(block, I0, base, 0, SIZE_WORD, SCALE_x2);                          // load    i0,base,word
 			UML_CMP(block, I0, seqhead->opptr.w[0]);                        // cmp     i0,*opptr
 			UML_EXHc(block, COND_NE, *m_nocode, epc(seqhead));       // exne    nocode,seqhead->pc
@@ -1323,20 +1392,20 @@ void sh2_device::generate_checksum_block(drcuml_block *block, compiler_state *co
 		for (curdesc = seqhead->next(); curdesc != seqlast->next(); curdesc = curdesc->next())
 			if (!(curdesc->flags & OPFLAG_VIRTUAL_NOOP))
 			{
-				base = m_direct->read_decrypted_ptr(curdesc->physpc, SH2_CODE_XOR(0));
+				base = curdesc->opbase;
 				UML_LOAD(block, I0, curdesc->opptr.w, 0, SIZE_WORD, SCALE_x2);          // load    i0,*opptr,0,word
 				UML_CMP(block, I0, curdesc->opptr.w[0]);                    // cmp     i0,*opptr
 				UML_EXHc(block, COND_NE, *m_nocode, epc(seqhead));   // exne    nocode,seqhead->pc
 			}
 #else
 		UINT32 sum = 0;
-		void *base = m_direct->read_decrypted_ptr(seqhead->physpc, SH2_CODE_XOR(0));
+		void *base = seqhead->opbase;
 		UML_LOAD(block, I0, base, 0, SIZE_WORD, SCALE_x4);                              // load    i0,base,word
 		sum += seqhead->opptr.w[0];
 		for (curdesc = seqhead->next(); curdesc != seqlast->next(); curdesc = curdesc->next())
 			if (!(curdesc->flags & OPFLAG_VIRTUAL_NOOP))
 			{
-				base = m_direct->read_decrypted_ptr(curdesc->physpc, SH2_CODE_XOR(0));
+				base = curdesc->opbase;
 				UML_LOAD(block, I1, base, 0, SIZE_WORD, SCALE_x2);                      // load    i1,*opptr,word
 				UML_ADD(block, I0, I0, I1);                         // add     i0,i0,i1
 				sum += curdesc->opptr.w[0];
@@ -850,6 +850,70 @@ UINT8 uml::instruction::modified_flags() const
 }
 
 
+//-------------------------------------------------
+//  param_is_input_only - return true if the given
+//  parameter is only read by the instruction
+//-------------------------------------------------
+
+bool uml::instruction::param_is_input_only(int paramnum) const
+{
+	assert(paramnum < m_numparams);
+	return (s_opcode_info_table[m_opcode].param[paramnum].output == PIO_IN);
+}
+
+
+//-------------------------------------------------
+//  param_is_output - return true if the given
+//  parameter is written by the instruction
+//-------------------------------------------------
+
+bool uml::instruction::param_is_output(int paramnum) const
+{
+	assert(paramnum < m_numparams);
+	return ((s_opcode_info_table[m_opcode].param[paramnum].output & PIO_OUT) != 0);
+}
+
+
+//-------------------------------------------------
+//  param_accepts - return true if the given
+//  parameter may legally be of the given type
+//-------------------------------------------------
+
+bool uml::instruction::param_accepts(int paramnum, parameter::parameter_type type) const
+{
+	assert(paramnum < m_numparams);
+	return ((s_opcode_info_table[m_opcode].param[paramnum].typemask >> type) & 1);
+}
+
+
+//-------------------------------------------------
+//  param_size - return the size in bytes of the
+//  data accessed through the given parameter
+//-------------------------------------------------
+
+UINT8 uml::instruction::param_size(int paramnum) const
+{
+	assert(paramnum < m_numparams);
+	UINT8 psize = s_opcode_info_table[m_opcode].param[paramnum].size;
+
+	// sized by the instruction
+	if (psize == PSIZE_OP)
+		return m_size;
+
+	// sized by another parameter; fall back to the instruction size if it's not there
+	if (psize & 0x80)
+	{
+		int sizenum = psize - PSIZE_P1;
+		if (sizenum < m_numparams && m_param[sizenum].is_size())
+			return 1 << m_param[sizenum].size();
+		return m_size;
+	}
+
+	// fixed size
+	return 1 << psize;
+}
+
+
 //-------------------------------------------------
 //  disasm - disassemble an instruction to the
 //  given buffer
@@ -407,12 +407,17 @@ namespace uml
 		// setters
 		void set_flags(UINT8 flags) { m_flags = flags; }
 		void set_mapvar(int paramnum, UINT32 value) { assert(paramnum < m_numparams); assert(m_param[paramnum].is_mapvar()); m_param[paramnum] = value; }
+		void set_param(int paramnum, const parameter &param) { assert(paramnum < m_numparams); assert(param_accepts(paramnum, param.type())); m_param[paramnum] = param; }
 
 		// misc
 		const char *disasm(astring &string, drcuml_state *drcuml = NULL) const;
 		UINT8 input_flags() const;
 		UINT8 output_flags() const;
 		UINT8 modified_flags() const;
+		bool param_is_input_only(int paramnum) const;
+		bool param_is_output(int paramnum) const;
+		bool param_accepts(int paramnum, parameter::parameter_type type) const;
+		UINT8 param_size(int paramnum) const;
 		void simplify();
 
 		// compile-time opcodes
@@ -44,10 +44,12 @@ const int TRIGGER_SUSPENDTIME   = -4000;
 device_execute_interface::device_execute_interface(const machine_config &mconfig, device_t &device)
 	: device_interface(device, "execute"),
 		m_disabled(false),
+		m_parallel_group(0),
 		m_vblank_interrupt_screen(NULL),
 		m_timed_interrupt_period(attotime::zero),
 		m_is_octal(false),
 		m_nextexec(NULL),
+		m_parallel(false),
 		m_timedint_timer(NULL),
 		m_profiler(PROFILER_IDLE),
 		m_icountptr(NULL),
@@ -60,6 +62,7 @@ device_execute_interface::device_execute_interface(const machine_config &mconfig
 		m_trigger(0),
 		m_inttrigger(0),
 		m_totalcycles(0),
+		m_exec_ticks(0),
 		m_divisor(0),
 		m_divshift(0),
 		m_cycles_per_second(0),
@@ -95,6 +98,22 @@ void device_execute_interface::static_set_disable(device_t &device)
 }
 
 
+//-------------------------------------------------
+//  static_set_parallel_group - configuration
+//  helper to mark a device as loosely coupled;
+//  devices in different non-zero groups may run
+//  concurrently within a timeslice
+//-------------------------------------------------
+
+void device_execute_interface::static_set_parallel_group(device_t &device, int group)
+{
+	device_execute_interface *exec;
+	if (!device.interface(exec))
+		throw emu_fatalerror("MCFG_DEVICE_PARALLEL_GROUP called on device '%s' with no execute interface", device.tag());
+	exec->m_parallel_group = group;
+}
+
+
 //-------------------------------------------------
 //  static_set_vblank_int - configuration helper
 //  to set up VBLANK interrupts on the device
@@ -240,9 +259,11 @@ void device_execute_interface::suspend(UINT32 reason, bool eatcycles)
 {
 if (TEMPLOG) printf("suspend %s (%X)\n", device().tag(), reason);
 	// set the suspend reason and eat cycles flag
+	m_scheduler->parallel_lock();
 	m_nextsuspend |= reason;
 	m_nexteatcycles = eatcycles;
 	suspend_resume_changed();
+	m_scheduler->parallel_unlock();
 }
 
 
@@ -255,8 +276,10 @@ void device_execute_interface::resume(UINT32 reason)
 {
 if (TEMPLOG) printf("resume %s (%X)\n", device().tag(), reason);
 	// clear the suspend reason and eat cycles flag
+	m_scheduler->parallel_lock();
 	m_nextsuspend &= ~reason;
 	suspend_resume_changed();
+	m_scheduler->parallel_unlock();
 }
 
 
@@ -286,10 +309,12 @@ void device_execute_interface::spin_until_time(const attotime &duration)
 void device_execute_interface::suspend_until_trigger(int trigid, bool eatcycles)
 {
 	// suspend the device immediately if it's not already
+	m_scheduler->parallel_lock();
 	suspend(SUSPEND_REASON_TRIGGER, eatcycles);
 
 	// set the trigger
 	m_trigger = trigid;
+	m_scheduler->parallel_unlock();
 }
 
 
@@ -303,11 +328,13 @@ void device_execute_interface::trigger(int trigid)
 	abort_timeslice();
 
 	// see if this is a matching trigger
+	m_scheduler->parallel_lock();
 	if ((m_nextsuspend & SUSPEND_REASON_TRIGGER) != 0 && m_trigger == trigid)
 	{
 		resume(SUSPEND_REASON_TRIGGER);
 		m_trigger = 0;
 	}
+	m_scheduler->parallel_unlock();
 }
 
 
@@ -480,7 +507,7 @@ void device_execute_interface::interface_pre_start()
 	device_iterator iter(device().machine().root_device());
 	int index = iter.indexof(*this);
 	m_suspend = SUSPEND_REASON_RESET;
-	m_profiler = profile_type(index + PROFILER_DEVICE_FIRST);
+	m_profiler = g_profiler.scope(astring("'", device().tag(), "'"));
 	m_inttrigger = index + TRIGGER_INT;
 
 	// allocate timers if we need them
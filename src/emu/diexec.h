@@ -87,6 +87,8 @@ enum
 
 #define MCFG_DEVICE_DISABLE() \
 	device_execute_interface::static_set_disable(*device);
+#define MCFG_DEVICE_PARALLEL_GROUP(_group) \
+	device_execute_interface::static_set_parallel_group(*device, _group);
 #define MCFG_DEVICE_VBLANK_INT_DRIVER(_tag, _class, _func) \
 	device_execute_interface::static_set_vblank_int(*device, device_interrupt_delegate(&_class::_func, #_class "::" #_func, DEVICE_SELF, (_class *)0), _tag);
 #define MCFG_DEVICE_VBLANK_INT_DEVICE(_tag, _devtag, _class, _func) \
@@ -138,6 +140,7 @@ public:
 
 	// configuration access
 	bool disabled() const { return m_disabled; }
+	int parallel_group() const { return m_parallel_group; }
 	UINT64 clocks_to_cycles(UINT64 clocks) const { return execute_clocks_to_cycles(clocks); }
 	UINT64 cycles_to_clocks(UINT64 cycles) const { return execute_cycles_to_clocks(cycles); }
 	UINT32 min_cycles() const { return execute_min_cycles(); }
@@ -150,6 +153,7 @@ public:
 
 	// static inline configuration helpers
 	static void static_set_disable(device_t &device);
+	static void static_set_parallel_group(device_t &device, int group);
 	static void static_set_vblank_int(device_t &device, device_interrupt_delegate function, const char *tag, int rate = 0);
 	static void static_set_periodic_int(device_t &device, device_interrupt_delegate function, const attotime &rate);
 	static void static_set_irq_acknowledge_callback(device_t &device, device_irq_acknowledge_delegate callback);
@@ -186,6 +190,7 @@ public:
 	// time and cycle accounting
 	attotime local_time() const;
 	UINT64 total_cycles() const;
+	osd_ticks_t execution_ticks() const { return m_exec_ticks; }
 
 	// required operation overrides
 	void run() { execute_run(); }
@@ -259,6 +264,7 @@ protected:
 
 	// configuration
 	bool                    m_disabled;                 // disabled from executing?
+	int                     m_parallel_group;           // group that may run on its own thread (0 = never)
 	device_interrupt_delegate m_vblank_interrupt;       // for interrupts tied to VBLANK
 	const char *            m_vblank_interrupt_screen;  // the screen that causes the VBLANK interrupt
 	device_interrupt_delegate m_timed_interrupt;        // for interrupts not tied to VBLANK
@@ -267,6 +273,7 @@ protected:
 
 	// execution lists
 	device_execute_interface *m_nextexec;               // pointer to the next device to execute, in order
+	bool                    m_parallel;                 // true if the scheduler runs us on another thread
 
 	// input states and IRQ callbacks
 	device_irq_acknowledge_delegate m_driver_irq;       // driver-specific IRQ callback
@@ -289,6 +296,7 @@ protected:
 
 	// clock and timing information
 	UINT64                  m_totalcycles;              // total device cycles executed
+	osd_ticks_t             m_exec_ticks;               // wall-clock time spent executing, if the scheduler is timing
 	attotime                m_localtime;                // local time, relative to the timer system's global time
 	INT32                   m_divisor;                  // 32-bit attoseconds_per_cycle divisor
 	UINT8                   m_divshift;                 // right shift amount to fit the divisor into 32 bits
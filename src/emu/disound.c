@@ -460,12 +460,8 @@ void device_mixer_interface::sound_stream_update(sound_stream &stream, stream_sa
 	for (int output = 0; output < m_outputs; output++)
 		memset(outputs[output], 0, samples * sizeof(outputs[0][0]));
 
-	// loop over samples
+	// add each input in turn to the appropriate output
 	const UINT8 *outmap = &m_outputmap[0];
-	for (int pos = 0; pos < samples; pos++)
-	{
-		// for each input, add it to the appropriate output
-		for (int inp = 0; inp < m_auto_allocated_inputs; inp++)
-			outputs[outmap[inp]][pos] += inputs[inp][pos];
-	}
+	for (int inp = 0; inp < m_auto_allocated_inputs; inp++)
+		stream_add_samples(outputs[outmap[inp]], inputs[inp], samples);
 }
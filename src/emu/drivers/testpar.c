@@ -0,0 +1,185 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/*************************************************************************
+
+    testpar.c
+
+    Example driver for exercising parallel CPU groups.
+
+    Three Z80s each run the same loop out of their own RAM. Two of them
+    are put in parallel groups of their own, and the third stays on the
+    main thread. Every time a CPU's byte counter wraps it bumps a second
+    counter and writes to an I/O port, whose handler synchronizes to
+    report it. After ten seconds the reports are checked against the
+    counters and the CPUs' local times against the scheduler, and the
+    driver exits. Run it with and without -parallel_execute.
+
+**************************************************************************/
+
+
+#include "emu.h"
+#include "cpu/z80/z80.h"
+
+
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+#define CPU_COUNT       3
+#define COUNTER_BASE    0x1000
+
+
+
+//**************************************************************************
+//  DRIVER STATE
+//**************************************************************************
+
+class testpar_state : public driver_device
+{
+public:
+	// constructor
+	testpar_state(const machine_config &mconfig, device_type type, const char *tag)
+		: driver_device(mconfig, type, tag),
+			m_maincpu(*this, "maincpu"),
+			m_cpu1(*this, "cpu1"),
+			m_cpu2(*this, "cpu2")
+	{
+	}
+
+	// timer callback; check the results and bail
+	virtual void device_timer(emu_timer &timer, device_timer_id id, int param, void *ptr)
+	{
+		bool failed = false;
+		attotime now = machine().time();
+		attotime slice = attotime::from_hz(60);
+
+		for (int cpunum = 0; cpunum < CPU_COUNT; cpunum++)
+		{
+			cpu_device &cpu = *m_cpu[cpunum];
+			UINT8 wraps = cpu.space(AS_PROGRAM).read_byte(COUNTER_BASE + 1);
+
+			// the last report may still be waiting to be synchronized
+			bool counted = (UINT8(m_reports[cpunum]) == wraps || UINT8(m_reports[cpunum] + 1) == wraps);
+
+			// and nobody may have run more than a timeslice past everyone else
+			attotime local = cpu.local_time();
+			bool intime = (local >= now && local - now <= slice);
+
+			printf("%-8s: %10" I64FMT "d cycles, %6d reports, counter %02X, %s%s\n", cpu.tag(), cpu.total_cycles(), m_reports[cpunum], wraps,
+					counted ? "" : "reports lost ", intime ? "" : "out of step");
+			if (!counted || !intime)
+				failed = true;
+		}
+
+		// all done; just bail
+		throw emu_fatalerror(failed ? MAMERR_FATALERROR : 0, failed ? "Failed" : "All done");
+	}
+
+	// startup code; load the program into each CPU and set a timer to check the results
+	virtual void machine_start()
+	{
+		static const UINT8 program[] =
+		{
+			0x21, 0x00, 0x10,   // ld   hl,$1000
+			0x34,               // inc  (hl)
+			0x20, 0xfd,         // jr   nz,$0003
+			0x23,               // inc  hl
+			0x34,               // inc  (hl)
+			0x2b,               // dec  hl
+			0xd3, 0x00,         // out  ($00),a
+			0x18, 0xf6          // jr   $0003
+		};
+
+		m_cpu[0] = m_maincpu;
+		m_cpu[1] = m_cpu1;
+		m_cpu[2] = m_cpu2;
+		for (int cpunum = 0; cpunum < CPU_COUNT; cpunum++)
+		{
+			address_space &space = m_cpu[cpunum]->space(AS_PROGRAM);
+			for (int bytenum = 0; bytenum < ARRAY_LENGTH(program); bytenum++)
+				space.write_byte(bytenum, program[bytenum]);
+			m_reports[cpunum] = 0;
+		}
+
+		timer_set(attotime::from_seconds(10));
+	}
+
+	// a counter wrapped; report it to the main thread
+	WRITE8_MEMBER( report_w )
+	{
+		for (int cpunum = 0; cpunum < CPU_COUNT; cpunum++)
+			if (&space.device() == m_cpu[cpunum])
+				machine().scheduler().synchronize(timer_expired_delegate(FUNC(testpar_state::report_sync), this), cpunum);
+	}
+
+	// count a report
+	TIMER_CALLBACK_MEMBER( report_sync )
+	{
+		m_reports[param]++;
+	}
+
+private:
+	// internal state
+	required_device<cpu_device> m_maincpu;
+	required_device<cpu_device> m_cpu1;
+	required_device<cpu_device> m_cpu2;
+	cpu_device *m_cpu[CPU_COUNT];
+	int m_reports[CPU_COUNT];
+};
+
+
+
+//**************************************************************************
+//  ADDRESS MAPS
+//**************************************************************************
+
+static ADDRESS_MAP_START( z80_mem, AS_PROGRAM, 8, testpar_state )
+	AM_RANGE(0x0000, 0x1fff) AM_RAM
+ADDRESS_MAP_END
+
+static ADDRESS_MAP_START( z80_io, AS_IO, 8, testpar_state )
+	ADDRESS_MAP_GLOBAL_MASK(0xff)
+	AM_RANGE(0x00, 0x00) AM_WRITE(report_w)
+ADDRESS_MAP_END
+
+
+
+//**************************************************************************
+//  MACHINE DRIVERS
+//**************************************************************************
+
+static MACHINE_CONFIG_START( testpar, testpar_state )
+
+	// CPUs
+	MCFG_CPU_ADD("maincpu", Z80, 4000000)
+	MCFG_CPU_PROGRAM_MAP(z80_mem)
+	MCFG_CPU_IO_MAP(z80_io)
+
+	MCFG_CPU_ADD("cpu1", Z80, 4000000)
+	MCFG_CPU_PROGRAM_MAP(z80_mem)
+	MCFG_CPU_IO_MAP(z80_io)
+	MCFG_DEVICE_PARALLEL_GROUP(1)
+
+	MCFG_CPU_ADD("cpu2", Z80, 4000000)
+	MCFG_CPU_PROGRAM_MAP(z80_mem)
+	MCFG_CPU_IO_MAP(z80_io)
+	MCFG_DEVICE_PARALLEL_GROUP(2)
+MACHINE_CONFIG_END
+
+
+
+//**************************************************************************
+//  ROM DEFINITIONS
+//**************************************************************************
+
+ROM_START( testpar )
+	ROM_REGION( 0x10, "user1", ROMREGION_ERASEFF )
+ROM_END
+
+
+
+//**************************************************************************
+//  GAME DRIVERS
+//**************************************************************************
+
+GAME( 2014, testpar, 0, testpar, 0, driver_device, 0, ROT0, "MAME", "Parallel CPU Group Tester", GAME_NO_SOUND )
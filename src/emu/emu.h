@@ -33,6 +33,7 @@
 #include "attotime.h"
 #include "hash.h"
 #include "fileio.h" // remove me once NVRAM is implemented as device
+#include "hashcache.h"
 #include "delegate.h"
 #include "devdelegate.h"
 
@@ -101,6 +102,7 @@ typedef device_t * (*machine_config_constructor)(machine_config &config, device_
 #include "mame.h"
 #include "machine.h"
 #include "driver.h"
+#include "benchmark.h"
 
 // video-related
 #include "drawgfx.h"
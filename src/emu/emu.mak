@@ -53,6 +53,7 @@ EMUOBJS = \
 	$(EMUOBJ)/addrmap.o \
 	$(EMUOBJ)/attotime.o \
 	$(EMUOBJ)/audit.o \
+	$(EMUOBJ)/benchmark.o \
 	$(EMUOBJ)/cheat.o \
 	$(EMUOBJ)/clifront.o \
 	$(EMUOBJ)/cliopts.o \
@@ -88,6 +89,7 @@ EMUOBJS = \
 	$(EMUOBJ)/emupal.o \
 	$(EMUOBJ)/fileio.o \
 	$(EMUOBJ)/hash.o \
+	$(EMUOBJ)/hashcache.o \
 	$(EMUOBJ)/image.o \
 	$(EMUOBJ)/info.o \
 	$(EMUOBJ)/input.o \
@@ -164,6 +166,7 @@ EMUSOUNDOBJS = \
 EMUDRIVEROBJS = \
 	$(EMUDRIVERS)/empty.o \
 	$(EMUDRIVERS)/testcpu.o \
+	$(EMUDRIVERS)/testpar.o \
 
 EMUMACHINEOBJS = \
 	$(EMUMACHINE)/bcreader.o    \
@@ -52,11 +52,14 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_SNAPSHOT_DIRECTORY,                         "snap",      OPTION_STRING,     "directory to save screenshots" },
 	{ OPTION_DIFF_DIRECTORY,                             "diff",      OPTION_STRING,     "directory to save hard drive image difference files" },
 	{ OPTION_COMMENT_DIRECTORY,                          "comments",  OPTION_STRING,     "directory to save debugger comments" },
+	{ OPTION_DRC_CACHE_DIRECTORY,                        "drc",       OPTION_STRING,     "directory to save DRC block lists" },
 
 	// state/playback options
 	{ NULL,                                              NULL,        OPTION_HEADER,     "CORE STATE/PLAYBACK OPTIONS" },
 	{ OPTION_STATE,                                      NULL,        OPTION_STRING,     "saved state to load" },
 	{ OPTION_AUTOSAVE,                                   "0",         OPTION_BOOLEAN,    "enable automatic restore at startup, and automatic save at exit time" },
+	{ OPTION_REWIND_SECONDS,                             "0",         OPTION_INTEGER,    "number of seconds of in-memory snapshots to keep for rewinding; 0 disables rewind" },
+	{ OPTION_REWIND_MEMORY "(1-4095)",                   "64",        OPTION_INTEGER,    "maximum amount of memory, in megabytes, to use for rewind snapshots" },
 	{ OPTION_PLAYBACK ";pb",                             NULL,        OPTION_STRING,     "playback an input file" },
 	{ OPTION_RECORD ";rec",                              NULL,        OPTION_STRING,     "record an input file" },
 	{ OPTION_MNGWRITE,                                   NULL,        OPTION_STRING,     "optional filename to write a MNG movie of the current session" },
@@ -74,10 +77,16 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_AUTOFRAMESKIP ";afs",                       "0",         OPTION_BOOLEAN,    "enable automatic frameskip selection" },
 	{ OPTION_FRAMESKIP ";fs(0-10)",                      "0",         OPTION_INTEGER,    "set frameskip to fixed value, 0-10 (autoframeskip must be disabled)" },
 	{ OPTION_SECONDS_TO_RUN ";str",                      "0",         OPTION_INTEGER,    "number of emulated seconds to run before automatically exiting" },
+	{ OPTION_BENCH_FRAMES,                               "0",         OPTION_INTEGER,    "benchmark for the given number of emulated frames, recording per-frame timings; implies -video none -sound none -nothrottle" },
+	{ OPTION_BENCH_OUTPUT,                               NULL,        OPTION_STRING,     "file to write per-frame benchmark timings to; JSON if it ends in .json, CSV otherwise" },
+	{ OPTION_PROFILER_OUTPUT,                            NULL,        OPTION_STRING,     "profile the whole run and write the profiler's call tree to the given file on exit" },
 	{ OPTION_THROTTLE,                                   "1",         OPTION_BOOLEAN,    "enable throttling to keep game running in sync with real time" },
 	{ OPTION_SLEEP,                                      "1",         OPTION_BOOLEAN,    "enable sleeping, which gives time back to other applications when idle" },
 	{ OPTION_SPEED "(0.01-100)",                         "1.0",       OPTION_FLOAT,      "controls the speed of gameplay, relative to realtime; smaller numbers are slower" },
 	{ OPTION_REFRESHSPEED ";rs",                         "0",         OPTION_BOOLEAN,    "automatically adjusts the speed of gameplay to keep the refresh rate lower than the screen" },
+	{ OPTION_PARALLEL_EXECUTE,                           "0",         OPTION_BOOLEAN,    "run CPUs the driver marks as loosely coupled on separate threads within each timeslice" },
+	{ OPTION_ADAPTIVE_QUANTUM,                           "0",         OPTION_BOOLEAN,    "widen the scheduling quantum while CPUs are not interacting, narrowing it again as soon as they do" },
+	{ OPTION_MEM_FLAT_BITS "(0-24)",                     "20",        OPTION_INTEGER,    "address spaces up to this many bits wide (in bytes) use a single-level lookup table" },
 
 	// rotation options
 	{ NULL,                                              NULL,        OPTION_HEADER,     "CORE ROTATION OPTIONS" },
@@ -115,6 +124,9 @@ const options_entry emu_options::s_option_entries[] =
 	// sound options
 	{ NULL,                                              NULL,        OPTION_HEADER,     "CORE SOUND OPTIONS" },
 	{ OPTION_SAMPLERATE ";sr(1000-1000000)",             "48000",     OPTION_INTEGER,    "set sound output sample rate" },
+	{ OPTION_RESAMPLE_QUALITY "(0-1)",                   "0",         OPTION_INTEGER,    "sample rate conversion between sound streams: 0 = linear, 1 = band-limited" },
+	{ OPTION_PARALLEL_SOUND,                             "0",         OPTION_BOOLEAN,    "update independent sound streams on multiple threads (experimental)" },
+	{ OPTION_DISCRETE_FUSED,                             "1",         OPTION_BOOLEAN,    "evaluate simple discrete sound nodes inline instead of through each node" },
 	{ OPTION_SAMPLES,                                    "1",         OPTION_BOOLEAN,    "enable the use of external samples if available" },
 	{ OPTION_VOLUME ";vol",                              "0",         OPTION_INTEGER,    "sound volume in decibels (-32 min, 0 max)" },
 
@@ -163,6 +175,15 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_DRC_USE_C,                                  "0",         OPTION_BOOLEAN,    "force DRC use C backend" },
 	{ OPTION_DRC_LOG_UML,                                "0",         OPTION_BOOLEAN,    "write DRC UML disassembly log" },
 	{ OPTION_DRC_LOG_NATIVE,                             "0",         OPTION_BOOLEAN,    "write DRC native disassembly log" },
+	{ OPTION_DRC_CACHE,                                  "0",         OPTION_BOOLEAN,    "remember compiled DRC blocks and precompile them at startup" },
+	{ OPTION_DRC_EVICT_REGIONS,                          "0",         OPTION_INTEGER,    "retire DRC code in this many regions instead of flushing the whole cache (0 = disabled)" },
+	{ OPTION_DRC_ASYNC_COMPILE,                          "0",         OPTION_BOOLEAN,    "compile DRC code on a background thread, interpreting until it is ready" },
+	{ OPTION_DRC_OPTIMIZE,                               "all",       OPTION_STRING,     "comma-separated list of UML optimization passes to run (flags, memory, const, all or none)" },
+	{ OPTION_HASH_CACHE,                                 NULL,        OPTION_STRING,     "file to remember verified ROM hashes in, so unchanged files are not hashed again" },
+	{ OPTION_REHASH,                                     "0",         OPTION_BOOLEAN,    "ignore the hash cache and hash every ROM file again, updating the cache" },
+	{ OPTION_MAP_ROMS,                                   "0",         OPTION_BOOLEAN,    "map uncompressed ROM files that fill a whole region into memory instead of reading them" },
+	{ OPTION_CHD_CACHE,                                  "64",        OPTION_INTEGER,    "number of decompressed hunks to keep in memory for each CHD (0 = disabled)" },
+	{ OPTION_CHD_READAHEAD,                              "8",         OPTION_INTEGER,    "number of hunks to decompress ahead of sequential CHD reads (0 = disabled)" },
 	{ OPTION_BIOS,                                       NULL,        OPTION_STRING,     "select the system BIOS to use" },
 	{ OPTION_CHEAT ";c",                                 "0",         OPTION_BOOLEAN,    "enable cheat subsystem" },
 	{ OPTION_SKIP_GAMEINFO,                              "0",         OPTION_BOOLEAN,    "skip displaying the information screen at startup" },
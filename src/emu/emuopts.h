@@ -65,10 +65,13 @@ enum
 #define OPTION_SNAPSHOT_DIRECTORY   "snapshot_directory"
 #define OPTION_DIFF_DIRECTORY       "diff_directory"
 #define OPTION_COMMENT_DIRECTORY    "comment_directory"
+#define OPTION_DRC_CACHE_DIRECTORY  "drc_cache_directory"
 
 // core state/playback options
 #define OPTION_STATE                "state"
 #define OPTION_AUTOSAVE             "autosave"
+#define OPTION_REWIND_SECONDS       "rewind_seconds"
+#define OPTION_REWIND_MEMORY        "rewind_memory"
 #define OPTION_PLAYBACK             "playback"
 #define OPTION_RECORD               "record"
 #define OPTION_MNGWRITE             "mngwrite"
@@ -85,10 +88,16 @@ enum
 #define OPTION_AUTOFRAMESKIP        "autoframeskip"
 #define OPTION_FRAMESKIP            "frameskip"
 #define OPTION_SECONDS_TO_RUN       "seconds_to_run"
+#define OPTION_BENCH_FRAMES         "bench_frames"
+#define OPTION_BENCH_OUTPUT         "bench_output"
+#define OPTION_PROFILER_OUTPUT      "profiler_output"
 #define OPTION_THROTTLE             "throttle"
 #define OPTION_SLEEP                "sleep"
 #define OPTION_SPEED                "speed"
 #define OPTION_REFRESHSPEED         "refreshspeed"
+#define OPTION_PARALLEL_EXECUTE     "parallel_execute"
+#define OPTION_ADAPTIVE_QUANTUM     "adaptive_quantum"
+#define OPTION_MEM_FLAT_BITS        "mem_flat_bits"
 
 // core rotation options
 #define OPTION_ROTATE               "rotate"
@@ -121,6 +130,9 @@ enum
 
 // core sound options
 #define OPTION_SAMPLERATE           "samplerate"
+#define OPTION_RESAMPLE_QUALITY     "resample_quality"
+#define OPTION_PARALLEL_SOUND       "parallel_sound"
+#define OPTION_DISCRETE_FUSED       "discrete_fused"
 #define OPTION_SAMPLES              "samples"
 #define OPTION_VOLUME               "volume"
 
@@ -165,6 +177,15 @@ enum
 #define OPTION_DRC_USE_C            "drc_use_c"
 #define OPTION_DRC_LOG_UML          "drc_log_uml"
 #define OPTION_DRC_LOG_NATIVE       "drc_log_native"
+#define OPTION_DRC_CACHE            "drc_cache"
+#define OPTION_DRC_EVICT_REGIONS    "drc_evict_regions"
+#define OPTION_DRC_ASYNC_COMPILE    "drc_async_compile"
+#define OPTION_DRC_OPTIMIZE         "drc_optimize"
+#define OPTION_HASH_CACHE           "hash_cache"
+#define OPTION_REHASH               "rehash"
+#define OPTION_MAP_ROMS             "map_roms"
+#define OPTION_CHD_CACHE            "chd_cache"
+#define OPTION_CHD_READAHEAD        "chd_readahead"
 #define OPTION_BIOS                 "bios"
 #define OPTION_CHEAT                "cheat"
 #define OPTION_SKIP_GAMEINFO        "skip_gameinfo"
@@ -233,10 +254,13 @@ public:
 	const char *snapshot_directory() const { return value(OPTION_SNAPSHOT_DIRECTORY); }
 	const char *diff_directory() const { return value(OPTION_DIFF_DIRECTORY); }
 	const char *comment_directory() const { return value(OPTION_COMMENT_DIRECTORY); }
+	const char *drc_cache_directory() const { return value(OPTION_DRC_CACHE_DIRECTORY); }
 
 	// core state/playback options
 	const char *state() const { return value(OPTION_STATE); }
 	bool autosave() const { return bool_value(OPTION_AUTOSAVE); }
+	int rewind_seconds() const { return int_value(OPTION_REWIND_SECONDS); }
+	int rewind_memory() const { return int_value(OPTION_REWIND_MEMORY); }
 	const char *playback() const { return value(OPTION_PLAYBACK); }
 	const char *record() const { return value(OPTION_RECORD); }
 	const char *mng_write() const { return value(OPTION_MNGWRITE); }
@@ -253,10 +277,16 @@ public:
 	bool auto_frameskip() const { return bool_value(OPTION_AUTOFRAMESKIP); }
 	int frameskip() const { return int_value(OPTION_FRAMESKIP); }
 	int seconds_to_run() const { return int_value(OPTION_SECONDS_TO_RUN); }
+	int bench_frames() const { return int_value(OPTION_BENCH_FRAMES); }
+	const char *bench_output() const { return value(OPTION_BENCH_OUTPUT); }
+	const char *profiler_output() const { return value(OPTION_PROFILER_OUTPUT); }
 	bool throttle() const { return bool_value(OPTION_THROTTLE); }
 	bool sleep() const { return bool_value(OPTION_SLEEP); }
 	float speed() const { return float_value(OPTION_SPEED); }
 	bool refresh_speed() const { return bool_value(OPTION_REFRESHSPEED); }
+	bool parallel_execute() const { return bool_value(OPTION_PARALLEL_EXECUTE); }
+	bool adaptive_quantum() const { return bool_value(OPTION_ADAPTIVE_QUANTUM); }
+	int mem_flat_bits() const { return int_value(OPTION_MEM_FLAT_BITS); }
 
 	// core rotation options
 	bool rotate() const { return bool_value(OPTION_ROTATE); }
@@ -289,6 +319,9 @@ public:
 
 	// core sound options
 	int sample_rate() const { return int_value(OPTION_SAMPLERATE); }
+	int resample_quality() const { return int_value(OPTION_RESAMPLE_QUALITY); }
+	bool parallel_sound() const { return bool_value(OPTION_PARALLEL_SOUND); }
+	bool discrete_fused() const { return bool_value(OPTION_DISCRETE_FUSED); }
 	bool samples() const { return bool_value(OPTION_SAMPLES); }
 	int volume() const { return int_value(OPTION_VOLUME); }
 
@@ -331,6 +364,15 @@ public:
 	bool drc_use_c() const { return bool_value(OPTION_DRC_USE_C); }
 	bool drc_log_uml() const { return bool_value(OPTION_DRC_LOG_UML); }
 	bool drc_log_native() const { return bool_value(OPTION_DRC_LOG_NATIVE); }
+	bool drc_cache() const { return bool_value(OPTION_DRC_CACHE); }
+	int drc_evict_regions() const { return int_value(OPTION_DRC_EVICT_REGIONS); }
+	bool drc_async_compile() const { return bool_value(OPTION_DRC_ASYNC_COMPILE); }
+	const char *drc_optimize() const { return value(OPTION_DRC_OPTIMIZE); }
+	const char *hash_cache() const { return value(OPTION_HASH_CACHE); }
+	bool rehash() const { return bool_value(OPTION_REHASH); }
+	bool map_roms() const { return bool_value(OPTION_MAP_ROMS); }
+	int chd_cache() const { return int_value(OPTION_CHD_CACHE); }
+	int chd_readahead() const { return int_value(OPTION_CHD_READAHEAD); }
 	const char *bios() const { return value(OPTION_BIOS); }
 	bool cheat() const { return bool_value(OPTION_CHEAT); }
 	bool skip_gameinfo() const { return bool_value(OPTION_SKIP_GAMEINFO); }
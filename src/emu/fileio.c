@@ -434,6 +434,67 @@ file_error emu_file::compress(int level)
 }
 
 
+//-------------------------------------------------
+//  preload - load the data of a file inside an
+//  archive now rather than on first access;
+//  returns false if it could not be loaded
+//-------------------------------------------------
+
+bool emu_file::preload()
+{
+	return !compressed_file_ready() && m_file != NULL;
+}
+
+
+//-------------------------------------------------
+//  preload_7z - load the data of several files
+//  from the same .7z at once, so that each solid
+//  block is decoded only once however the files
+//  are spread across the blocks; files that are
+//  not from that archive, or already loaded, are
+//  left alone
+//-------------------------------------------------
+
+void emu_file::preload_7z(emu_file **files, int count)
+{
+	// the first file still waiting for its data names the archive
+	_7z_file *archive = NULL;
+	for (int filenum = 0; filenum < count && archive == NULL; filenum++)
+		if (files[filenum] != NULL)
+			archive = files[filenum]->m__7zfile;
+	if (archive == NULL)
+		return;
+
+	// gather a request for each member of the same archive
+	dynamic_array<_7z_file_request> requests;
+	dynamic_array<emu_file *> members;
+	for (int filenum = 0; filenum < count; filenum++)
+	{
+		emu_file *file = files[filenum];
+		if (file == NULL || file->m__7zfile == NULL || strcmp(file->m__7zfile->filename, archive->filename) != 0)
+			continue;
+
+		file->m__7zdata.resize(file->m__7zlength);
+		_7z_file_request &request = requests.append();
+		request.index = file->m__7zfile->curr_file_idx;
+		request.buffer = file->m__7zdata;
+		request.length = file->m__7zdata.count();
+		request.error = _7ZERR_NONE;
+		members.append(file);
+	}
+
+	// decode them all through one handle
+	_7z_file_decompress_multiple(archive, requests, requests.count());
+
+	// hand the data over; anything that failed is left to fail again on first access
+	for (int filenum = 0; filenum < members.count(); filenum++)
+		if (requests[filenum].error == _7ZERR_NONE)
+			members[filenum]->attach__7zped_data();
+		else
+			members[filenum]->m__7zdata.reset();
+}
+
+
 //-------------------------------------------------
 //  compressed_file_ready - ensure our zip is ready
 //   loading if needed
@@ -893,7 +954,17 @@ file_error emu_file::load__7zped_file()
 		m__7zdata.reset();
 		return FILERR_FAILURE;
 	}
+	return attach__7zped_data();
+}
+
+
+//-------------------------------------------------
+//  attach__7zped_data - open the decompressed
+//  data as a RAM file and close the _7Z file
+//-------------------------------------------------
 
+file_error emu_file::attach__7zped_data()
+{
 	// convert to RAM file
 	file_error filerr = core_fopen_ram(m__7zdata, m__7zdata.count(), m_openflags, &m_file);
 	if (filerr != FILERR_NONE)
@@ -93,6 +93,8 @@ public:
 	operator core_file *();
 	operator core_file &();
 	bool is_open() const { return (m_file != NULL); }
+	bool from_zip() const { return (m_zipfile != NULL || m_zipdata.count() != 0); }
+	bool from_7z() const { return (m__7zfile != NULL || m__7zdata.count() != 0); }
 	const char *filename() const { return m_filename; }
 	const char *fullpath() const { return m_fullpath; }
 	UINT32 openflags() const { return m_openflags; }
@@ -104,6 +106,7 @@ public:
 	void remove_on_close() { m_remove_on_close = true; }
 	void set_openflags(UINT32 openflags) { assert(m_file == NULL); m_openflags = openflags; }
 	void set_restrict_to_mediapath(bool rtmp = true) { m_restrict_to_mediapath = rtmp; }
+	void set_hashes(const hash_collection &hashes) { m_hashes = hashes; }
 
 	// open/close
 	file_error open(const char *name);
@@ -120,6 +123,8 @@ public:
 
 	// control
 	file_error compress(int compress);
+	bool preload();
+	static void preload_7z(emu_file **files, int count);
 	int seek(INT64 offset, int whence);
 	UINT64 tell();
 	bool eof();
@@ -148,6 +153,7 @@ private:
 
 	file_error attempt__7zped();
 	file_error load__7zped_file();
+	file_error attach__7zped_data();
 
 	// internal state
 	astring         m_filename;                     // original filename provided
@@ -0,0 +1,302 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    hashcache.c
+
+    Persistent cache of verified ROM file hashes.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "emuopts.h"
+
+
+
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+// first line of the cache file; bump the number if the format changes
+static const char CACHE_HEADER[] = "# hash cache 1";
+
+
+
+//**************************************************************************
+//  GLOBAL VARIABLES
+//**************************************************************************
+
+hash_cache g_hash_cache;
+
+
+
+//**************************************************************************
+//  HASH CACHE
+//**************************************************************************
+
+//-------------------------------------------------
+//  hash_cache - constructor
+//-------------------------------------------------
+
+hash_cache::hash_cache()
+	: m_rehash(false),
+		m_dirty(false),
+		m_lock(NULL),
+		m_hits(0),
+		m_misses(0)
+{
+}
+
+
+//-------------------------------------------------
+//  ~hash_cache - destructor
+//-------------------------------------------------
+
+hash_cache::~hash_cache()
+{
+	if (m_lock != NULL)
+		osd_lock_free(m_lock);
+}
+
+
+//-------------------------------------------------
+//  configure - pick up the cache file and mode
+//  from the options, loading the file if it has
+//  changed
+//-------------------------------------------------
+
+void hash_cache::configure(emu_options &options)
+{
+	// allocate the lock before any worker can need it
+	if (m_lock == NULL)
+		m_lock = osd_lock_alloc();
+
+	m_rehash = options.rehash();
+
+	// nothing else to do if we already have this file
+	const char *path = options.hash_cache();
+	if (path == NULL)
+		path = "";
+	if (m_path == path)
+		return;
+
+	// write out the old one and start fresh
+	flush();
+	m_list.reset();
+	m_map.reset();
+	m_path.cpy(path);
+	load();
+}
+
+
+//-------------------------------------------------
+//  flush - write the cache out if anything has
+//  been added since it was read
+//-------------------------------------------------
+
+void hash_cache::flush()
+{
+	if (m_hits + m_misses != 0)
+		osd_printf_verbose("Hash cache: %d files from the cache, %d hashed\n", m_hits, m_misses);
+	m_hits = m_misses = 0;
+
+	if (!m_dirty || !m_path)
+		return;
+	m_dirty = false;
+
+	emu_file file(OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file.open(m_path) != FILERR_NONE)
+	{
+		osd_printf_warning("Unable to write hash cache '%s'\n", m_path.cstr());
+		return;
+	}
+
+	// one line per entry; the key goes last since paths may contain spaces
+	astring hashstr;
+	file.printf("%s\n", CACHE_HEADER);
+	for (cache_entry *entry = m_list.first(); entry != NULL; entry = entry->next())
+		file.printf("%" I64FMT "u\t%" I64FMT "u\t%" I64FMT "u\t%s\t%s\n", entry->m_size, entry->m_modified, entry->m_length, entry->m_hashes.internal_string(hashstr), entry->m_key.cstr());
+}
+
+
+//-------------------------------------------------
+//  hashes - return the requested hashes for a
+//  file, from the cache if they are there and
+//  still valid; if the caller already has the
+//  file's data in memory, it can pass it to be
+//  hashed instead of having the file read
+//-------------------------------------------------
+
+hash_collection &hash_cache::hashes(emu_file &file, const char *types, const UINT8 *data)
+{
+	// without a cache, or for files we can't identify, just hash them
+	astring key;
+	UINT64 size, modified;
+	if (!m_path || !identify(file, key, size, modified))
+	{
+		if (data != NULL)
+			compute(file, types, data);
+		return file.hashes(types);
+	}
+	UINT64 length = file.size();
+
+	// see if we know this file
+	bool complete = false;
+	osd_lock_acquire(m_lock);
+	cache_entry *entry = m_map.find(key);
+	if (entry != NULL && !m_rehash && entry->m_size == size && entry->m_modified == modified && entry->m_length == length)
+	{
+		// hand over what we have; the file computes anything that is missing
+		astring have;
+		entry->m_hashes.hash_types(have);
+		complete = true;
+		for (const char *scan = types; *scan != 0; scan++)
+			if (have.chr(0, *scan) == -1)
+				complete = false;
+		file.set_hashes(entry->m_hashes);
+	}
+	if (complete)
+		m_hits++;
+	else
+		m_misses++;
+	osd_lock_release(m_lock);
+
+	if (!complete && data != NULL)
+		compute(file, types, data);
+	hash_collection &result = file.hashes(types);
+	if (complete)
+		return result;
+
+	// remember what we computed
+	osd_lock_acquire(m_lock);
+	entry = m_map.find(key);
+	if (entry == NULL)
+	{
+		entry = &m_list.append(*global_alloc(cache_entry(key)));
+		m_map.add(key, entry);
+	}
+	entry->m_size = size;
+	entry->m_modified = modified;
+	entry->m_length = length;
+	entry->m_hashes = result;
+	m_dirty = true;
+	osd_lock_release(m_lock);
+	return result;
+}
+
+
+//-------------------------------------------------
+//  compute - hash data the caller already has
+//  and hand the result to the file
+//-------------------------------------------------
+
+void hash_cache::compute(emu_file &file, const char *types, const UINT8 *data)
+{
+	hash_collection computed;
+	computed.compute(data, file.size(), types);
+	file.set_hashes(computed);
+}
+
+
+//-------------------------------------------------
+//  identify - build the cache key for a file and
+//  find the size and time of what holds it on
+//  disk
+//-------------------------------------------------
+
+bool hash_cache::identify(emu_file &file, astring &key, UINT64 &size, UINT64 &modified)
+{
+	// find what is actually on disk; files in RAM have no path
+	astring path(file.fullpath());
+	if (file.from_zip())
+		path.cat(".zip");
+	else if (file.from_7z())
+		path.cat(".7z");
+	if (!path)
+		return false;
+
+	// use the absolute path, so the cache works from any directory
+	char *fullpath;
+	if (osd_get_full_path(&fullpath, path) != FILERR_NONE)
+		return false;
+	key.cpy(fullpath);
+	osd_free(fullpath);
+
+	// files without a modification time can't be checked, so don't cache them
+	osd_directory_entry *entry = osd_stat(key);
+	if (entry == NULL)
+		return false;
+	bool valid = (entry->type == ENTTYPE_FILE && entry->modified != 0);
+	size = entry->size;
+	modified = entry->modified;
+	osd_free(entry);
+	if (!valid)
+		return false;
+
+	// archive members are told apart by the CRC the archive stores for them
+	if (file.from_zip() || file.from_7z())
+	{
+		static const char crctype[] = { hash_collection::HASH_CRC, 0 };
+		UINT32 crc;
+		if (!file.hashes(crctype).crc(crc))
+			return false;
+		key.catprintf("|%08x", crc);
+	}
+	return true;
+}
+
+
+//-------------------------------------------------
+//  load - read the cache file
+//-------------------------------------------------
+
+void hash_cache::load()
+{
+	m_dirty = false;
+	if (!m_path)
+		return;
+
+	// a missing file is fine; we'll create it
+	emu_file file(OPEN_FLAG_READ);
+	if (file.open(m_path) != FILERR_NONE)
+		return;
+
+	// ignore the whole thing if it's from a different version
+	char buffer[4096];
+	if (file.gets(buffer, ARRAY_LENGTH(buffer)) == NULL || strncmp(buffer, CACHE_HEADER, strlen(CACHE_HEADER)) != 0)
+	{
+		osd_printf_verbose("Hash cache '%s' has an unknown format; rebuilding it\n", m_path.cstr());
+		return;
+	}
+
+	while (file.gets(buffer, ARRAY_LENGTH(buffer)) != NULL)
+	{
+		// chop the line ending
+		char *end = buffer + strlen(buffer);
+		while (end > buffer && (end[-1] == '\n' || end[-1] == '\r'))
+			*--end = 0;
+
+		// size, time and length, then the hashes and the key
+		UINT64 size, modified, length;
+		int consumed = 0;
+		if (sscanf(buffer, "%" I64FMT "u\t%" I64FMT "u\t%" I64FMT "u\t%n", &size, &modified, &length, &consumed) != 3 || consumed == 0)
+			continue;
+		char *hashstr = buffer + consumed;
+		char *key = strchr(hashstr, '\t');
+		if (key == NULL || key[1] == 0)
+			continue;
+		*key++ = 0;
+
+		hash_collection hashes;
+		if (!hashes.from_internal_string(hashstr) || m_map.find(key) != NULL)
+			continue;
+
+		cache_entry &entry = m_list.append(*global_alloc(cache_entry(key)));
+		entry.m_size = size;
+		entry.m_modified = modified;
+		entry.m_length = length;
+		entry.m_hashes = hashes;
+		m_map.add(key, &entry);
+	}
+	osd_printf_verbose("Hash cache: loaded %d entries from '%s'\n", m_list.count(), m_path.cstr());
+}
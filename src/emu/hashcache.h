@@ -0,0 +1,111 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    hashcache.h
+
+    Persistent cache of verified ROM file hashes.
+
+****************************************************************************
+
+    Computing the SHA1 of every ROM file is the bulk of the time spent
+    auditing a large set, and a good part of the time spent loading a
+    big system, even though most files never change between runs. When
+    -hash_cache names a file, the hashes computed by the auditor and the
+    ROM loader are remembered there, keyed on the file they came from:
+
+        - for a loose file, its full path
+        - for a file inside a .zip or .7z, the full path of the archive
+          plus the CRC the archive records for it
+
+    along with the size and modification time of the file or archive
+    on disk and the length of the data. An entry is only used while all
+    three still match, so replacing or touching a file or archive causes
+    it to be hashed again. With -rehash, cached hashes are ignored and
+    every file is hashed, but the results are still written back.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __EMU_H__
+#error Dont include this file directly; include emu.h instead.
+#endif
+
+#ifndef __HASHCACHE_H__
+#define __HASHCACHE_H__
+
+
+
+//**************************************************************************
+//  TYPE DEFINITIONS
+//**************************************************************************
+
+// forward references
+class emu_options;
+
+
+// ======================> hash_cache
+
+class hash_cache
+{
+	// a single cached file
+	class cache_entry
+	{
+		friend class simple_list<cache_entry>;
+
+	public:
+		cache_entry(const char *key)
+			: m_next(NULL),
+				m_key(key),
+				m_size(0),
+				m_modified(0),
+				m_length(0) { }
+
+		cache_entry *next() const { return m_next; }
+
+		cache_entry *       m_next;                 // next entry in the list
+		astring             m_key;                  // path, plus CRC for archive members
+		UINT64              m_size;                 // size of the file or archive on disk
+		UINT64              m_modified;             // its modification time
+		UINT64              m_length;               // length of the data
+		hash_collection     m_hashes;               // hashes of the data
+	};
+
+public:
+	// construction/destruction
+	hash_cache();
+	~hash_cache();
+
+	// configuration
+	void configure(emu_options &options);
+	void flush();
+
+	// hashing
+	hash_collection &hashes(emu_file &file, const char *types, const UINT8 *data = NULL);
+
+private:
+	// internal helpers
+	void compute(emu_file &file, const char *types, const UINT8 *data);
+	bool identify(emu_file &file, astring &key, UINT64 &size, UINT64 &modified);
+	void load();
+
+	// internal state
+	astring                     m_path;             // name of the cache file; empty if disabled
+	bool                        m_rehash;           // true to ignore cached hashes
+	bool                        m_dirty;            // true if there is anything new to write
+	osd_lock *                  m_lock;             // lock for worker threads
+	simple_list<cache_entry>    m_list;             // all entries, in file order
+	tagmap_t<cache_entry *, 4093> m_map;            // entries by key
+	int                         m_hits;             // lookups satisfied from the cache
+	int                         m_misses;           // lookups that had to hash the file
+};
+
+
+// ======================> globals
+
+// the cache shared by the auditor and the ROM loader
+extern hash_cache g_hash_cache;
+
+
+#endif  /* __HASHCACHE_H__ */
@@ -138,6 +138,8 @@ running_machine::running_machine(const machine_config &_config, machine_manager
 		m_saveload_schedule(SLS_NONE),
 		m_saveload_schedule_time(attotime::zero),
 		m_saveload_searchpath(NULL),
+		m_rewind_capture_pending(false),
+		m_rewind_schedule_frames(-1),
 
 		m_save(*this),
 		m_memory(*this),
@@ -299,6 +301,10 @@ void running_machine::start()
 	// set up the cheat engine
 	m_cheat.reset(global_alloc(cheat_manager(*this)));
 
+	// set up per-frame timing if we're benchmarking
+	if (options().bench_frames() > 0)
+		m_benchmark.reset(global_alloc(frame_benchmark(*this, options().bench_frames(), options().bench_output())));
+
 	// allocate autoboot timer
 	m_autoboot_timer = scheduler().timer_alloc(timer_expired_delegate(FUNC(running_machine::autoboot_callback), this));
 
@@ -358,6 +364,15 @@ int running_machine::run(bool firstrun)
 		// devices with timers.
 		m_save.allow_registration(false);
 
+		// now that the state is fixed, set up the rewind history
+		if (options().rewind_seconds() > 0)
+		{
+			// the rewinder takes a byte count, so it can't go past 4GB
+			UINT64 memory = MIN(UINT64(MAX(options().rewind_memory(), 1)) << 20, UINT64(0xffffffff));
+			m_rewind.reset(global_alloc(state_rewinder(m_save, attotime::from_seconds(options().rewind_seconds()), UINT32(memory))));
+			add_notifier(MACHINE_NOTIFY_FRAME, machine_notify_delegate(FUNC(running_machine::rewind_frame_update), this));
+		}
+
 		nvram_load();
 		sound().ui_mute(false);
 
@@ -379,6 +394,14 @@ int running_machine::run(bool firstrun)
 		if (m_saveload_schedule != SLS_NONE)
 			handle_saveload();
 
+		// profile the whole run if we're going to write it out
+		if (options().profiler_output()[0] != 0)
+		{
+			g_profiler.enable(true);
+			if (!g_profiler.enabled())
+				osd_printf_warning("-%s requires a build with the profiler enabled\n", OPTION_PROFILER_OUTPUT);
+		}
+
 		// run the CPUs until a reset or exit
 		m_hard_reset_pending = false;
 		while ((!m_hard_reset_pending && !m_exit_pending) || m_saveload_schedule != SLS_NONE)
@@ -404,12 +427,26 @@ int running_machine::run(bool firstrun)
 			if (m_saveload_schedule != SLS_NONE)
 				handle_saveload();
 
+			// handle rewind captures and restores
+			if (m_rewind_capture_pending || m_rewind_schedule_frames >= 0)
+				handle_rewind();
+
 			g_profiler.stop();
 		}
 
 		// and out via the exit phase
 		m_current_phase = MACHINE_PHASE_EXIT;
 
+		// write out the profile if requested
+		if (options().profiler_output()[0] != 0 && g_profiler.enabled())
+		{
+			emu_file file(OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+			if (file.open(options().profiler_output()) == FILERR_NONE)
+				g_profiler.dump(file);
+			else
+				osd_printf_error("Unable to open '%s' for writing the profile\n", options().profiler_output());
+		}
+
 #ifdef MAME_DEBUG
 		if (g_tagmap_counter_enabled)
 		{
@@ -474,6 +511,9 @@ int running_machine::run(bool firstrun)
 	call_notifiers(MACHINE_NOTIFY_EXIT);
 	zip_file_cache_clear();
 
+	// the profiler's scopes refer to our devices, so they go too
+	g_profiler.release_scopes();
+
 	// close the logfile
 	m_logfile.reset();
 	return error;
@@ -712,6 +752,21 @@ void running_machine::schedule_load(const char *filename)
 }
 
 
+//-------------------------------------------------
+//  schedule_rewind - schedule going back the
+//  given number of captured frames as soon as
+//  possible
+//-------------------------------------------------
+
+void running_machine::schedule_rewind(int frames)
+{
+	if (m_rewind == NULL)
+		return;
+
+	m_rewind_schedule_frames = frames;
+}
+
+
 //-------------------------------------------------
 //  immediate_load - load state.
 //-------------------------------------------------
@@ -915,6 +970,17 @@ void running_machine::handle_saveload()
 		// read/write the save state
 		save_error saverr = (m_saveload_schedule == SLS_LOAD) ? m_save.read_file(file) : m_save.write_file(file);
 
+#ifdef MAME_DEBUG
+		// in debug builds, make sure a state we just wrote reads back the same
+		if (saverr == STATERR_NONE && m_saveload_schedule == SLS_SAVE)
+		{
+			file.close();
+			emu_file check(m_saveload_searchpath, OPEN_FLAG_READ);
+			if (check.open(m_saveload_pending_file) != FILERR_NONE || m_save.verify_file(check) != STATERR_NONE)
+				osd_printf_error("Save state '%s' does not read back correctly\n", m_saveload_pending_file.cstr());
+		}
+#endif
+
 		// handle the result
 		switch (saverr)
 		{
@@ -961,6 +1027,53 @@ cancel:
 }
 
 
+//-------------------------------------------------
+//  handle_rewind - capture or restore an
+//  in-memory state between timeslices
+//-------------------------------------------------
+
+void running_machine::handle_rewind()
+{
+	// states can only be captured when there are no anonymous timers; try again next time
+	if (!m_scheduler.can_save())
+	{
+		if (m_rewind_schedule_frames >= 0)
+		{
+			popmessage("Unable to rewind due to pending anonymous timers. See error.log for details.");
+			m_rewind_schedule_frames = -1;
+		}
+		return;
+	}
+
+	// a scheduled rewind takes precedence, and makes the pending capture moot
+	if (m_rewind_schedule_frames >= 0)
+	{
+		int frames = MIN(m_rewind_schedule_frames, m_rewind->frames());
+		if (m_rewind->restore(frames) != STATERR_NONE)
+			popmessage("Error: Unable to rewind.");
+		m_rewind_schedule_frames = -1;
+		m_rewind_capture_pending = false;
+		return;
+	}
+
+	m_rewind->capture();
+	m_rewind_capture_pending = false;
+}
+
+
+//-------------------------------------------------
+//  rewind_frame_update - note that a new state
+//  should be captured at the end of the current
+//  timeslice
+//-------------------------------------------------
+
+void running_machine::rewind_frame_update()
+{
+	if (!paused())
+		m_rewind_capture_pending = true;
+}
+
+
 //-------------------------------------------------
 //  soft_reset - actually perform a soft-reset
 //  of the system
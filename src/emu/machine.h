@@ -93,6 +93,7 @@ class video_manager;
 class ui_manager;
 class tilemap_manager;
 class debug_view_manager;
+class frame_benchmark;
 class osd_interface;
 
 struct romload_private;
@@ -174,6 +175,7 @@ public:
 	ui_manager &ui() const { assert(m_ui != NULL); return *m_ui; }
 	tilemap_manager &tilemap() const { assert(m_tilemap != NULL); return *m_tilemap; }
 	debug_view_manager &debug_view() const { assert(m_debug_view != NULL); return *m_debug_view; }
+	frame_benchmark *benchmark() const { return m_benchmark; }
 	driver_device *driver_data() const { return &downcast<driver_device &>(root_device()); }
 	template<class _DriverClass> _DriverClass *driver_data() const { return &downcast<_DriverClass &>(root_device()); }
 	machine_phase phase() const { return m_current_phase; }
@@ -183,6 +185,7 @@ public:
 	const char *basename() const { return m_basename; }
 	int sample_rate() const { return m_sample_rate; }
 	bool save_or_load_pending() const { return m_saveload_pending_file; }
+	state_rewinder *rewinder() const { return m_rewind; }
 	screen_device *first_screen() const { return primary_screen; }
 
 	// additional helpers
@@ -218,6 +221,7 @@ public:
 	void schedule_new_driver(const game_driver &driver);
 	void schedule_save(const char *filename);
 	void schedule_load(const char *filename);
+	void schedule_rewind(int frames);
 
 	// date & time
 	void base_datetime(system_time &systime);
@@ -256,6 +260,8 @@ private:
 	astring get_statename(const char *statename_opt);
 	void fill_systime(system_time &systime, time_t t);
 	void handle_saveload();
+	void handle_rewind();
+	void rewind_frame_update();
 	void soft_reset(void *ptr = NULL, INT32 param = 0);
 	void watchdog_fired(void *ptr = NULL, INT32 param = 0);
 	void watchdog_vblank(screen_device &screen, bool vblank_state);
@@ -289,6 +295,7 @@ private:
 	auto_pointer<ui_manager> m_ui;                  // internal data from ui.c
 	auto_pointer<tilemap_manager> m_tilemap;        // internal data from tilemap.c
 	auto_pointer<debug_view_manager> m_debug_view;  // internal data from debugvw.c
+	auto_pointer<frame_benchmark> m_benchmark;      // internal data from benchmark.c
 
 	// system state
 	machine_phase           m_current_phase;        // current execution phase
@@ -323,6 +330,11 @@ private:
 	astring                 m_saveload_pending_file;
 	const char *            m_saveload_searchpath;
 
+	// in-memory rewind management
+	auto_pointer<state_rewinder> m_rewind;          // history of recent states, or NULL if disabled
+	bool                    m_rewind_capture_pending; // capture a state after this timeslice?
+	int                     m_rewind_schedule_frames; // number of frames to rewind, or -1 if none
+
 	// notifier callbacks
 	struct notifier_callback_item
 	{
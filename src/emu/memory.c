@@ -37,6 +37,13 @@
         STATIC_COUNT .. SUBTABLE_BASE - 1 = driver-specific handlers
         SUBTABLE_BASE .. TOTAL_MEMORY_BANKS - 1 = need to look up lower bits in subtable
 
+    Address spaces of up to -mem_flat_bits bits (in bytes) skip the
+    split entirely: they get a single flat table with one entry per byte
+    address, sized to the space, so every lookup is a single load. Only
+    larger spaces pay for the second level. Past 20 bits the flat table
+    (2MB and up) falls out of the cache faster than the second level
+    costs, so that is the default.
+
     Caveats:
 
     * If your driver executes an opcode which crosses a bank-switched
@@ -184,6 +191,7 @@
 #define MEM_DUMP        (0)
 #define VERBOSE         (0)
 #define TEST_HANDLER    (0)
+#define MEM_BENCHMARK   (0)
 
 #define VPRINTF(x)  do { if (VERBOSE) printf x; } while (0)
 
@@ -199,6 +207,9 @@ const int BANK_ENTRY_UNSPECIFIED = -1;
 // other address map constants
 const int MEMORY_BLOCK_CHUNK = 65536;                   // minimum chunk size of allocated memory blocks
 
+// limit on -mem_flat_bits; a flat table for a full 24-bit space is 32MB
+const int FLAT_TABLE_MAX_BITS = 24;
+
 // static data access handler constants
 enum
 {
@@ -512,6 +523,7 @@ class address_table
 	static const int SUBTABLE_ALLOC = 8;                        // number of subtables to allocate at a time
 
 	inline int level2_bits() const { return m_large ? LEVEL2_BITS : 0; }
+	inline UINT32 level1_count() const { return m_large ? (1 << LEVEL1_BITS) : (m_space.bytemask() + 1); }
 
 public:
 	// construction/destruction
@@ -520,7 +532,7 @@ public:
 
 	// getters
 	virtual handler_entry &handler(UINT32 index) const = 0;
-	bool watchpoints_enabled() const { return (m_live_lookup == s_watchpoint_table); }
+	bool watchpoints_enabled() const { return (m_live_lookup != m_table); }
 
 	// address lookups
 	UINT32 lookup_live(offs_t byteaddress) const { return m_large ? lookup_live_large(byteaddress) : lookup_live_small(byteaddress); }
@@ -554,7 +566,7 @@ public:
 	}
 
 	// enable watchpoints by swapping in the watchpoint table
-	void enable_watchpoints(bool enable = true) { m_live_lookup = enable ? s_watchpoint_table : &m_table[0]; }
+	void enable_watchpoints(bool enable = true) { m_live_lookup = enable ? m_space.manager().watchpoint_table() : &m_table[0]; }
 
 	// table mapping helpers
 	void map_range(offs_t bytestart, offs_t byteend, offs_t bytemask, offs_t bytemirror, UINT16 staticentry);
@@ -607,9 +619,6 @@ protected:
 	dynamic_array<subtable_data> m_subtable;            // info about each subtable
 	UINT16                  m_subtable_alloc;           // number of subtables allocated
 
-	// static global read-only watchpoint table
-	static UINT16           s_watchpoint_table[1 << LEVEL1_BITS];
-
 private:
 	int handler_refcount[SUBTABLE_BASE-STATIC_COUNT];
 	UINT16 handler_next_free[SUBTABLE_BASE-STATIC_COUNT];
@@ -1478,21 +1487,16 @@ typedef address_space_specific<UINT64, ENDIANNESS_BIG,    true> address_space_64
 
 
 
-//**************************************************************************
-//  GLOBAL VARIABLES
-//**************************************************************************
-
-// global watchpoint table
-UINT16 address_table::s_watchpoint_table[1 << LEVEL1_BITS];
-
-
-
 //**************************************************************************
 //  FUNCTION PROTOTYPES
 //**************************************************************************
 
+// table layout
+static int flat_table_bits(running_machine &machine);
+
 // debugging
 static void generate_memdump(running_machine &machine);
+static void generate_membench(running_machine &machine);
 
 
 
@@ -1507,7 +1511,8 @@ static void generate_memdump(running_machine &machine);
 memory_manager::memory_manager(running_machine &machine)
 	: m_machine(machine),
 		m_initialized(false),
-		m_banknext(STATIC_BANK1)
+		m_banknext(STATIC_BANK1),
+		m_watchpoint_count(0)
 {
 	memset(m_bank_ptr, 0, sizeof(m_bank_ptr));
 	memset(m_bankd_ptr, 0, sizeof(m_bankd_ptr));
@@ -1559,6 +1564,7 @@ void memory_manager::initialize()
 
 	// dump the final memory configuration
 	generate_memdump(machine());
+	generate_membench(machine());
 
 	// we are now initialized
 	m_initialized = true;
@@ -1611,6 +1617,26 @@ osd_printf_verbose("Region '%s' created\n", name);
 }
 
 
+//-------------------------------------------------
+//  region_map - creates a region backed by a
+//  copy-on-write mapping of the start of a file;
+//  returns NULL if the file can't be mapped
+//-------------------------------------------------
+
+memory_region *memory_manager::region_map(const char *name, const char *path, UINT32 length, UINT8 width, endianness_t endian)
+{
+	// make sure we don't have a region of the same name
+	if (m_regionlist.find(name) != NULL)
+		fatalerror("region_map called with duplicate region name \"%s\"\n", name);
+
+	void *base;
+	if (length == 0 || osd_map_file(path, length, &base) != FILERR_NONE)
+		return NULL;
+	osd_printf_verbose("Region '%s' mapped from '%s'\n", name, path);
+	return &m_regionlist.append(name, *global_alloc(memory_region(machine(), name, length, width, endian, base)));
+}
+
+
 //-------------------------------------------------
 //  region_free - releases memory for a region
 //-------------------------------------------------
@@ -1621,6 +1647,49 @@ void memory_manager::region_free(const char *name)
 }
 
 
+//-------------------------------------------------
+//  watchpoint_table_reserve - note how far a
+//  table's first level reaches, so that the
+//  watchpoint table can cover it
+//-------------------------------------------------
+
+void memory_manager::watchpoint_table_reserve(UINT32 count)
+{
+	// tables swapped to the watchpoint table would be left pointing at freed memory
+	assert_always(m_watchpoint_table.count() == 0, "Address tables must be created before watchpoints are enabled");
+	m_watchpoint_count = MAX(m_watchpoint_count, count);
+}
+
+
+//-------------------------------------------------
+//  watchpoint_table - return the shared read-only
+//  table of watchpoint entries, allocating it the
+//  first time watchpoints are enabled
+//-------------------------------------------------
+
+UINT16 *memory_manager::watchpoint_table()
+{
+	if (m_watchpoint_table.count() == 0)
+	{
+		m_watchpoint_table.resize(m_watchpoint_count);
+		for (UINT32 i = 0; i != m_watchpoint_count; i++)
+			m_watchpoint_table[i] = STATIC_WATCHPOINT;
+	}
+	return m_watchpoint_table;
+}
+
+
+//-------------------------------------------------
+//  flat_table_bits - return the widest space, in
+//  log2 bytes, that gets a single-level table
+//-------------------------------------------------
+
+static int flat_table_bits(running_machine &machine)
+{
+	return MIN(MAX(machine.options().mem_flat_bits(), 0), FLAT_TABLE_MAX_BITS);
+}
+
+
 //-------------------------------------------------
 //  generate_memdump - internal memory dump
 //-------------------------------------------------
@@ -1639,6 +1708,77 @@ static void generate_memdump(running_machine &machine)
 }
 
 
+//-------------------------------------------------
+//  membench_reads - read a list of addresses
+//  repeatedly at the native width
+//-------------------------------------------------
+
+template<typename _NativeType>
+static UINT64 membench_reads(address_space &space, const dynamic_array<offs_t> &addrlist, int passes)
+{
+	UINT64 sum = 0;
+	for (int pass = 0; pass < passes; pass++)
+		for (int index = 0; index < addrlist.count(); index++)
+		{
+			if (sizeof(_NativeType) == 1) sum += space.read_byte(addrlist[index]);
+			else if (sizeof(_NativeType) == 2) sum += space.read_word(addrlist[index]);
+			else if (sizeof(_NativeType) == 4) sum += space.read_dword(addrlist[index]);
+			else sum += space.read_qword(addrlist[index]);
+		}
+	return sum;
+}
+
+
+//-------------------------------------------------
+//  generate_membench - internal timing of RAM and
+//  ROM reads through each address space; compare
+//  table layouts by running with different
+//  -mem_flat_bits values
+//-------------------------------------------------
+
+static void generate_membench(running_machine &machine)
+{
+	if (MEM_BENCHMARK)
+	{
+		const int ADDRESS_COUNT = 4096;
+		const int PROBE_COUNT = 1 << 20;
+		const int PASSES = 256;
+
+		for (address_space *space = machine.memory().first_space(); space != NULL; space = space->next())
+		{
+			// scatter probes over the whole space, keeping only those that hit RAM or ROM
+			offs_t alignmask = ~(offs_t)(space->data_width() / 8 - 1);
+			dynamic_array<offs_t> addrlist;
+			for (UINT32 probe = 0; probe < PROBE_COUNT && addrlist.count() < ADDRESS_COUNT; probe++)
+			{
+				offs_t byteaddress = (probe * 0x9e3779b1) & space->bytemask() & alignmask;
+				if (space->get_read_ptr(byteaddress) != NULL)
+					addrlist.append(byteaddress);
+			}
+			if (addrlist.count() == 0)
+				continue;
+
+			// time the reads
+			UINT64 sum = 0;
+			osd_ticks_t start = osd_ticks();
+			switch (space->data_width())
+			{
+				case 8:     sum = membench_reads<UINT8>(*space, addrlist, PASSES);    break;
+				case 16:    sum = membench_reads<UINT16>(*space, addrlist, PASSES);   break;
+				case 32:    sum = membench_reads<UINT32>(*space, addrlist, PASSES);   break;
+				case 64:    sum = membench_reads<UINT64>(*space, addrlist, PASSES);   break;
+			}
+			osd_ticks_t elapsed = osd_ticks() - start;
+
+			double ns = (double)elapsed * 1.0e9 / (double)osd_ticks_per_second() / ((double)addrlist.count() * PASSES);
+			osd_printf_info("Device '%s' %s space (%s table): %d addresses, %.2f ns/read (sum %08X)\n",
+				space->device().tag(), space->name(), (space->bytemask() < (1U << flat_table_bits(machine))) ? "flat" : "two-level",
+				addrlist.count(), ns, (UINT32)sum);
+		}
+	}
+}
+
+
 //-------------------------------------------------
 //  bank_reattach - reconnect banks after a load
 //-------------------------------------------------
@@ -1701,7 +1841,7 @@ address_space::~address_space()
 address_space &address_space::allocate(memory_manager &manager, const address_space_config &config, device_memory_interface &memory, address_spacenum spacenum)
 {
 	// allocate one of the appropriate type
-	bool large = (config.addr2byte_end(0xffffffffUL >> (32 - config.m_addrbus_width)) >= (1 << 18));
+	bool large = (config.addr2byte_end(0xffffffffUL >> (32 - config.m_addrbus_width)) >= (1U << flat_table_bits(manager.machine())));
 
 	switch (config.data_width())
 	{
@@ -2701,20 +2841,19 @@ memory_bank &address_space::bank_find_or_allocate(const char *tag, offs_t addrst
 //-------------------------------------------------
 
 address_table::address_table(address_space &space, bool large)
-	: m_table(1 << LEVEL1_BITS),
+	: m_table(large ? (1 << LEVEL1_BITS) : (space.bytemask() + 1)),
 		m_live_lookup(m_table),
 		m_space(space),
 		m_large(large),
 		m_subtable(SUBTABLE_COUNT),
 		m_subtable_alloc(0)
 {
-	// make our static table all watchpoints
-	if (s_watchpoint_table[0] != STATIC_WATCHPOINT)
-		for (unsigned int i=0; i != ARRAY_LENGTH(s_watchpoint_table); i++)
-			s_watchpoint_table[i] = STATIC_WATCHPOINT;
+	// the shared watchpoint table must reach as far as our first level does
+	UINT32 count = level1_count();
+	space.manager().watchpoint_table_reserve(count);
 
 	// initialize everything to unmapped
-	for (unsigned int i=0; i != 1 << LEVEL1_BITS; i++)
+	for (UINT32 i = 0; i != count; i++)
 		m_table[i] = STATIC_UNMAP;
 
 	// initialize the handlers freelist
@@ -2955,7 +3094,7 @@ void address_table::verify_reference_counts()
 	bool subtable_seen[TOTAL_MEMORY_BANKS - SUBTABLE_BASE];
 	memset(subtable_seen, 0, sizeof(subtable_seen));
 
-	for (int level1 = 0; level1 != 1 << LEVEL1_BITS; level1++)
+	for (UINT32 level1 = 0; level1 != level1_count(); level1++)
 	{
 		UINT16 l1_entry = m_table[level1];
 		if (l1_entry >= SUBTABLE_BASE)
@@ -4126,11 +4265,14 @@ void memory_bank::configure_decrypted_entries(int startentry, int numentries, vo
 //  memory_region - constructor
 //-------------------------------------------------
 
-memory_region::memory_region(running_machine &machine, const char *name, UINT32 length, UINT8 width, endianness_t endian)
+memory_region::memory_region(running_machine &machine, const char *name, UINT32 length, UINT8 width, endianness_t endian, void *mapped)
 	: m_machine(machine),
 		m_next(NULL),
 		m_name(name),
-		m_buffer(length),
+		m_buffer((mapped != NULL) ? 0 : length),
+		m_mapped(mapped),
+		m_base((mapped != NULL) ? reinterpret_cast<UINT8 *>(mapped) : &m_buffer[0]),
+		m_length(length),
 		m_endianness(endian),
 		m_bitwidth(width * 8),
 		m_bytewidth(width)
@@ -4139,6 +4281,17 @@ memory_region::memory_region(running_machine &machine, const char *name, UINT32
 }
 
 
+//-------------------------------------------------
+//  ~memory_region - destructor
+//-------------------------------------------------
+
+memory_region::~memory_region()
+{
+	if (m_mapped != NULL)
+		osd_unmap_file(m_mapped, m_length);
+}
+
+
 
 //**************************************************************************
 //  HANDLER ENTRY
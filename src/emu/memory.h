@@ -686,15 +686,16 @@ class memory_region
 	friend resource_pool_object<memory_region>::~resource_pool_object();
 
 	// construction/destruction
-	memory_region(running_machine &machine, const char *name, UINT32 length, UINT8 width, endianness_t endian);
+	memory_region(running_machine &machine, const char *name, UINT32 length, UINT8 width, endianness_t endian, void *mapped = NULL);
+	~memory_region();
 
 public:
 	// getters
 	running_machine &machine() const { return m_machine; }
 	memory_region *next() const { return m_next; }
-	UINT8 *base() { return (this != NULL) ? &m_buffer[0] : NULL; }
-	UINT8 *end() { return (this != NULL) ? base() + m_buffer.count() : NULL; }
-	UINT32 bytes() const { return (this != NULL) ? m_buffer.count() : 0; }
+	UINT8 *base() { return (this != NULL) ? m_base : NULL; }
+	UINT8 *end() { return (this != NULL) ? m_base + m_length : NULL; }
+	UINT32 bytes() const { return (this != NULL) ? m_length : 0; }
 	const char *name() const { return m_name; }
 
 	// flag expansion
@@ -703,7 +704,7 @@ public:
 	UINT8 bytewidth() const { return m_bytewidth; }
 
 	// data access
-	UINT8 &u8(offs_t offset = 0) { return m_buffer[offset]; }
+	UINT8 &u8(offs_t offset = 0) { return m_base[offset]; }
 	UINT16 &u16(offs_t offset = 0) { return reinterpret_cast<UINT16 *>(base())[offset]; }
 	UINT32 &u32(offs_t offset = 0) { return reinterpret_cast<UINT32 *>(base())[offset]; }
 	UINT64 &u64(offs_t offset = 0) { return reinterpret_cast<UINT64 *>(base())[offset]; }
@@ -713,7 +714,10 @@ private:
 	running_machine &       m_machine;
 	memory_region *         m_next;
 	astring                 m_name;
-	dynamic_buffer          m_buffer;
+	dynamic_buffer          m_buffer;               // our data, unless it is mapped from a file
+	void *                  m_mapped;               // file mapping backing the region, or NULL
+	UINT8 *                 m_base;
+	UINT32                  m_length;
 	endianness_t            m_endianness;
 	UINT8                   m_bitwidth;
 	UINT8                   m_bytewidth;
@@ -749,6 +753,7 @@ public:
 
 	// regions
 	memory_region *region_alloc(const char *name, UINT32 length, UINT8 width, endianness_t endian);
+	memory_region *region_map(const char *name, const char *path, UINT32 length, UINT8 width, endianness_t endian);
 	void region_free(const char *name);
 
 private:
@@ -758,6 +763,8 @@ private:
 	memory_region *region(const char *tag) { return m_regionlist.find(tag); }
 	memory_share *shared(const char *tag) { return m_sharelist.find(tag); }
 	void bank_reattach();
+	void watchpoint_table_reserve(UINT32 count);
+	UINT16 *watchpoint_table();
 
 	// internal state
 	running_machine &           m_machine;              // reference to the machine
@@ -775,6 +782,9 @@ private:
 	tagged_list<memory_share>   m_sharelist;            // map for share lookups
 
 	tagged_list<memory_region>  m_regionlist;           // list of memory regions
+
+	dynamic_array<UINT16>       m_watchpoint_table;     // shared read-only watchpoint lookup, allocated on first use
+	UINT32                      m_watchpoint_count;     // entries it needs to cover the largest first level
 };
 
 
@@ -33,6 +33,8 @@ protected:
 	ATTR_HOT int solve_non_dynamic();
 	ATTR_HOT void build_LE();
 	ATTR_HOT void gauss_LE(nl_double (* RESTRICT x));
+	ATTR_HOT void sparse_LE(nl_double (* RESTRICT x));
+	ATTR_COLD void setup_sparse();
 	ATTR_HOT nl_double delta(const nl_double (* RESTRICT V));
 	ATTR_HOT void store(const nl_double (* RESTRICT V), const bool store_RHS);
 
@@ -54,6 +56,14 @@ protected:
 private:
 	vector_ops_t *m_row_ops[_storage_N + 1];
 
+	/* sparse LU: the nets in elimination order, and for each of them the
+	 * nets still connected to it when it is eliminated, fill-in included
+	 */
+	bool m_use_sparse;
+	int m_sp_order[_storage_N];
+	int m_sp_start[_storage_N + 1];
+	plinearlist_t<int> m_sp_cols;
+
 	int m_dim;
 	nl_double m_lp_fact;
 };
@@ -220,6 +230,78 @@ ATTR_COLD void netlist_matrix_solver_direct_t<m_N, _storage_N>::vsetup(netlist_a
 
 #endif
 
+	setup_sparse();
+}
+
+template <int m_N, int _storage_N>
+ATTR_COLD void netlist_matrix_solver_direct_t<m_N, _storage_N>::setup_sparse()
+{
+	const int kN = N();
+
+	m_use_sparse = (m_params.m_sparse_threshold > 0 && kN >= m_params.m_sparse_threshold);
+	m_sp_cols.clear();
+	if (!m_use_sparse)
+		return;
+
+	/* matrix structure; terminals come in pairs, so it is symmetric */
+	bool nz[_storage_N][_storage_N];
+	bool done[_storage_N];
+
+	for (int k = 0; k < kN; k++)
+	{
+		done[k] = false;
+		for (int i = 0; i < kN; i++)
+			nz[k][i] = false;
+	}
+	for (int k = 0; k < kN; k++)
+	{
+		const int *net_other = m_terms[k]->net_other();
+		for (int i = 0; i < m_terms[k]->m_railstart; i++)
+		{
+			nz[k][net_other[i]] = true;
+			nz[net_other[i]][k] = true;
+		}
+	}
+
+	/* Minimum degree ordering: always eliminate the net with the fewest
+	 * remaining connections. Eliminating a net connects all of its remaining
+	 * neighbours with each other, which is exactly the fill-in the numeric
+	 * elimination will produce. The matrix is diagonally dominant, so no
+	 * pivoting is needed in any order.
+	 */
+	for (int step = 0; step < kN; step++)
+	{
+		int best = -1;
+		int best_degree = 0;
+		for (int k = 0; k < kN; k++)
+			if (!done[k])
+			{
+				int degree = 0;
+				for (int i = 0; i < kN; i++)
+					if (!done[i] && i != k && nz[k][i])
+						degree++;
+				if (best < 0 || degree < best_degree)
+				{
+					best = k;
+					best_degree = degree;
+				}
+			}
+
+		m_sp_order[step] = best;
+		m_sp_start[step] = m_sp_cols.count();
+		done[best] = true;
+		for (int j = 0; j < kN; j++)
+			if (!done[j] && nz[best][j])
+			{
+				m_sp_cols.add(j);
+				for (int i = 0; i < kN; i++)
+					if (!done[i] && i != j && nz[best][i])
+						nz[j][i] = true;
+			}
+	}
+	m_sp_start[kN] = m_sp_cols.count();
+
+	netlist().log("       sparse LU: %d of %d elements after fill-in", kN + 2 * m_sp_cols.count(), kN * kN);
 }
 
 template <int m_N, int _storage_N>
@@ -379,6 +461,46 @@ ATTR_HOT void netlist_matrix_solver_direct_t<m_N, _storage_N>::gauss_LE(
 
 }
 
+template <int m_N, int _storage_N>
+ATTR_HOT void netlist_matrix_solver_direct_t<m_N, _storage_N>::sparse_LE(
+		nl_double (* RESTRICT x))
+{
+	const int kN = N();
+	const int *cols = m_sp_cols;
+
+	for (int step = 0; step < kN; step++)
+	{
+		const int i = m_sp_order[step];
+		const int start = m_sp_start[step];
+		const int end = m_sp_start[step + 1];
+		const nl_double f = 1.0 / m_A[i][i];
+
+		/* the structure is symmetric: the rows to eliminate are the pivot row's columns */
+		for (int jj = start; jj < end; jj++)
+		{
+			const int j = cols[jj];
+			const nl_double f1 = - m_A[j][i] * f;
+			if (f1 != 0.0)
+			{
+				for (int kk = start; kk < end; kk++)
+					m_A[j][cols[kk]] += m_A[i][cols[kk]] * f1;
+				m_RHS[j] += m_RHS[i] * f1;
+			}
+		}
+	}
+	/* back substitution, in reverse elimination order */
+	for (int step = kN - 1; step >= 0; step--)
+	{
+		const int i = m_sp_order[step];
+		nl_double tmp = 0;
+
+		for (int kk = m_sp_start[step]; kk < m_sp_start[step + 1]; kk++)
+			tmp += m_A[i][cols[kk]] * x[cols[kk]];
+
+		x[i] = (m_RHS[i] - tmp) / m_A[i][i];
+	}
+}
+
 template <int m_N, int _storage_N>
 ATTR_HOT nl_double netlist_matrix_solver_direct_t<m_N, _storage_N>::delta(
 		const nl_double (* RESTRICT V))
@@ -426,7 +548,10 @@ ATTR_HOT int netlist_matrix_solver_direct_t<m_N, _storage_N>::solve_non_dynamic(
 {
 	nl_double new_v[_storage_N] = { 0.0 };
 
-	this->gauss_LE(new_v);
+	if (m_use_sparse)
+		this->sparse_LE(new_v);
+	else
+		this->gauss_LE(new_v);
 
 	if (this->is_dynamic())
 	{
@@ -455,6 +580,7 @@ ATTR_HOT inline int netlist_matrix_solver_direct_t<m_N, _storage_N>::vsolve_non_
 template <int m_N, int _storage_N>
 netlist_matrix_solver_direct_t<m_N, _storage_N>::netlist_matrix_solver_direct_t(const netlist_solver_parameters_t &params, int size)
 : netlist_matrix_solver_t(GAUSSIAN_ELIMINATION, params)
+, m_use_sparse(false)
 , m_dim(size)
 , m_lp_fact(0)
 {
@@ -472,6 +598,7 @@ netlist_matrix_solver_direct_t<m_N, _storage_N>::netlist_matrix_solver_direct_t(
 template <int m_N, int _storage_N>
 netlist_matrix_solver_direct_t<m_N, _storage_N>::netlist_matrix_solver_direct_t(const eSolverType type, const netlist_solver_parameters_t &params, int size)
 : netlist_matrix_solver_t(type, params)
+, m_use_sparse(false)
 , m_dim(size)
 , m_lp_fact(0)
 {
@@ -343,6 +343,7 @@ NETLIB_START(solver)
 	register_param("GS_LOOPS", m_gs_loops, 9);              // Gauss-Seidel loops
 	register_param("GS_THRESHOLD", m_gs_threshold, 5);      // below this value, gaussian elimination is used
 	register_param("NR_LOOPS", m_nr_loops, 25);             // Newton-Raphson loops
+	register_param("SPARSE_THRESHOLD", m_sparse_threshold, 3); // from this size on, the direct solver uses sparse LU
 	register_param("PARALLEL", m_parallel, 0);
 	register_param("SOR_FACTOR", m_sor, 1.059);
 	register_param("GMIN", m_gmin, NETLIST_GMIN_DEFAULT);
@@ -456,6 +457,7 @@ ATTR_COLD void NETLIB_NAME(solver)::post_start()
 	m_params.m_accuracy = m_accuracy.Value();
 	m_params.m_gs_loops = m_gs_loops.Value();
 	m_params.m_nr_loops = m_nr_loops.Value();
+	m_params.m_sparse_threshold = m_sparse_threshold.Value();
 	m_params.m_nt_sync_delay = m_sync_delay.Value();
 	m_params.m_lte = m_lte.Value();
 	m_params.m_sor = m_sor.Value();
@@ -18,6 +18,13 @@
 #define USE_MATRIX_GS 0
 // savings are eaten up by effort
 #define USE_LINEAR_PREDICTION (0)
+// SSE2 kernels for vector_ops_impl_t; these assume nl_double is double
+#if defined(__SSE2__) || defined(_M_X64)
+#define USE_SSE2_VECTOR_OPS (1)
+#include <emmintrin.h>
+#else
+#define USE_SSE2_VECTOR_OPS (0)
+#endif
 
 // ----------------------------------------------------------------------------------------
 // Macros
@@ -45,6 +52,7 @@ struct netlist_solver_parameters_t
 	bool m_dynamic;
 	int m_gs_loops;
 	int m_nr_loops;
+	int m_sparse_threshold;     // nets at or above this size use the sparse LU, 0 disables
 	netlist_time m_nt_sync_delay;
 };
 
@@ -119,7 +127,14 @@ public:
 	{
 		nl_double * RESTRICT v1l = v1;
 		const nl_double * RESTRICT v2l = v2;
-		for (int i=0; i < N(); i++)
+		int i = 0;
+#if USE_SSE2_VECTOR_OPS
+		// element-wise, so the results are the same as the scalar loop
+		const __m128d m = _mm_set1_pd(mult);
+		for (; i + 2 <= N(); i += 2)
+			_mm_storeu_pd(&v1l[i], _mm_add_pd(_mm_loadu_pd(&v1l[i]), _mm_mul_pd(_mm_loadu_pd(&v2l[i]), m)));
+#endif
+		for (; i < N(); i++)
 		{
 			v1l[i] += v2l[i] * mult;
 		}
@@ -302,6 +317,7 @@ protected:
 	netlist_param_int_t m_nr_loops;
 	netlist_param_int_t m_gs_loops;
 	netlist_param_int_t m_gs_threshold;
+	netlist_param_int_t m_sparse_threshold;
 	netlist_param_int_t m_parallel;
 
 	netlist_matrix_solver_t::list_t m_mat_solvers;
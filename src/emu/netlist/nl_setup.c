@@ -313,6 +313,15 @@ void netlist_setup_t::register_param(const pstring &param, const pstring &value)
 		netlist().error("Error adding parameter %s to parameter list\n", param.cstr());
 }
 
+void netlist_setup_t::override_param(const pstring &param, const pstring &value)
+{
+	pstring fqn = build_fqn(param);
+
+	// replace any value the netlist already set
+	m_params_temp.remove_by_name(fqn);
+	m_params_temp.add(link_t(fqn, value), false);
+}
+
 const pstring netlist_setup_t::resolve_alias(const pstring &name) const
 {
 	pstring temp = name;
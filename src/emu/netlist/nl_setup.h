@@ -127,6 +127,7 @@ public:
 	void register_link(const pstring &sin, const pstring &sout);
 	void register_param(const pstring &param, const pstring &value);
 	void register_param(const pstring &param, const double value);
+	void override_param(const pstring &param, const pstring &value);
 
 	void register_object(netlist_device_t &dev, const pstring &name, netlist_object_t &obj);
 	void connect(netlist_core_terminal_t &t1, netlist_core_terminal_t &t2);
@@ -19,6 +19,17 @@
 
     the profiler handles a FILO list so calls may be nested.
 
+    Besides the fixed types below, scopes can be created at runtime by
+    name with g_profiler.scope(); executing devices, sound streams,
+    screens and timer callbacks each get one. Time is accumulated in a
+    call tree, so the same scope entered from two different places is
+    reported separately under each. For every node in the tree the
+    profiler keeps the total and self time, the number of calls, and a
+    histogram of per-call times from which percentiles are derived.
+
+    The tree is shown by the UI overlay, and written out in full by
+    dump() when -profiler_output is given.
+
 ***************************************************************************/
 
 #include "emu.h"
@@ -77,9 +88,11 @@ dummy_profiler_state::dummy_profiler_state()
 //-------------------------------------------------
 
 real_profiler_state::real_profiler_state()
+	: m_filoptr(NULL),
+		m_node_count(0),
+		m_enable_ticks(0)
 {
 	memset(m_filo, 0, sizeof(m_filo));
-	memset(m_data, 0, sizeof(m_data));
 	reset(false);
 }
 
@@ -95,12 +108,26 @@ void real_profiler_state::reset(bool enabled)
 
 	if (enabled)
 	{
+		// make sure the built-in scopes are named
+		register_builtin_scopes();
+
+		// start with a bare root node
+		if (m_node.count() == 0)
+			m_node.resize(64);
+		memset(&m_node[0], 0, sizeof(m_node[0]));
+		m_node[0].type = PROFILER_TOTAL;
+		m_node[0].parent = m_node[0].child = m_node[0].sibling = m_node[0].lastchild = -1;
+		m_node_count = 1;
+		m_count.clear();
+		m_enable_ticks = get_profile_ticks();
+
 		// we're enabled now
 		m_filoptr = m_filo;
 
 		// set up dummy entry
-		m_filoptr->start = 0;
-		m_filoptr->type = PROFILER_TOTAL;
+		m_filoptr->node = 0;
+		m_filoptr->start = m_enable_ticks;
+		m_filoptr->callstart = m_enable_ticks;
 	}
 	else
 	{
@@ -112,38 +139,17 @@ void real_profiler_state::reset(bool enabled)
 
 
 //-------------------------------------------------
-//  text - return the current text in an astring
-//-------------------------------------------------
-
-const char *real_profiler_state::text(running_machine &machine)
-{
-	start(PROFILER_PROFILER);
-
-	// get the current time
-	attotime current_time = machine.scheduler().time();
-
-	// we only want to update the text periodically
-	if ((m_text_time == attotime::never) || ((current_time - m_text_time).as_double() >= TEXT_UPDATE_TIME))
-	{
-		update_text(machine);
-		m_text_time = current_time;
-	}
-
-	stop();
-	return m_text;
-}
-
-
-
-//-------------------------------------------------
-//  update_text - update the current astring
+//  register_builtin_scopes - name all of the
+//  fixed profiler types, the first time through
 //-------------------------------------------------
 
-void real_profiler_state::update_text(running_machine &machine)
+void real_profiler_state::register_builtin_scopes()
 {
 	static const profile_string names[] =
 	{
 		{ PROFILER_DRC_COMPILE,      "DRC Compilation" },
+		{ PROFILER_DRC_FLUSH,        "DRC Cache Flush" },
+		{ PROFILER_DRC_RECLAIM,      "DRC Bytes Reclaimed" },
 		{ PROFILER_MEM_REMAP,        "Memory Remapping" },
 		{ PROFILER_MEMREAD,          "Memory Read" },
 		{ PROFILER_MEMWRITE,         "Memory Write" },
@@ -156,6 +162,12 @@ void real_profiler_state::update_text(running_machine &machine)
 		{ PROFILER_BLIT,             "OSD Blitting" },
 		{ PROFILER_SOUND,            "Sound Generation" },
 		{ PROFILER_TIMER_CALLBACK,   "Timer Callbacks" },
+		{ PROFILER_QUANTUM_FIRST + 0, "Quanta < 1us" },
+		{ PROFILER_QUANTUM_FIRST + 1, "Quanta < 10us" },
+		{ PROFILER_QUANTUM_FIRST + 2, "Quanta < 100us" },
+		{ PROFILER_QUANTUM_FIRST + 3, "Quanta < 1ms" },
+		{ PROFILER_QUANTUM_FIRST + 4, "Quanta < 10ms" },
+		{ PROFILER_QUANTUM_LAST,     "Quanta >= 10ms" },
 		{ PROFILER_INPUT,            "Input Processing" },
 		{ PROFILER_MOVIE_REC,        "Movie Recording" },
 		{ PROFILER_LOGERROR,         "Error Logging" },
@@ -169,61 +181,358 @@ void real_profiler_state::update_text(running_machine &machine)
 		{ PROFILER_USER7,            "User 7" },
 		{ PROFILER_USER8,            "User 8" },
 		{ PROFILER_PROFILER,         "Profiler" },
-		{ PROFILER_IDLE,             "Idle" }
+		{ PROFILER_IDLE,             "Idle" },
+		{ PROFILER_TOTAL,            "Total" }
 	};
 
-	// compute the total time for all bits, not including profiler or idle
-	UINT64 computed = 0;
-	profile_type curtype;
-	for (curtype = PROFILER_DEVICE_FIRST; curtype < PROFILER_PROFILER; curtype++)
-		computed += m_data[curtype];
+	// only do this once
+	if (m_name.count() != 0)
+		return;
+
+	// the device range is left over from before devices had their own scopes
+	m_name.resize(PROFILER_TOTAL + 1);
+	for (int type = PROFILER_DEVICE_FIRST; type < PROFILER_DEVICE_MAX; type++)
+		m_name[type].format("Device %d", type - PROFILER_DEVICE_FIRST);
+	for (int nameindex = 0; nameindex < ARRAY_LENGTH(names); nameindex++)
+		m_name[names[nameindex].type].cpy(names[nameindex].string);
+	m_count.resize_and_clear(m_name.count());
+}
+
+
+
+//-------------------------------------------------
+//  scope - return the profiler type for a named
+//  scope, creating it if this is the first time
+//  it has been asked for
+//-------------------------------------------------
+
+profile_type real_profiler_state::scope(const char *name)
+{
+	register_builtin_scopes();
+
+	// look for an existing one
+	int type = m_scope_map.find(name);
+	if (type != 0)
+		return profile_type(type);
+
+	// add a new one
+	type = m_name.count();
+	m_name.append().cpy(name);
+	m_count.resize_keep_and_clear_new(m_name.count());
+	m_scope_map.add(name, type);
+	return profile_type(type);
+}
+
+
+
+//-------------------------------------------------
+//  release_scopes - disable profiling and forget
+//  all dynamic scopes; called when a machine
+//  goes away, since the scopes name its devices
+//-------------------------------------------------
+
+void real_profiler_state::release_scopes()
+{
+	reset(false);
+	m_node.reset();
+	m_node_count = 0;
+	m_name.reset();
+	m_count.reset();
+	m_scope_map.reset();
+}
+
+
+
+//-------------------------------------------------
+//  find_child - find or create the node for the
+//  given type beneath the given parent
+//-------------------------------------------------
+
+int real_profiler_state::find_child(int parent, int type)
+{
+	// look for an existing child
+	int node;
+	for (node = m_node[parent].child; node >= 0; node = m_node[node].sibling)
+		if (m_node[node].type == type)
+			break;
+
+	// create a new one if not found
+	if (node < 0)
+	{
+		// make room, doubling each time so we don't reallocate often
+		if (m_node_count == m_node.count())
+			m_node.resize_keep(m_node_count * 2);
+
+		node = m_node_count++;
+		call_node &newnode = m_node[node];
+		memset(&newnode, 0, sizeof(newnode));
+		newnode.type = type;
+		newnode.parent = parent;
+		newnode.child = newnode.lastchild = -1;
+
+		// append to the end of the parent's list, so the tree stays in first-call order
+		newnode.sibling = -1;
+		int *link = &m_node[parent].child;
+		while (*link >= 0)
+			link = &m_node[*link].sibling;
+		*link = node;
+	}
+
+	// remember it for next time
+	m_node[parent].lastchild = node;
+	return node;
+}
+
+
+
+//-------------------------------------------------
+//  inclusive_time - return the time spent in a
+//  node, including all of its children
+//-------------------------------------------------
+
+osd_ticks_t real_profiler_state::inclusive_time(int node) const
+{
+	osd_ticks_t result = m_node[node].self;
+	for (int child = m_node[node].child; child >= 0; child = m_node[child].sibling)
+		result += inclusive_time(child);
+	return result;
+}
+
+
+
+//-------------------------------------------------
+//  percentile - estimate the given percentile of
+//  per-call times from a histogram
+//-------------------------------------------------
+
+osd_ticks_t real_profiler_state::percentile(const UINT32 *histogram, UINT64 calls, int percent)
+{
+	// find the bucket containing the requested call
+	UINT64 target = (calls * percent + 99) / 100;
+	UINT64 seen = 0;
+	int bucket;
+	for (bucket = 0; bucket < HISTOGRAM_BUCKETS - 1; bucket++)
+	{
+		seen += histogram[bucket];
+		if (seen >= target)
+			break;
+	}
+
+	// small buckets are exact; the rest report the middle of their range
+	if (bucket < 4)
+		return bucket;
+	int shift = bucket / 4 - 2;
+	return (osd_ticks_t(4 + (bucket & 3)) << shift) + ((osd_ticks_t(1) << shift) >> 1);
+}
+
+
+
+//-------------------------------------------------
+//  text - return the current text in an astring
+//-------------------------------------------------
+
+const char *real_profiler_state::text(running_machine &machine)
+{
+	start(PROFILER_PROFILER);
+
+	// get the current time
+	attotime current_time = machine.scheduler().time();
+
+	// we only want to update the text periodically
+	if ((m_text_time == attotime::never) || ((current_time - m_text_time).as_double() >= TEXT_UPDATE_TIME))
+	{
+		update_text(machine);
+		m_text_time = current_time;
+	}
+
+	stop();
+	return m_text;
+}
+
 
-	// save that result in normalize, and continue adding the rest
-	UINT64 normalize = computed;
-	for ( ; curtype < PROFILER_TOTAL; curtype++)
-		computed += m_data[curtype];
 
-	// this becomes the total; if we end up with 0 for anything, we were just started, so return empty
-	UINT64 total = computed;
+//-------------------------------------------------
+//  update_text - update the current astring
+//-------------------------------------------------
+
+void real_profiler_state::update_text(running_machine &machine)
+{
+	// the total is the time spent in the root since the last update
 	m_text.reset();
-	if (total == 0 || normalize == 0)
+	osd_ticks_t total = inclusive_time(0) - m_node[0].shown_total;
+	if (total > 0)
 	{
-		return;
+		// list the call tree, biggest contributors only
+		m_text.cat("Total Self [Calls]\n");
+		for (int child = m_node[0].child; child >= 0; child = m_node[child].sibling)
+			append_text(child, 0, total);
+
+		// followed by anything that just counts events
+		for (int type = 0; type < m_name.count(); type++)
+			if (m_count[type] != 0)
+				m_text.catprintf("[%" I64FMT "u] %s\n", m_count[type], m_name[type].cstr());
 	}
 
-	// loop over all types and generate the string
-	device_iterator iter(machine.root_device());
-	for (curtype = PROFILER_DEVICE_FIRST; curtype < PROFILER_TOTAL; curtype++)
+	// start a new interval
+	snapshot_node(0);
+}
+
+
+
+//-------------------------------------------------
+//  snapshot_node - remember the current totals
+//  for a node and its children, so the next text
+//  update covers only what came after
+//-------------------------------------------------
+
+void real_profiler_state::snapshot_node(int node)
+{
+	call_node &cur = m_node[node];
+	cur.shown_total = inclusive_time(node);
+	cur.shown_self = cur.self;
+	cur.shown_calls = cur.calls;
+	for (int child = cur.child; child >= 0; child = m_node[child].sibling)
+		snapshot_node(child);
+}
+
+
+
+//-------------------------------------------------
+//  append_text - add a line to the text for a
+//  node, and recurse into its children
+//-------------------------------------------------
+
+void real_profiler_state::append_text(int node, int depth, osd_ticks_t total)
+{
+	const call_node &cur = m_node[node];
+
+	// skip anything under 1% of the interval, along with its children
+	osd_ticks_t inclusive = inclusive_time(node) - cur.shown_total;
+	if (inclusive * 100 < total)
+		return;
+
+	// inclusive and self percentages, then the call count
+	osd_ticks_t self = cur.self - cur.shown_self;
+	m_text.catprintf("%02d%% %02d%% ", (int)((inclusive * 100 + total/2) / total), (int)((self * 100 + total/2) / total));
+	if (cur.calls != cur.shown_calls)
+		m_text.catprintf("[%" I64FMT "u] ", cur.calls - cur.shown_calls);
+
+	// then the name, indented to show nesting
+	for (int level = 0; level < depth; level++)
+		m_text.cat("  ");
+	m_text.cat(m_name[cur.type]).cat("\n");
+
+	for (int child = cur.child; child >= 0; child = m_node[child].sibling)
+		append_text(child, depth + 1, total);
+}
+
+
+
+//-------------------------------------------------
+//  dump - write the full call tree and per-scope
+//  totals since profiling was enabled to a file
+//-------------------------------------------------
+
+void real_profiler_state::dump(emu_file &file)
+{
+	if (!enabled())
+		return;
+
+	start(PROFILER_PROFILER);
+
+	// header
+	osd_ticks_t elapsed = get_profile_ticks() - m_enable_ticks;
+	file.printf("Profile of %.3f seconds; times in milliseconds, except per-call times in microseconds\n\n", double(elapsed) / double(osd_ticks_per_second()));
+
+	// the call tree
+	file.printf("Call tree:\n");
+	file.printf("%10s %10s %10s %10s %10s %10s %10s %10s  %s\n", "total", "self", "calls", "avg", "p50", "p90", "p99", "max", "scope");
+	for (int child = m_node[0].child; child >= 0; child = m_node[child].sibling)
+		dump_node(file, child, 0);
+
+	// gather totals for each scope wherever it was called from
+	int types = m_name.count();
+	dynamic_array<osd_ticks_t> total(types), self(types), longest(types);
+	dynamic_array<UINT64> calls(types);
+	dynamic_array<UINT32> histogram(types * HISTOGRAM_BUCKETS);
+	total.clear();
+	self.clear();
+	longest.clear();
+	calls.clear();
+	histogram.clear();
+	for (int node = 1; node < m_node_count; node++)
 	{
-		// determine the accumulated time for this type
-		computed = m_data[curtype];
+		const call_node &cur = m_node[node];
+
+		// only count inclusive time at the outermost level of recursion
+		int parent;
+		for (parent = cur.parent; parent > 0; parent = m_node[parent].parent)
+			if (m_node[parent].type == cur.type)
+				break;
+		if (parent <= 0)
+			total[cur.type] += inclusive_time(node);
+
+		self[cur.type] += cur.self;
+		calls[cur.type] += cur.calls;
+		if (cur.longest > longest[cur.type])
+			longest[cur.type] = cur.longest;
+		for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+			histogram[cur.type * HISTOGRAM_BUCKETS + bucket] += cur.histogram[bucket];
+	}
 
-		// if we have non-zero data and we're ready to display, do it
-		if (computed != 0)
+	// write those out
+	file.printf("\nScopes:\n");
+	file.printf("%10s %10s %10s %10s %10s %10s %10s %10s  %s\n", "total", "self", "calls", "avg", "p50", "p90", "p99", "max", "scope");
+	for (int type = 0; type < types; type++)
+		if (calls[type] != 0)
 		{
-			// start with the un-normalized percentage
-			m_text.catprintf("%02d%% ", (int)((computed * 100 + total/2) / total));
-
-			// followed by the normalized percentage for everything but profiler and idle
-			if (curtype < PROFILER_PROFILER)
-				m_text.catprintf("%02d%% ", (int)((computed * 100 + normalize/2) / normalize));
-
-			// and then the text
-			if (curtype >= PROFILER_DEVICE_FIRST && curtype <= PROFILER_DEVICE_MAX)
-				m_text.catprintf("'%s'", iter.byindex(curtype - PROFILER_DEVICE_FIRST)->tag());
-			else
-				for (int nameindex = 0; nameindex < ARRAY_LENGTH(names); nameindex++)
-					if (names[nameindex].type == curtype)
-					{
-						m_text.cat(names[nameindex].string);
-						break;
-					}
-
-			// followed by a carriage return
-			m_text.cat("\n");
+			dump_times(file, total[type], self[type], calls[type], longest[type], &histogram[type * HISTOGRAM_BUCKETS]);
+			file.printf("  %s\n", m_name[type].cstr());
 		}
-	}
 
-	// reset data set to 0
-	memset(m_data, 0, sizeof(m_data));
+	// and finally the event counts
+	file.printf("\nCounts:\n");
+	for (int type = 0; type < types; type++)
+		if (m_count[type] != 0)
+			file.printf("%10" I64FMT "u  %s\n", m_count[type], m_name[type].cstr());
+
+	stop();
+}
+
+
+
+//-------------------------------------------------
+//  dump_node - write a line for a node in the
+//  call tree, and recurse into its children
+//-------------------------------------------------
+
+void real_profiler_state::dump_node(emu_file &file, int node, int depth)
+{
+	const call_node &cur = m_node[node];
+	dump_times(file, inclusive_time(node), cur.self, cur.calls, cur.longest, cur.histogram);
+	file.printf("  %*s%s\n", depth * 2, "", m_name[cur.type].cstr());
+
+	for (int child = cur.child; child >= 0; child = m_node[child].sibling)
+		dump_node(file, child, depth + 1);
+}
+
+
+
+//-------------------------------------------------
+//  dump_times - write the timing columns shared
+//  by the call tree and the scope totals
+//-------------------------------------------------
+
+void real_profiler_state::dump_times(emu_file &file, osd_ticks_t total, osd_ticks_t self, UINT64 calls, osd_ticks_t longest, const UINT32 *histogram)
+{
+	double ms = 1000.0 / double(osd_ticks_per_second());
+	double us = 1000000.0 / double(osd_ticks_per_second());
+
+	file.printf("%10.3f %10.3f %10" I64FMT "u", double(total) * ms, double(self) * ms, calls);
+	if (calls != 0)
+		file.printf(" %10.2f %10.2f %10.2f %10.2f %10.2f", double(total) * us / double(calls),
+			double(percentile(histogram, calls, 50)) * us, double(percentile(histogram, calls, 90)) * us,
+			double(percentile(histogram, calls, 99)) * us, double(longest) * us);
+	else
+		file.printf(" %10s %10s %10s %10s %10s", "-", "-", "-", "-", "-");
 }
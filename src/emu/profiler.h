@@ -19,6 +19,17 @@
 
     the profiler handles a FILO list so calls may be nested.
 
+    Besides the fixed types below, scopes can be created at runtime by
+    name with g_profiler.scope(); executing devices, sound streams,
+    screens and timer callbacks each get one. Time is accumulated in a
+    call tree, so the same scope entered from two different places is
+    reported separately under each. For every node in the tree the
+    profiler keeps the total and self time, the number of calls, and a
+    histogram of per-call times from which percentiles are derived.
+
+    The tree is shown by the UI overlay, and written out in full by
+    dump() when -profiler_output is given.
+
 ***************************************************************************/
 
 #pragma once
@@ -39,6 +50,8 @@ enum profile_type
 	PROFILER_DEVICE_FIRST = 0,
 	PROFILER_DEVICE_MAX = PROFILER_DEVICE_FIRST + 256,
 	PROFILER_DRC_COMPILE,
+	PROFILER_DRC_FLUSH,
+	PROFILER_DRC_RECLAIM,       // count only: bytes reclaimed by DRC cache eviction
 	PROFILER_MEM_REMAP,
 	PROFILER_MEMREAD,
 	PROFILER_MEMWRITE,
@@ -51,6 +64,8 @@ enum profile_type
 	PROFILER_BLIT,
 	PROFILER_SOUND,
 	PROFILER_TIMER_CALLBACK,
+	PROFILER_QUANTUM_FIRST,     // count only: scheduler quanta, binned by duration
+	PROFILER_QUANTUM_LAST = PROFILER_QUANTUM_FIRST + 5,
 	PROFILER_INPUT,             // input.c and inptport.c
 	PROFILER_MOVIE_REC,         // movie recording
 	PROFILER_LOGERROR,          // logerror
@@ -79,6 +94,8 @@ DECLARE_ENUM_OPERATORS(profile_type);
 //  TYPE DEFINITIONS
 //**************************************************************************
 
+class emu_file;
+
 
 // ======================> real_profiler_state
 
@@ -98,6 +115,7 @@ public:
 #endif
 	}
 	const char *text(running_machine &machine);
+	void dump(emu_file &file);
 
 	// enable/disable
 	void enable(bool state = true)
@@ -108,13 +126,65 @@ public:
 		}
 	}
 
+	// dynamic scopes, found or created by name
+	profile_type scope(const char *name);
+	void release_scopes();
+
 	// start/stop
 	void start(profile_type type) { if (enabled()) real_start(type); }
 	void stop() { if (enabled()) real_stop(); }
 
+	// event counting
+	void count(profile_type type, UINT64 amount = 1) { if (enabled()) m_count[type] += amount; }
+
 private:
+	// per-call times are binned in quarter-octaves of ticks
+	static const int HISTOGRAM_BUCKETS = 128;
+
+	// a node in the call tree: a scope entered through a particular chain of parents
+	struct call_node
+	{
+		int             type;                       // type of the scope
+		int             parent;                     // index of the parent node, or -1
+		int             child;                      // index of the first child node, or -1
+		int             sibling;                    // index of the next sibling node, or -1
+		int             lastchild;                  // index of the child most recently entered, or -1
+		osd_ticks_t     self;                       // time spent here, excluding children
+		osd_ticks_t     longest;                    // longest single call
+		UINT64          calls;                      // number of completed calls
+		osd_ticks_t     shown_total;                // inclusive time at the last text update
+		osd_ticks_t     shown_self;                 // self time at the last text update
+		UINT64          shown_calls;                // number of calls at the last text update
+		UINT32          histogram[HISTOGRAM_BUCKETS]; // distribution of per-call times
+	};
+
 	void reset(bool enabled);
 	void update_text(running_machine &machine);
+	void register_builtin_scopes();
+	int find_child(int parent, int type);
+	osd_ticks_t inclusive_time(int node) const;
+	void snapshot_node(int node);
+	void append_text(int node, int depth, osd_ticks_t total);
+	void dump_node(emu_file &file, int node, int depth);
+	void dump_times(emu_file &file, osd_ticks_t total, osd_ticks_t self, UINT64 calls, osd_ticks_t longest, const UINT32 *histogram);
+	static osd_ticks_t percentile(const UINT32 *histogram, UINT64 calls, int percent);
+
+	//-------------------------------------------------
+	//  histogram_bucket - return the histogram
+	//  bucket for a call of the given length
+	//-------------------------------------------------
+	static ATTR_FORCE_INLINE int histogram_bucket(osd_ticks_t ticks)
+	{
+		// small values get their own buckets
+		if (ticks < 4)
+			return (ticks < 0) ? 0 : int(ticks);
+		if (ticks >= (osd_ticks_t(1) << 31))
+			return HISTOGRAM_BUCKETS - 1;
+
+		// otherwise, 4 buckets per power of 2
+		int msb = 31 - count_leading_zeros(UINT32(ticks));
+		return msb * 4 + ((ticks >> (msb - 2)) & 3);
+	}
 
 	//-------------------------------------------------
 	//  real_start - mark the beginning of a
@@ -130,14 +200,20 @@ private:
 		osd_ticks_t curticks = get_profile_ticks();
 
 		// update previous entry
-		m_data[m_filoptr->type] += curticks - m_filoptr->start;
+		m_node[m_filoptr->node].self += curticks - m_filoptr->start;
+
+		// find the node for this scope under the current one
+		int node = m_node[m_filoptr->node].lastchild;
+		if (node < 0 || m_node[node].type != type)
+			node = find_child(m_filoptr->node, type);
 
 		// move to next entry
 		m_filoptr++;
 
 		// fill in this entry
-		m_filoptr->type = type;
+		m_filoptr->node = node;
 		m_filoptr->start = curticks;
+		m_filoptr->callstart = curticks;
 	}
 
 	//-------------------------------------------------
@@ -153,7 +229,15 @@ private:
 		osd_ticks_t curticks = get_profile_ticks();
 
 		// account for the time taken
-		m_data[m_filoptr->type] += curticks - m_filoptr->start;
+		call_node &node = m_node[m_filoptr->node];
+		node.self += curticks - m_filoptr->start;
+
+		// and for the call as a whole
+		osd_ticks_t elapsed = curticks - m_filoptr->callstart;
+		node.calls++;
+		node.histogram[histogram_bucket(elapsed)]++;
+		if (elapsed > node.longest)
+			node.longest = elapsed;
 
 		// move back an entry
 		m_filoptr--;
@@ -165,16 +249,22 @@ private:
 	// an entry in the FILO
 	struct filo_entry
 	{
-		int             type;                       // type of entry
-		osd_ticks_t     start;                      // start time
+		int             node;                       // index of the call tree node
+		osd_ticks_t     start;                      // start time of the current stretch
+		osd_ticks_t     callstart;                  // start time of the call
 	};
 
 	// internal state
 	filo_entry *        m_filoptr;                  // current FILO index
 	astring             m_text;                     // profiler text
 	attotime            m_text_time;                // profiler text last update
-	filo_entry          m_filo[32];                 // array of FILO entries
-	osd_ticks_t         m_data[PROFILER_TOTAL + 1]; // array of data
+	filo_entry          m_filo[256];                // array of FILO entries
+	dynamic_array<call_node> m_node;                // call tree; node 0 is the root
+	int                 m_node_count;               // number of nodes in use
+	dynamic_array<astring> m_name;                  // name of each scope type
+	tagmap_t<FPTR>      m_scope_map;                // map from name to dynamic scope type
+	dynamic_array<UINT64> m_count;                  // event counts for each scope type
+	osd_ticks_t         m_enable_ticks;             // tick count when last enabled
 };
 
 
@@ -189,13 +279,21 @@ public:
 	// getters
 	bool enabled() const { return false; }
 	const char *text(running_machine &machine) { return ""; }
+	void dump(emu_file &file) { }
 
 	// enable/disable
 	void enable(bool state = true) { }
 
+	// dynamic scopes, found or created by name
+	profile_type scope(const char *name) { return PROFILER_TOTAL; }
+	void release_scopes() { }
+
 	// start/stop
 	void start(profile_type type) { }
 	void stop() { }
+
+	// event counting
+	void count(profile_type type, UINT64 amount = 1) { }
 };
 
 
@@ -0,0 +1,355 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    resample.h
+
+    Sample rate conversion and mixing kernels for sound streams.
+
+****************************************************************************
+
+    These are the inner loops used by sound_stream to convert an input
+    to the stream's own sample rate, and by the mixers to sum and clamp
+    the results. They work on raw buffers only, so they can be timed
+    outside of a running machine (see src/tools/sndbench.c).
+
+    Positions within a source buffer are tracked as a fraction of a
+    sample with RESAMPLE_FRAC_BITS bits, and advanced by a step with the
+    same precision: the ratio of the source rate to the destination
+    rate.
+
+    Two resamplers are provided:
+
+        - the linear one, which point samples and blends across sample
+          boundaries when upsampling, and averages all the covered
+          samples when downsampling
+
+        - the band-limited one, which applies a windowed sinc filter
+          from a table of RESAMPLE_PHASES precomputed phases; this is
+          used when -resample_quality is 1 and the rates are within a
+          factor of RESAMPLE_MAX_RATIO of each other
+
+    Gain is applied separately by stream_scale_samples, which gives
+    exactly the same results as scaling each sample as it is produced.
+
+    With SSE2 available (the same conditions as rgbutil.h), the scaling,
+    mixing, clamping and filtering loops are vectorized; elsewhere they
+    fall back to plain C.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __RESAMPLE_H__
+#define __RESAMPLE_H__
+
+#include "osdcomm.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI                    3.14159265358979323846
+#endif
+
+// use SSE on 64-bit implementations, where it can be assumed
+#if (!defined(MAME_DEBUG) || defined(__OPTIMIZE__)) && (defined(__SSE2__) || defined(_MSC_VER)) && defined(PTR64)
+#define RESAMPLE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+// fractional sample positions
+const UINT32 RESAMPLE_FRAC_BITS = 22;
+const UINT32 RESAMPLE_FRAC_ONE = 1 << RESAMPLE_FRAC_BITS;
+const UINT32 RESAMPLE_FRAC_MASK = RESAMPLE_FRAC_ONE - 1;
+
+// band-limited filter tables
+const int RESAMPLE_PHASE_BITS = 8;
+const int RESAMPLE_PHASES = 1 << RESAMPLE_PHASE_BITS;
+const int RESAMPLE_BASE_TAPS = 16;
+const int RESAMPLE_MAX_RATIO = 4;
+const int RESAMPLE_MAX_TAPS = RESAMPLE_BASE_TAPS * RESAMPLE_MAX_RATIO;
+
+
+
+//**************************************************************************
+//  RESAMPLING
+//**************************************************************************
+
+//-------------------------------------------------
+//  stream_resample_linear - convert numsamples
+//  samples starting at fraction basefrac of the
+//  first source sample, without applying gain
+//-------------------------------------------------
+
+inline void stream_resample_linear(INT32 *dest, const INT32 *source, UINT32 numsamples, UINT32 basefrac, UINT32 step)
+{
+	// if we have equal sample rates, we just need to copy
+	if (step == RESAMPLE_FRAC_ONE)
+		memcpy(dest, source, numsamples * sizeof(*dest));
+
+	// input is undersampled: point sample except where our sample period covers a boundary
+	else if (step < RESAMPLE_FRAC_ONE)
+	{
+		while (numsamples != 0)
+		{
+			// fill in with point samples until we hit a boundary
+			int nextfrac = 0;
+			while (numsamples != 0 && (nextfrac = basefrac + step) < RESAMPLE_FRAC_ONE)
+			{
+				*dest++ = source[0];
+				basefrac = nextfrac;
+				numsamples--;
+			}
+
+			// if we're done, we're done; don't run past the end to the boundary
+			if (numsamples-- == 0)
+				break;
+
+			// compute starting and ending fractional positions
+			int startfrac = basefrac >> (RESAMPLE_FRAC_BITS - 12);
+			int endfrac = nextfrac >> (RESAMPLE_FRAC_BITS - 12);
+
+			// blend between the two samples accordingly
+			*dest++ = ((INT64) source[0] * (0x1000 - startfrac) + (INT64) source[1] * (endfrac - 0x1000)) / (endfrac - startfrac);
+
+			// advance
+			basefrac = nextfrac & RESAMPLE_FRAC_MASK;
+			source++;
+		}
+	}
+
+	// input is oversampled: sum the energy
+	else
+	{
+		// use 8 bits to allow some extra headroom
+		int smallstep = step >> (RESAMPLE_FRAC_BITS - 8);
+		while (numsamples--)
+		{
+			INT64 remainder = smallstep;
+			int tpos = 0;
+
+			// compute the sample
+			INT64 scale = (RESAMPLE_FRAC_ONE - basefrac) >> (RESAMPLE_FRAC_BITS - 8);
+			INT64 sample = (INT64) source[tpos++] * scale;
+			remainder -= scale;
+			while (remainder > 0x100)
+			{
+				sample += (INT64) source[tpos++] * (INT64) 0x100;
+				remainder -= 0x100;
+			}
+			sample += (INT64) source[tpos] * remainder;
+			*dest++ = sample / smallstep;
+
+			// advance
+			basefrac += step;
+			source += basefrac >> RESAMPLE_FRAC_BITS;
+			basefrac &= RESAMPLE_FRAC_MASK;
+		}
+	}
+}
+
+
+//-------------------------------------------------
+//  stream_resample_taps - return the number of
+//  filter taps needed for the band-limited
+//  resampler at a given step, or 0 if the rates
+//  are too far apart for it
+//-------------------------------------------------
+
+inline int stream_resample_taps(UINT32 step)
+{
+	// upsampling only needs enough taps to cover the source's own band
+	if (step <= RESAMPLE_FRAC_ONE)
+		return RESAMPLE_BASE_TAPS;
+
+	// downsampling needs proportionally more, up to a point
+	UINT32 ratio = (step + RESAMPLE_FRAC_MASK) >> RESAMPLE_FRAC_BITS;
+	return (ratio <= RESAMPLE_MAX_RATIO) ? RESAMPLE_BASE_TAPS * ratio : 0;
+}
+
+
+//-------------------------------------------------
+//  stream_build_resample_filter - compute the
+//  RESAMPLE_PHASES x taps table of coefficients
+//  for the band-limited resampler at a given step
+//-------------------------------------------------
+
+inline void stream_build_resample_filter(float *filter, int taps, UINT32 step)
+{
+	// cut off a little below the lower of the two Nyquist frequencies
+	double cutoff = 0.9;
+	if (step > RESAMPLE_FRAC_ONE)
+		cutoff *= double(RESAMPLE_FRAC_ONE) / double(step);
+	double halfwidth = double(taps / 2);
+
+	for (int phase = 0; phase < RESAMPLE_PHASES; phase++)
+	{
+		// tap 0 is (taps/2 - 1) samples before the current source sample
+		double frac = (double(phase) + 0.5) / double(RESAMPLE_PHASES);
+		float *coeff = &filter[phase * taps];
+		double total = 0;
+		for (int tap = 0; tap < taps; tap++)
+		{
+			// Blackman-windowed sinc
+			double distance = double(tap - (taps / 2 - 1)) - frac;
+			double x = distance / halfwidth;
+			double window = (fabs(x) >= 1.0) ? 0.0 : (0.42 + 0.5 * cos(M_PI * x) + 0.08 * cos(2.0 * M_PI * x));
+			double arg = M_PI * cutoff * distance;
+			double sinc = (fabs(arg) < 1e-9) ? 1.0 : (sin(arg) / arg);
+			double value = cutoff * sinc * window;
+			coeff[tap] = float(value);
+			total += value;
+		}
+
+		// normalize so that each phase passes DC unchanged
+		for (int tap = 0; tap < taps; tap++)
+			coeff[tap] = float(coeff[tap] / total);
+	}
+}
+
+
+//-------------------------------------------------
+//  stream_resample_bandlimited - convert
+//  numsamples samples using a filter table from
+//  stream_build_resample_filter; source points
+//  to the first tap, (taps/2 - 1) samples before
+//  the first source sample
+//-------------------------------------------------
+
+inline void stream_resample_bandlimited(INT32 *dest, const INT32 *source, UINT32 numsamples, UINT32 basefrac, UINT32 step, const float *filter, int taps)
+{
+	while (numsamples--)
+	{
+		const float *coeff = &filter[(basefrac >> (RESAMPLE_FRAC_BITS - RESAMPLE_PHASE_BITS)) * taps];
+
+		// apply the filter for this phase; taps is always a multiple of 4
+#ifdef RESAMPLE_SSE2
+		__m128 acc = _mm_setzero_ps();
+		for (int tap = 0; tap < taps; tap += 4)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&source[tap])), _mm_loadu_ps(&coeff[tap])));
+		acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+		acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+		float sum = _mm_cvtss_f32(acc);
+#else
+		float sum = 0;
+		for (int tap = 0; tap < taps; tap++)
+			sum += float(source[tap]) * coeff[tap];
+#endif
+
+		// round, and keep ringing from overflowing
+		sum = floorf(sum + 0.5f);
+		if (sum > 2147483520.0f)
+			*dest++ = 2147483520;
+		else if (sum < -2147483520.0f)
+			*dest++ = -2147483520;
+		else
+			*dest++ = INT32(sum);
+
+		// advance
+		basefrac += step;
+		source += basefrac >> RESAMPLE_FRAC_BITS;
+		basefrac &= RESAMPLE_FRAC_MASK;
+	}
+}
+
+
+
+//**************************************************************************
+//  MIXING
+//**************************************************************************
+
+//-------------------------------------------------
+//  stream_scale_samples - apply an 8.8 gain to a
+//  buffer of samples in place
+//-------------------------------------------------
+
+inline void stream_scale_samples(INT32 *dest, int count, INT64 gain)
+{
+	// unity gain leaves everything alone
+	if (gain == 0x100)
+		return;
+
+#ifdef RESAMPLE_SSE2
+	// there's no signed 32x32 multiply, so work on magnitudes; a negative sample
+	// rounds its magnitude up, to match the arithmetic shift below
+	if (gain >= 0 && gain <= 0xffffffff)
+	{
+		const __m128i vgain = _mm_set1_epi32(UINT32(gain));
+		const __m128i round = _mm_set_epi32(0, 0xff, 0, 0xff);
+		const __m128i lowmask = _mm_set_epi32(0, -1, 0, -1);
+		for ( ; count >= 4; count -= 4, dest += 4)
+		{
+			__m128i sample = _mm_loadu_si128((const __m128i *)dest);
+			__m128i sign = _mm_srai_epi32(sample, 31);
+			__m128i mag = _mm_sub_epi32(_mm_xor_si128(sample, sign), sign);
+
+			// samples 0 and 2, then 1 and 3, as 64-bit products
+			__m128i even = _mm_mul_epu32(mag, vgain);
+			even = _mm_srli_epi64(_mm_add_epi64(even, _mm_and_si128(sign, round)), 8);
+			__m128i odd = _mm_mul_epu32(_mm_srli_epi64(mag, 32), vgain);
+			odd = _mm_srli_epi64(_mm_add_epi64(odd, _mm_and_si128(_mm_srli_epi64(sign, 32), round)), 8);
+
+			// put the low halves back together and restore the signs
+			__m128i result = _mm_or_si128(_mm_and_si128(even, lowmask), _mm_slli_epi64(odd, 32));
+			_mm_storeu_si128((__m128i *)dest, _mm_sub_epi32(_mm_xor_si128(result, sign), sign));
+		}
+	}
+#endif
+
+	for ( ; count > 0; count--, dest++)
+		*dest = (*dest * gain) >> 8;
+}
+
+
+//-------------------------------------------------
+//  stream_add_samples - add a buffer of samples
+//  into another
+//-------------------------------------------------
+
+inline void stream_add_samples(INT32 *dest, const INT32 *source, int count)
+{
+#ifdef RESAMPLE_SSE2
+	for ( ; count >= 4; count -= 4, dest += 4, source += 4)
+		_mm_storeu_si128((__m128i *)dest, _mm_add_epi32(_mm_loadu_si128((const __m128i *)dest), _mm_loadu_si128((const __m128i *)source)));
+#endif
+
+	for ( ; count > 0; count--)
+		*dest++ += *source++;
+}
+
+
+//-------------------------------------------------
+//  stream_clamp_interleave - clamp left and right
+//  mixes to 16 bits and interleave them
+//-------------------------------------------------
+
+inline void stream_clamp_interleave(INT16 *dest, const INT32 *left, const INT32 *right, int count)
+{
+#ifdef RESAMPLE_SSE2
+	// the saturating packs do the clamping for us
+	for ( ; count >= 8; count -= 8, dest += 16, left += 8, right += 8)
+	{
+		__m128i l = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)&left[0]), _mm_loadu_si128((const __m128i *)&left[4]));
+		__m128i r = _mm_packs_epi32(_mm_loadu_si128((const __m128i *)&right[0]), _mm_loadu_si128((const __m128i *)&right[4]));
+		_mm_storeu_si128((__m128i *)&dest[0], _mm_unpacklo_epi16(l, r));
+		_mm_storeu_si128((__m128i *)&dest[8], _mm_unpackhi_epi16(l, r));
+	}
+#endif
+
+	for ( ; count > 0; count--)
+	{
+		INT32 samp = *left++;
+		*dest++ = (samp < -32768) ? -32768 : (samp > 32767) ? 32767 : samp;
+		samp = *right++;
+		*dest++ = (samp < -32768) ? -32768 : (samp > 32767) ? 32767 : samp;
+	}
+}
+
+
+#endif  /* __RESAMPLE_H__ */
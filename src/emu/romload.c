@@ -28,6 +28,10 @@
 
 #define TEMPBUFFER_MAX_SIZE     (1024 * 1024 * 1024)
 
+/* how far ahead of the loader files are opened, read and hashed */
+#define PREFETCH_MAX_FILES      (16)
+#define PREFETCH_MAX_BYTES      (256 * 1024 * 1024)
+
 
 
 /***************************************************************************
@@ -57,6 +61,24 @@ private:
 };
 
 
+struct rom_prefetch
+{
+	const rom_entry *   romp;               /* ROM_LOAD entry for the file */
+	const char *        regiontag;          /* location tag to search */
+	emu_file *          file;               /* file, once opened; NULL if not found */
+	astring             tried_file_names;   /* places we looked for it */
+	osd_work_item *     item;               /* work item reading and hashing it */
+	bool                mappable;           /* true if the file may be mapped instead of read */
+};
+
+
+struct region_fixup
+{
+	memory_region *     region;             /* region to post-process */
+	bool                invert;             /* true to invert the data */
+};
+
+
 struct romload_private
 {
 	running_machine &machine() const { assert(m_machine != NULL); return *m_machine; }
@@ -77,6 +99,18 @@ struct romload_private
 
 	memory_region * region;             /* info about current region */
 
+	osd_work_queue *prefetch_queue;     /* queue for reading files and fixing up regions */
+	dynamic_array<rom_prefetch> prefetch; /* every file to be loaded, in load order */
+	int             prefetch_opened;    /* number of files opened so far */
+	int             prefetch_taken;     /* number of files handed to the loader */
+	UINT64          prefetch_bytes;     /* size of files opened but not yet taken */
+	dynamic_array<region_fixup> fixups; /* regions being post-processed */
+	int             fixups_queued;      /* number of fixups in use */
+
+	const rom_entry *pending_romp;      /* ROM whose file was opened ahead of its region */
+	emu_file *      pending_file;       /* that file, or NULL if it wasn't found */
+	astring         pending_tried;      /* places we looked for it */
+
 	astring         errorstring;        /* error string */
 	astring         softwarningstring;  /* software warning string */
 };
@@ -104,9 +138,9 @@ file_error common_process_file(emu_options &options, const char *location, const
 	return filerr;
 }
 
-file_error common_process_file(emu_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file)
+file_error common_process_file(emu_options &options, const char *location, bool has_crc, UINT32 crc, const rom_entry *romp, emu_file **image_file, UINT32 openflags)
 {
-	*image_file = global_alloc(emu_file(options.media_path(), OPEN_FLAG_READ));
+	*image_file = global_alloc(emu_file(options.media_path(), openflags));
 	file_error filerr;
 
 	if (has_crc)
@@ -141,6 +175,21 @@ chd_file *get_disk_handle(running_machine &machine, const char *region)
 }
 
 
+/*-------------------------------------------------
+    configure_disk_cache - set up the hunk cache
+    for a newly opened CHD; CHDs that can't be
+    cached (lossy or writeable ones) simply read
+    as before
+-------------------------------------------------*/
+
+static void configure_disk_cache(emu_options &options, chd_file &chd)
+{
+	chd_error err = chd.cache_configure(options.chd_cache(), options.chd_readahead());
+	if (err != CHDERR_NONE && err != CHDERR_NOT_SUPPORTED)
+		osd_printf_verbose("Unable to set up the CHD cache: %s\n", chd_file::error_string(err));
+}
+
+
 /*-------------------------------------------------
     set_disk_handle - set a pointer to the CHD
     file associated with the given region
@@ -151,7 +200,10 @@ int set_disk_handle(running_machine &machine, const char *region, const char *fu
 	open_chd *chd = global_alloc(open_chd(region));
 	chd_error err = chd->orig_chd().open(fullpath);
 	if (err == CHDERR_NONE)
+	{
+		configure_disk_cache(machine.options(), chd->orig_chd());
 		machine.romload_data->chd_list.append(*chd);
+	}
 	else
 		global_free(chd);
 	return err;
@@ -488,7 +540,7 @@ static void dump_wrong_and_correct_checksums(romload_private *romdata, const has
     and hash signatures of a file
 -------------------------------------------------*/
 
-static void verify_length_and_hash(romload_private *romdata, const char *name, UINT32 explength, const hash_collection &hashes)
+static void verify_length_and_hash(romload_private *romdata, const char *name, UINT32 explength, const hash_collection &hashes, const UINT8 *data = NULL)
 {
 	/* we've already complained if there is no file */
 	if (romdata->file == NULL)
@@ -504,7 +556,7 @@ static void verify_length_and_hash(romload_private *romdata, const char *name, U
 
 	/* If there is no good dump known, write it */
 	astring tempstr;
-	hash_collection &acthashes = romdata->file->hashes(hashes.hash_types(tempstr));
+	hash_collection &acthashes = g_hash_cache.hashes(*romdata->file, hashes.hash_types(tempstr), data);
 	if (hashes.flag(hash_collection::FLAG_NO_DUMP))
 	{
 		romdata->errorstring.catprintf("%s NO GOOD DUMP KNOWN\n", name);
@@ -576,20 +628,15 @@ static void display_rom_load_results(romload_private *romdata, bool from_list)
 
 
 /*-------------------------------------------------
-    region_post_process - post-process a region,
-    byte swapping and inverting data as necessary
+    post_process_region_data - byte swap and
+    invert a region's data as necessary
 -------------------------------------------------*/
 
-static void region_post_process(romload_private *romdata, const char *rgntag, bool invert)
+static void post_process_region_data(memory_region *region, bool invert)
 {
-	memory_region *region = romdata->machine().root_device().memregion(rgntag);
 	UINT8 *base;
 	int i, j;
 
-	// do nothing if no region
-	if (region == NULL)
-		return;
-
 	LOG(("+ datawidth=%dbit endian=%s\n", region->bitwidth(),
 			region->endianness() == ENDIANNESS_LITTLE ? "little" : "big"));
 
@@ -617,6 +664,60 @@ static void region_post_process(romload_private *romdata, const char *rgntag, bo
 }
 
 
+/*-------------------------------------------------
+    region_post_process - post-process a region,
+    byte swapping and inverting data as necessary
+-------------------------------------------------*/
+
+static void region_post_process(romload_private *romdata, const char *rgntag, bool invert)
+{
+	memory_region *region = romdata->machine().root_device().memregion(rgntag);
+
+	// do nothing if no region
+	if (region != NULL)
+		post_process_region_data(region, invert);
+}
+
+
+/*-------------------------------------------------
+    region_post_process_callback - post-process
+    a region on a worker thread
+-------------------------------------------------*/
+
+static void *region_post_process_callback(void *param, int threadid)
+{
+	region_fixup *fixup = (region_fixup *)param;
+	post_process_region_data(fixup->region, fixup->invert);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    queue_region_post_process - post-process a
+    region in the background if there is
+    anything to do
+-------------------------------------------------*/
+
+static void queue_region_post_process(romload_private *romdata, memory_region *region, bool invert)
+{
+	// nothing to do unless the data is inverted or in the wrong order
+	if (region == NULL || (!invert && (region->bytewidth() == 1 || region->endianness() == ENDIANNESS_NATIVE)))
+		return;
+
+	// do it here if there is no queue
+	if (romdata->prefetch_queue == NULL || romdata->fixups_queued >= romdata->fixups.count())
+	{
+		post_process_region_data(region, invert);
+		return;
+	}
+
+	region_fixup &fixup = romdata->fixups[romdata->fixups_queued++];
+	fixup.region = region;
+	fixup.invert = invert;
+	osd_work_item_queue(romdata->prefetch_queue, region_post_process_callback, &fixup, WORK_ITEM_FLAG_AUTO_RELEASE);
+}
+
+
 /*-------------------------------------------------
     open_rom_file - open a ROM file, searching
     up the parent and loading by checksum
@@ -642,7 +743,7 @@ static int open_rom_file(romload_private *romdata, const char *regiontag, const
 		if(tried_file_names.len() != 0)
 			tried_file_names += " ";
 		tried_file_names += driver_list::driver(drv).name;
-		filerr = common_process_file(romdata->machine().options(), driver_list::driver(drv).name, has_crc, crc, romp, &romdata->file);
+		filerr = common_process_file(romdata->machine().options(), driver_list::driver(drv).name, has_crc, crc, romp, &romdata->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 	}
 
 	/* if the region is load by name, load the ROM from there */
@@ -695,7 +796,7 @@ static int open_rom_file(romload_private *romdata, const char *regiontag, const
 		if (!is_list)
 		{
 			tried_file_names += " " + tag1;
-			filerr = common_process_file(romdata->machine().options(), tag1.cstr(), has_crc, crc, romp, &romdata->file);
+			filerr = common_process_file(romdata->machine().options(), tag1.cstr(), has_crc, crc, romp, &romdata->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 		}
 		else
 		{
@@ -703,25 +804,25 @@ static int open_rom_file(romload_private *romdata, const char *regiontag, const
 			if ((romdata->file == NULL) && (tag2.cstr() != NULL))
 			{
 				tried_file_names += " " + tag2;
-				filerr = common_process_file(romdata->machine().options(), tag2.cstr(), has_crc, crc, romp, &romdata->file);
+				filerr = common_process_file(romdata->machine().options(), tag2.cstr(), has_crc, crc, romp, &romdata->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 			}
 			// try to load from list/parentname
 			if ((romdata->file == NULL) && has_parent && (tag3.cstr() != NULL))
 			{
 				tried_file_names += " " + tag3;
-				filerr = common_process_file(romdata->machine().options(), tag3.cstr(), has_crc, crc, romp, &romdata->file);
+				filerr = common_process_file(romdata->machine().options(), tag3.cstr(), has_crc, crc, romp, &romdata->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 			}
 			// try to load from setname
 			if ((romdata->file == NULL) && (tag4.cstr() != NULL))
 			{
 				tried_file_names += " " + tag4;
-				filerr = common_process_file(romdata->machine().options(), tag4.cstr(), has_crc, crc, romp, &romdata->file);
+				filerr = common_process_file(romdata->machine().options(), tag4.cstr(), has_crc, crc, romp, &romdata->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 			}
 			// try to load from parentname
 			if ((romdata->file == NULL) && has_parent && (tag5.cstr() != NULL))
 			{
 				tried_file_names += " " + tag5;
-				filerr = common_process_file(romdata->machine().options(), tag5.cstr(), has_crc, crc, romp, &romdata->file);
+				filerr = common_process_file(romdata->machine().options(), tag5.cstr(), has_crc, crc, romp, &romdata->file, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD);
 			}
 		}
 	}
@@ -735,6 +836,268 @@ static int open_rom_file(romload_private *romdata, const char *regiontag, const
 }
 
 
+/*-------------------------------------------------
+    mappable_rom - return the ROM entry if a
+    region is loaded from a single file that could
+    be mapped into memory as-is, or NULL if not
+-------------------------------------------------*/
+
+static const rom_entry *mappable_rom(romload_private *romdata, device_t &device, const rom_entry *region)
+{
+	if (!romdata->machine().options().map_roms() || !ROMREGION_ISROMDATA(region))
+		return NULL;
+
+	// it has to be the region's only entry, covering the whole thing
+	const rom_entry *romp = region + 1;
+	if (!ROMENTRY_ISFILE(romp) || !ROMENTRY_ISREGIONEND(romp + 1))
+		return NULL;
+	if (ROM_GETOFFSET(romp) != 0 || ROM_GETLENGTH(romp) != ROMREGION_GETLENGTH(region))
+		return NULL;
+
+	// and the bytes must land in memory in file order
+	if (ROM_INHERITSFLAGS(romp) || ROM_GETGROUPSIZE(romp) != 1 || ROM_GETSKIPCOUNT(romp) != 0 || ROM_ISREVERSED(romp) || ROM_GETBITWIDTH(romp) != 8 || ROM_GETBITSHIFT(romp) != 0)
+		return NULL;
+	if (ROM_GETBIOSFLAGS(romp) != 0 && ROM_GETBIOSFLAGS(romp) != device.system_bios())
+		return NULL;
+	return romp;
+}
+
+
+/*-------------------------------------------------
+    prefetch_callback - decompress and hash a ROM
+    file on a worker thread
+-------------------------------------------------*/
+
+static void *prefetch_callback(void *param, int threadid)
+{
+	rom_prefetch *entry = (rom_prefetch *)param;
+	astring tempstr;
+
+	// load the data out of the archive here, even if the hash cache means nothing needs hashing
+	if (!entry->file->preload())
+		return NULL;
+
+	// then compute whatever hashes the archive and the cache didn't supply
+	g_hash_cache.hashes(*entry->file, hash_collection(ROM_GETHASHDATA(entry->romp)).hash_types(tempstr));
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    prefetch_rom_files - open files ahead of the
+    loader, and queue reading and hashing them
+-------------------------------------------------*/
+
+static void prefetch_rom_files(romload_private *romdata)
+{
+	while (romdata->prefetch_opened < romdata->prefetch.count())
+	{
+		// keep the window bounded, but always allow the file about to be loaded
+		int inflight = romdata->prefetch_opened - romdata->prefetch_taken;
+		if (inflight > 0)
+		{
+			if (inflight >= PREFETCH_MAX_FILES || romdata->prefetch_bytes >= PREFETCH_MAX_BYTES)
+				break;
+		}
+
+		// open on this thread, so the search order and messages stay the same
+		rom_prefetch &entry = romdata->prefetch[romdata->prefetch_opened++];
+		LOG(("Opening ROM file: %s\n", ROM_GETNAME(entry.romp)));
+		open_rom_file(romdata, entry.regiontag, entry.romp, entry.tried_file_names, false);
+		entry.file = romdata->file;
+		romdata->file = NULL;
+		romdata->prefetch_bytes += rom_file_size(entry.romp);
+
+		// .7z files are decompressed together by take_rom_file, and mapped files aren't read at all
+		if (entry.file != NULL && !entry.file->from_7z() && !entry.mappable)
+			entry.item = osd_work_item_queue(romdata->prefetch_queue, prefetch_callback, &entry, 0);
+	}
+}
+
+
+/*-------------------------------------------------
+    preload_7z_files - decompress every file in
+    the prefetch window that comes from the same
+    .7z as the one about to be loaded, so that
+    each solid block is decoded only once
+-------------------------------------------------*/
+
+static void preload_7z_files(romload_private *romdata, int first)
+{
+	dynamic_array<emu_file *> files;
+	for (int filenum = first; filenum < romdata->prefetch_opened; filenum++)
+		if (romdata->prefetch[filenum].file != NULL && romdata->prefetch[filenum].file->from_7z())
+			files.append() = romdata->prefetch[filenum].file;
+	emu_file::preload_7z(files, files.count());
+}
+
+
+/*-------------------------------------------------
+    take_rom_file - get the next file for the
+    loader, from the prefetch list if it is there
+    or by opening it now if not
+-------------------------------------------------*/
+
+static int take_rom_file(romload_private *romdata, const char *regiontag, const rom_entry *romp, astring &tried_file_names, bool from_list)
+{
+	// if we opened this one before allocating its region, use that
+	if (romdata->pending_romp == romp)
+	{
+		romdata->file = romdata->pending_file;
+		tried_file_names = romdata->pending_tried;
+		romdata->pending_romp = NULL;
+		romdata->pending_file = NULL;
+		return (romdata->file != NULL);
+	}
+
+	// top up the window first so the workers stay busy while we load this one
+	if (romdata->prefetch_queue != NULL)
+		prefetch_rom_files(romdata);
+
+	// if this isn't the file we expected, open it the old way
+	if (romdata->prefetch_taken >= romdata->prefetch_opened || romdata->prefetch[romdata->prefetch_taken].romp != romp)
+	{
+		LOG(("Opening ROM file: %s\n", ROM_GETNAME(romp)));
+		return open_rom_file(romdata, regiontag, romp, tried_file_names, from_list);
+	}
+
+	// a .7z member brings the rest of its archive in the window along with it
+	if (romdata->prefetch[romdata->prefetch_taken].file != NULL && romdata->prefetch[romdata->prefetch_taken].file->from_7z())
+		preload_7z_files(romdata, romdata->prefetch_taken);
+
+	// wait for the worker to finish with it
+	rom_prefetch &entry = romdata->prefetch[romdata->prefetch_taken++];
+	romdata->prefetch_bytes -= rom_file_size(romp);
+	if (entry.item != NULL)
+	{
+		while (!osd_work_item_wait(entry.item, osd_ticks_per_second()))
+			;
+		osd_work_item_release(entry.item);
+		entry.item = NULL;
+	}
+
+	// hand it over
+	romdata->file = entry.file;
+	entry.file = NULL;
+	tried_file_names = entry.tried_file_names;
+	return (romdata->file != NULL);
+}
+
+
+/*-------------------------------------------------
+    map_rom_region - create a region by mapping
+    its file into memory; if that isn't possible,
+    leave the file for process_rom_entries
+-------------------------------------------------*/
+
+static memory_region *map_rom_region(romload_private *romdata, const char *regiontag, const rom_entry *romp, device_t &device, UINT8 width, endianness_t endianness)
+{
+	astring tried_file_names;
+	memory_region *region = NULL;
+
+	// only loose files of exactly the right size can be mapped
+	if (take_rom_file(romdata, device.shortname(), romp, tried_file_names, false))
+		if (!romdata->file->from_zip() && !romdata->file->from_7z() && romdata->file->size() == ROM_GETLENGTH(romp))
+			region = romdata->machine().memory().region_map(regiontag, romdata->file->fullpath(), ROM_GETLENGTH(romp), width, endianness);
+
+	// if not, hand the file over to be read as usual
+	if (region == NULL)
+	{
+		romdata->pending_romp = romp;
+		romdata->pending_file = romdata->file;
+		romdata->pending_tried = tried_file_names;
+		romdata->file = NULL;
+		return NULL;
+	}
+
+	// verify it from the mapping, and we're done with the file
+	LOG(("Mapped %X bytes @ %p\n", region->bytes(), region->base()));
+	verify_length_and_hash(romdata, ROM_GETNAME(romp), ROM_GETLENGTH(romp), hash_collection(ROM_GETHASHDATA(romp)), region->base());
+	global_free(romdata->file);
+	romdata->file = NULL;
+	return region;
+}
+
+
+/*-------------------------------------------------
+    prefetch_start - build the list of files to
+    load and start the worker queue
+-------------------------------------------------*/
+
+static void prefetch_start(romload_private *romdata)
+{
+	int regions = 0;
+
+	romdata->prefetch_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	romdata->prefetch.reset();
+	romdata->prefetch_opened = romdata->prefetch_taken = 0;
+	romdata->prefetch_bytes = 0;
+
+	// list the files in the order process_rom_entries will ask for them
+	device_iterator deviter(romdata->machine().root_device());
+	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
+		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
+		{
+			regions++;
+			if (ROMREGION_ISROMDATA(region))
+				for (const rom_entry *romp = rom_first_file(region); romp != NULL; romp = rom_next_file(romp))
+					if (ROM_GETBIOSFLAGS(romp) == 0 || ROM_GETBIOSFLAGS(romp) == device->system_bios())
+					{
+						rom_prefetch &entry = romdata->prefetch.append();
+						entry.romp = romp;
+						entry.regiontag = device->shortname();
+						entry.file = NULL;
+						entry.tried_file_names.reset();
+						entry.item = NULL;
+						entry.mappable = (mappable_rom(romdata, *device, region) == romp);
+					}
+		}
+
+	// one fixup slot per region; the array must not move once items are queued
+	romdata->fixups.resize(regions);
+	romdata->fixups_queued = 0;
+}
+
+
+/*-------------------------------------------------
+    prefetch_stop - wait for the workers and
+    free anything the loader didn't take
+-------------------------------------------------*/
+
+static void prefetch_stop(romload_private *romdata)
+{
+	if (romdata->prefetch_queue != NULL)
+	{
+		// wait for the remaining items; fixups release themselves
+		for (int filenum = romdata->prefetch_taken; filenum < romdata->prefetch_opened; filenum++)
+			if (romdata->prefetch[filenum].item != NULL)
+			{
+				while (!osd_work_item_wait(romdata->prefetch[filenum].item, osd_ticks_per_second()))
+					;
+				osd_work_item_release(romdata->prefetch[filenum].item);
+			}
+		while (!osd_work_queue_wait(romdata->prefetch_queue, osd_ticks_per_second()))
+			;
+		osd_work_queue_free(romdata->prefetch_queue);
+		romdata->prefetch_queue = NULL;
+	}
+
+	// close files that were opened but never loaded
+	for (int filenum = romdata->prefetch_taken; filenum < romdata->prefetch_opened; filenum++)
+		global_free(romdata->prefetch[filenum].file);
+	romdata->prefetch.reset();
+	romdata->prefetch_opened = romdata->prefetch_taken = 0;
+	romdata->prefetch_bytes = 0;
+	romdata->fixups.reset();
+	romdata->fixups_queued = 0;
+
+	// and one opened ahead of its region
+	global_free(romdata->pending_file);
+	romdata->pending_file = NULL;
+	romdata->pending_romp = NULL;
+}
+
+
 /*-------------------------------------------------
     rom_fread - cheesy fread that fills with
     random data for a NULL file
@@ -965,9 +1328,8 @@ static void process_rom_entries(romload_private *romdata, const char *regiontag,
 			int explength = 0;
 
 			/* open the file if it is a non-BIOS or matches the current BIOS */
-			LOG(("Opening ROM file: %s\n", ROM_GETNAME(romp)));
 			astring tried_file_names;
-			if (!irrelevantbios && !open_rom_file(romdata, regiontag, romp, tried_file_names, from_list))
+			if (!irrelevantbios && !take_rom_file(romdata, regiontag, romp, tried_file_names, from_list))
 				handle_missing_file(romdata, romp, tried_file_names, CHDERR_NONE);
 
 			/* loop until we run out of reloads */
@@ -1281,6 +1643,7 @@ static void process_disk_entries(romload_private *romdata, const char *regiontag
 
 			/* we're okay, add to the list of disks */
 			LOG(("Assigning to handle %d\n", DISK_GETINDEX(romp)));
+			configure_disk_cache(romdata->machine().options(), chd->orig_chd());
 			romdata->machine().romload_data->chd_list.append(*chd);
 		}
 	}
@@ -1447,6 +1810,20 @@ void load_software_part_region(device_t &device, software_list_device &swlist, c
 }
 
 
+/*-------------------------------------------------
+    is_copy_source - return true if a ROM_COPY
+    reads from the given region
+-------------------------------------------------*/
+
+static bool is_copy_source(dynamic_array<astring> &copysources, const char *regiontag)
+{
+	for (int index = 0; index < copysources.count(); index++)
+		if (copysources[index] == regiontag)
+			return true;
+	return false;
+}
+
+
 /*-------------------------------------------------
     process_region_list - process a region list
 -------------------------------------------------*/
@@ -1455,8 +1832,19 @@ static void process_region_list(romload_private *romdata)
 {
 	astring regiontag;
 
-	/* loop until we hit the end */
+	/* start reading and hashing files in the background */
+	prefetch_start(romdata);
+
+	/* regions that ROM_COPY reads from must keep their raw data until everything is loaded */
+	dynamic_array<astring> copysources;
 	device_iterator deviter(romdata->machine().root_device());
+	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
+		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
+			for (const rom_entry *romp = region + 1; !ROMENTRY_ISREGIONEND(romp); romp++)
+				if (ROMENTRY_ISCOPY(romp))
+					romdata->machine().root_device().subtag(copysources.append(), ROM_GETNAME(romp));
+
+	/* loop until we hit the end */
 	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
 		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
 		{
@@ -1476,39 +1864,53 @@ static void process_region_list(romload_private *romdata)
 				if (romdata->machine().device(regiontag) != NULL)
 					normalize_flags_for_device(romdata->machine(), regiontag, width, endianness);
 
-				/* remember the base and length */
-				romdata->region = romdata->machine().memory().region_alloc(regiontag, regionlength, width, endianness);
-				LOG(("Allocated %X bytes @ %p\n", romdata->region->bytes(), romdata->region->base()));
+				/* if the whole region is one plain file, try mapping it straight in */
+				const rom_entry *maprom = mappable_rom(romdata, *device, region);
+				romdata->region = (maprom != NULL) ? map_rom_region(romdata, regiontag, maprom, *device, width, endianness) : NULL;
+				if (romdata->region == NULL)
+				{
+					/* remember the base and length */
+					romdata->region = romdata->machine().memory().region_alloc(regiontag, regionlength, width, endianness);
+					LOG(("Allocated %X bytes @ %p\n", romdata->region->bytes(), romdata->region->base()));
 
-				/* clear the region if it's requested */
-				if (ROMREGION_ISERASE(region))
-					memset(romdata->region->base(), ROMREGION_GETERASEVAL(region), romdata->region->bytes());
+					/* clear the region if it's requested */
+					if (ROMREGION_ISERASE(region))
+						memset(romdata->region->base(), ROMREGION_GETERASEVAL(region), romdata->region->bytes());
 
-				/* or if it's sufficiently small (<= 4MB) */
-				else if (romdata->region->bytes() <= 0x400000)
-					memset(romdata->region->base(), 0, romdata->region->bytes());
+					/* or if it's sufficiently small (<= 4MB) */
+					else if (romdata->region->bytes() <= 0x400000)
+						memset(romdata->region->base(), 0, romdata->region->bytes());
 
 #ifdef MAME_DEBUG
-				/* if we're debugging, fill region with random data to catch errors */
-				else
-					fill_random(romdata->machine(), romdata->region->base(), romdata->region->bytes());
+					/* if we're debugging, fill region with random data to catch errors */
+					else
+						fill_random(romdata->machine(), romdata->region->base(), romdata->region->bytes());
 #endif
 
-				/* now process the entries in the region */
-				process_rom_entries(romdata, device->shortname(), region, region + 1, device, FALSE);
+					/* now process the entries in the region */
+					process_rom_entries(romdata, device->shortname(), region, region + 1, device, FALSE);
+				}
+
+				/* nothing else writes here, so post-process it while the next region loads */
+				if (!is_copy_source(copysources, regiontag))
+					queue_region_post_process(romdata, romdata->region, ROMREGION_ISINVERTED(region));
 			}
 			else if (ROMREGION_ISDISKDATA(region))
 				process_disk_entries(romdata, regiontag, region, region + 1, NULL);
 		}
 
-	/* now go back and post-process all the regions */
+	/* now go back and post-process the regions that were copied from */
 	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
 		for (const rom_entry *region = rom_first_region(*device); region != NULL; region = rom_next_region(region))
 		{
 			rom_region_name(regiontag, *device, region);
-			region_post_process(romdata, regiontag, ROMREGION_ISINVERTED(region));
+			if (ROMREGION_ISROMDATA(region) && is_copy_source(copysources, regiontag))
+				queue_region_post_process(romdata, romdata->machine().root_device().memregion(regiontag), ROMREGION_ISINVERTED(region));
 		}
 
+	/* wait for the post-processing to finish */
+	prefetch_stop(romdata);
+
 	/* and finally register all per-game parameters */
 	for (device_t *device = deviter.first(); device != NULL; device = deviter.next())
 		for (const rom_entry *param = rom_first_parameter(*device); param != NULL; param = rom_next_parameter(param))
@@ -1561,8 +1963,12 @@ void rom_init(running_machine &machine)
 	/* reset the disk list */
 	romdata->chd_list.reset();
 
+	/* pick up any hashes remembered from earlier runs */
+	g_hash_cache.configure(machine.options());
+
 	/* process the ROM entries we were passed */
 	process_region_list(romdata);
+	g_hash_cache.flush();
 
 	/* display the results and exit */
 	display_rom_load_results(romdata, FALSE);
@@ -1575,6 +1981,20 @@ void rom_init(running_machine &machine)
 
 static void rom_exit(running_machine &machine)
 {
+	/* if loading failed partway, the workers may still have files */
+	prefetch_stop(machine.romload_data);
+
+	/* save any hashes computed for software loaded since */
+	g_hash_cache.flush();
+
+	/* report how the CHD caches did */
+	for (open_chd *curdisk = machine.romload_data->chd_list.first(); curdisk != NULL; curdisk = curdisk->next())
+	{
+		chd_cache_stats stats = curdisk->orig_chd().cache_stats();
+		if (stats.m_hits + stats.m_readahead_hits + stats.m_misses != 0)
+			osd_printf_verbose("CHD cache for '%s': %" I64FMT "u hits, %" I64FMT "u read-ahead hits (%" I64FMT "u waited), %" I64FMT "u misses; %" I64FMT "u hunks read ahead, %" I64FMT "u unused\n",
+					curdisk->region(), stats.m_hits, stats.m_readahead_hits, stats.m_readahead_waits, stats.m_misses, stats.m_readahead, stats.m_readahead_unused);
+	}
 }
 
 
@@ -11,11 +11,22 @@
     Save state file format:
 
     00..07  'MAMESAVE'
-    08      Format version (this is format 2)
+    08      Format version (this is format 3)
     09      Flags
     0A..1B  Game name padded with \0
     1C..1F  Signature
-    20..end Save game data (compressed)
+    20..23  Total size of the uncompressed data
+    24..27  Number of chunks
+    28..    Chunk index: uncompressed and compressed size of each chunk
+    ..end   Chunk data
+
+    The data is split into chunks of CHUNK_SIZE bytes, each compressed
+    on its own with zlib so that they can be processed in parallel. A
+    chunk whose compressed size equals its uncompressed size is stored
+    as-is. All values in the header and index are little-endian.
+
+    Format 2 files, which instead have the data compressed as a single
+    zlib stream starting at 20, can still be loaded.
 
     Data is always written as native-endian.
     Data is converted from the endiannness it was written upon load.
@@ -41,9 +52,13 @@
 //  CONSTANTS
 //**************************************************************************
 
-const int SAVE_VERSION      = 2;
+const int SAVE_VERSION      = 3;
+const int SAVE_VERSION_STREAMED = 2;
 const int HEADER_SIZE       = 32;
 
+// size of the independently compressed chunks
+const UINT32 CHUNK_SIZE     = 256 * 1024;
+
 // Available flags
 enum
 {
@@ -235,37 +250,154 @@ save_error save_manager::read_file(emu_file &file)
 	if (m_illegal_regs > 0)
 		return STATERR_ILLEGAL_REGISTRATIONS;
 
-	// read the header and turn on compression for the rest of the file
+	// read and verify the header and report an error if it doesn't match
+	UINT8 header[HEADER_SIZE];
+	save_error saverr = read_header(file, header);
+	if (saverr != STATERR_NONE)
+		return saverr;
+
+	// determine whether or not to flip the data when done
+	bool flip = NATIVE_ENDIAN_VALUE_LE_BE((header[9] & SS_MSB_FIRST) != 0, (header[9] & SS_MSB_FIRST) == 0);
+
+	// read the whole state image, then distribute it
+	dynamic_buffer data;
+	saverr = read_data(file, header, data);
+	if (saverr != STATERR_NONE)
+		return saverr;
+	UINT32 offset = 0;
+	for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
+	{
+		UINT32 entrysize = entry->m_typesize * entry->m_typecount;
+		memcpy(entry->m_data, (UINT8 *)data + offset, entrysize);
+		offset += entrysize;
+	}
+
+	// handle flipping
+	if (flip)
+		for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
+			entry->flip_data();
+
+	// call the post-load functions
+	dispatch_postload();
+
+	return STATERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  verify_file - read back a file we just wrote
+//  and check that it matches the current state
+//  without loading it
+//-------------------------------------------------
+
+save_error save_manager::verify_file(emu_file &file)
+{
+	// if we have illegal registrations, return an error
+	if (m_illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
+
+	// read the header and the state image
+	UINT8 header[HEADER_SIZE];
+	save_error saverr = read_header(file, header);
+	if (saverr != STATERR_NONE)
+		return saverr;
+	dynamic_buffer data;
+	saverr = read_data(file, header, data);
+	if (saverr != STATERR_NONE)
+		return saverr;
+
+	// gather the current state and compare
+	UINT32 totalsize = state_size();
+	dynamic_buffer current(totalsize);
+	saverr = write_buffer(current, totalsize);
+	if (saverr != STATERR_NONE)
+		return saverr;
+	if (totalsize > 0 && memcmp(current, data, totalsize) != 0)
+		return STATERR_READ_ERROR;
+	return STATERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  read_header - read and validate the header of
+//  a file
+//-------------------------------------------------
+
+save_error save_manager::read_header(emu_file &file, UINT8 *header)
+{
+	// the header is never compressed
 	file.compress(FCOMPRESS_NONE);
 	file.seek(0, SEEK_SET);
-	UINT8 header[HEADER_SIZE];
-	if (file.read(header, sizeof(header)) != sizeof(header))
+	if (file.read(header, HEADER_SIZE) != HEADER_SIZE)
 		return STATERR_READ_ERROR;
-	file.compress(FCOMPRESS_MEDIUM);
 
 	// verify the header and report an error if it doesn't match
 	UINT32 sig = signature();
 	if (validate_header(header, machine().system().name, sig, popmessage, "Error: ")  != STATERR_NONE)
 		return STATERR_INVALID_HEADER;
+	return STATERR_NONE;
+}
 
-	// determine whether or not to flip the data when done
-	bool flip = NATIVE_ENDIAN_VALUE_LE_BE((header[9] & SS_MSB_FIRST) != 0, (header[9] & SS_MSB_FIRST) == 0);
 
-	// read all the data, flipping if necessary
-	for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
+//-------------------------------------------------
+//  read_data - read the body of a file following
+//  the header into a flat state image, in the
+//  layout produced by write_buffer
+//-------------------------------------------------
+
+save_error save_manager::read_data(emu_file &file, const UINT8 *header, dynamic_buffer &data)
+{
+	UINT32 totalsize = state_size();
+	data.resize(totalsize);
+
+	// older files are a single compressed stream
+	if (header[8] == SAVE_VERSION_STREAMED)
 	{
-		UINT32 totalsize = entry->m_typesize * entry->m_typecount;
-		if (file.read(entry->m_data, totalsize) != totalsize)
+		file.compress(FCOMPRESS_MEDIUM);
+		if (totalsize > 0 && file.read(data, totalsize) != totalsize)
 			return STATERR_READ_ERROR;
-
-		// handle flipping
-		if (flip)
-			entry->flip_data();
+		return STATERR_NONE;
 	}
 
-	// call the post-load functions
-	dispatch_postload();
+	// newer files are a series of chunks, stored without stream compression
+	file.compress(FCOMPRESS_NONE);
 
+	// read the sizes and the index
+	UINT32 sizes[2];
+	if (file.read(sizes, sizeof(sizes)) != sizeof(sizes))
+		return STATERR_READ_ERROR;
+	UINT32 chunks = LITTLE_ENDIANIZE_INT32(sizes[1]);
+	if (LITTLE_ENDIANIZE_INT32(sizes[0]) != totalsize || chunks != (totalsize + CHUNK_SIZE - 1) / CHUNK_SIZE)
+		return STATERR_READ_ERROR;
+	dynamic_array<UINT32> index(chunks * 2);
+	if (chunks > 0 && file.read(index, chunks * 8) != chunks * 8)
+		return STATERR_READ_ERROR;
+
+	// read in all the compressed data
+	dynamic_array<state_chunk> chunk(chunks);
+	UINT32 compsize = 0;
+	for (UINT32 chunknum = 0; chunknum < chunks; chunknum++)
+	{
+		chunk[chunknum].m_rawsize = LITTLE_ENDIANIZE_INT32(index[chunknum * 2 + 0]);
+		chunk[chunknum].m_compsize = LITTLE_ENDIANIZE_INT32(index[chunknum * 2 + 1]);
+		if (chunk[chunknum].m_rawsize != MIN(CHUNK_SIZE, totalsize - chunknum * CHUNK_SIZE) || chunk[chunknum].m_compsize > chunk[chunknum].m_rawsize)
+			return STATERR_READ_ERROR;
+		compsize += chunk[chunknum].m_compsize;
+	}
+	dynamic_buffer compressed(compsize);
+	if (compsize > 0 && file.read(compressed, compsize) != compsize)
+		return STATERR_READ_ERROR;
+
+	// expand everything in parallel
+	UINT32 compoffs = 0;
+	for (UINT32 chunknum = 0; chunknum < chunks; chunknum++)
+	{
+		chunk[chunknum].m_raw = &data[chunknum * CHUNK_SIZE];
+		chunk[chunknum].m_comp = &compressed[compoffs];
+		compoffs += chunk[chunknum].m_compsize;
+	}
+	if (!process_chunks(chunk, expand_chunk))
+		return STATERR_READ_ERROR;
 	return STATERR_NONE;
 }
 
@@ -300,27 +432,255 @@ save_error save_manager::write_file(emu_file &file)
 	UINT32 sig = signature();
 	*(UINT32 *)&header[0x1c] = LITTLE_ENDIANIZE_INT32(sig);
 
-	// write the header and turn on compression for the rest of the file
+	// call the pre-save functions and gather up all the data
+	UINT32 totalsize = state_size();
+	dynamic_buffer data(totalsize);
+	save_error saverr = write_buffer(data, totalsize);
+	if (saverr != STATERR_NONE)
+		return saverr;
+
+	// compress the chunks in parallel; each one gets room for its worst case
+	UINT32 chunks = (totalsize + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	UINT32 bound = compressBound(CHUNK_SIZE);
+	dynamic_buffer compressed(chunks * bound);
+	dynamic_array<state_chunk> chunk(chunks);
+	for (UINT32 chunknum = 0; chunknum < chunks; chunknum++)
+	{
+		chunk[chunknum].m_raw = &data[chunknum * CHUNK_SIZE];
+		chunk[chunknum].m_rawsize = MIN(CHUNK_SIZE, totalsize - chunknum * CHUNK_SIZE);
+		chunk[chunknum].m_comp = &compressed[chunknum * bound];
+		chunk[chunknum].m_compsize = bound;
+	}
+	if (!process_chunks(chunk, compress_chunk))
+		return STATERR_WRITE_ERROR;
+
+	// build the index
+	UINT32 sizes[2];
+	sizes[0] = LITTLE_ENDIANIZE_INT32(totalsize);
+	sizes[1] = LITTLE_ENDIANIZE_INT32(chunks);
+	dynamic_array<UINT32> index(chunks * 2);
+	for (UINT32 chunknum = 0; chunknum < chunks; chunknum++)
+	{
+		index[chunknum * 2 + 0] = LITTLE_ENDIANIZE_INT32(chunk[chunknum].m_rawsize);
+		index[chunknum * 2 + 1] = LITTLE_ENDIANIZE_INT32(chunk[chunknum].m_compsize);
+	}
+
+	// write the header, the index and the chunks; everything is already compressed
 	file.compress(FCOMPRESS_NONE);
 	file.seek(0, SEEK_SET);
 	if (file.write(header, sizeof(header)) != sizeof(header))
 		return STATERR_WRITE_ERROR;
-	file.compress(FCOMPRESS_MEDIUM);
+	if (file.write(sizes, sizeof(sizes)) != sizeof(sizes))
+		return STATERR_WRITE_ERROR;
+	if (chunks > 0 && file.write(index, chunks * 8) != chunks * 8)
+		return STATERR_WRITE_ERROR;
+	for (UINT32 chunknum = 0; chunknum < chunks; chunknum++)
+		if (file.write(chunk[chunknum].m_comp, chunk[chunknum].m_compsize) != chunk[chunknum].m_compsize)
+			return STATERR_WRITE_ERROR;
+	return STATERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  process_chunks - run a callback over a set of
+//  chunks on the work queue, returning true if
+//  they all succeeded
+//-------------------------------------------------
+
+bool save_manager::process_chunks(dynamic_array<state_chunk> &chunk, osd_work_callback callback)
+{
+	if (chunk.count() == 0)
+		return true;
+
+	for (int chunknum = 0; chunknum < chunk.count(); chunknum++)
+		chunk[chunknum].m_success = false;
+
+	// a single chunk isn't worth handing off
+	osd_work_queue *queue = (chunk.count() > 1) ? osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI) : NULL;
+	if (queue != NULL)
+	{
+		osd_work_item_queue_multiple(queue, callback, chunk.count(), &chunk[0], sizeof(chunk[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		while (!osd_work_queue_wait(queue, osd_ticks_per_second()))
+			;
+		osd_work_queue_free(queue);
+	}
+	else
+		for (int chunknum = 0; chunknum < chunk.count(); chunknum++)
+			(*callback)(&chunk[chunknum], 0);
+
+	// check the results
+	for (int chunknum = 0; chunknum < chunk.count(); chunknum++)
+		if (!chunk[chunknum].m_success)
+			return false;
+	return true;
+}
+
+
+//-------------------------------------------------
+//  compress_chunk - compress a single chunk,
+//  storing it as-is if that doesn't help
+//-------------------------------------------------
+
+void *save_manager::compress_chunk(void *param, int threadid)
+{
+	state_chunk &chunk = *reinterpret_cast<state_chunk *>(param);
+	uLongf compsize = chunk.m_compsize;
+	if (compress2(chunk.m_comp, &compsize, chunk.m_raw, chunk.m_rawsize, FCOMPRESS_MEDIUM) == Z_OK && compsize < chunk.m_rawsize)
+		chunk.m_compsize = compsize;
+	else
+	{
+		memcpy(chunk.m_comp, chunk.m_raw, chunk.m_rawsize);
+		chunk.m_compsize = chunk.m_rawsize;
+	}
+	chunk.m_success = true;
+	return NULL;
+}
+
+
+//-------------------------------------------------
+//  expand_chunk - decompress a single chunk
+//-------------------------------------------------
+
+void *save_manager::expand_chunk(void *param, int threadid)
+{
+	state_chunk &chunk = *reinterpret_cast<state_chunk *>(param);
+	if (chunk.m_compsize == chunk.m_rawsize)
+	{
+		memcpy(chunk.m_raw, chunk.m_comp, chunk.m_rawsize);
+		chunk.m_success = true;
+	}
+	else
+	{
+		uLongf rawsize = chunk.m_rawsize;
+		chunk.m_success = (uncompress(chunk.m_raw, &rawsize, chunk.m_comp, chunk.m_compsize) == Z_OK && rawsize == chunk.m_rawsize);
+	}
+	return NULL;
+}
+
+
+//-------------------------------------------------
+//  state_size - return the total size of all
+//  registered state data, in bytes
+//-------------------------------------------------
+
+UINT32 save_manager::state_size() const
+{
+	UINT32 totalsize = 0;
+	for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
+		totalsize += entry->m_typesize * entry->m_typecount;
+	return totalsize;
+}
+
+
+//-------------------------------------------------
+//  write_buffer - copy all the state data into
+//  a memory buffer, native-endian and with no
+//  header
+//-------------------------------------------------
+
+save_error save_manager::write_buffer(void *buf, UINT32 size)
+{
+	// if we have illegal registrations, return an error
+	if (m_illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
 
 	// call the pre-save functions
 	dispatch_presave();
 
-	// then write all the data
+	// then copy all the data
+	UINT8 *dest = reinterpret_cast<UINT8 *>(buf);
+	UINT8 *end = dest + size;
 	for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
 	{
 		UINT32 totalsize = entry->m_typesize * entry->m_typecount;
-		if (file.write(entry->m_data, totalsize) != totalsize)
+		if (UINT32(end - dest) < totalsize)
 			return STATERR_WRITE_ERROR;
+		memcpy(dest, entry->m_data, totalsize);
+		dest += totalsize;
 	}
 	return STATERR_NONE;
 }
 
 
+//-------------------------------------------------
+//  update_buffer - bring a buffer previously
+//  filled by write_buffer up to date, copying
+//  only the pieces that have changed; flags each
+//  DIRTY_PAGE_SIZE page of the buffer that was
+//  touched and returns the number of bytes copied
+//-------------------------------------------------
+
+save_error save_manager::update_buffer(void *buf, UINT32 size, UINT8 *dirty, UINT32 &written)
+{
+	// if we have illegal registrations, return an error
+	if (m_illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
+
+	// call the pre-save functions
+	dispatch_presave();
+
+	// start out clean
+	memset(dirty, 0, (size + DIRTY_PAGE_SIZE - 1) / DIRTY_PAGE_SIZE);
+	written = 0;
+
+	// compare each entry a page at a time, copying only what differs
+	UINT8 *dest = reinterpret_cast<UINT8 *>(buf);
+	UINT32 offset = 0;
+	for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
+	{
+		UINT32 totalsize = entry->m_typesize * entry->m_typecount;
+		if (size - offset < totalsize)
+			return STATERR_WRITE_ERROR;
+
+		const UINT8 *src = reinterpret_cast<const UINT8 *>(entry->m_data);
+		while (totalsize > 0)
+		{
+			UINT32 chunk = MIN(totalsize, DIRTY_PAGE_SIZE - offset % DIRTY_PAGE_SIZE);
+			if (memcmp(&dest[offset], src, chunk) != 0)
+			{
+				memcpy(&dest[offset], src, chunk);
+				dirty[offset / DIRTY_PAGE_SIZE] = 1;
+				written += chunk;
+			}
+			src += chunk;
+			offset += chunk;
+			totalsize -= chunk;
+		}
+	}
+	return STATERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  read_buffer - restore all the state data from
+//  a memory buffer filled by write_buffer
+//-------------------------------------------------
+
+save_error save_manager::read_buffer(const void *buf, UINT32 size)
+{
+	// if we have illegal registrations, return an error
+	if (m_illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
+
+	// copy all the data back
+	const UINT8 *src = reinterpret_cast<const UINT8 *>(buf);
+	const UINT8 *end = src + size;
+	for (state_entry *entry = m_entry_list.first(); entry != NULL; entry = entry->next())
+	{
+		UINT32 totalsize = entry->m_typesize * entry->m_typecount;
+		if (UINT32(end - src) < totalsize)
+			return STATERR_READ_ERROR;
+		memcpy(entry->m_data, src, totalsize);
+		src += totalsize;
+	}
+
+	// call the post-load functions
+	dispatch_postload();
+
+	return STATERR_NONE;
+}
+
+
 //-------------------------------------------------
 //  signature - compute the signature, which
 //  is a CRC over the structure of the data
@@ -374,7 +734,7 @@ save_error save_manager::validate_header(const UINT8 *header, const char *gamena
 	}
 
 	// check save state version
-	if (header[8] != SAVE_VERSION)
+	if (header[8] != SAVE_VERSION && header[8] != SAVE_VERSION_STREAMED)
 	{
 		if (errormsg != NULL)
 			(*errormsg)("%sWrong version in save file (version %d, expected %d)", error_prefix, header[8], SAVE_VERSION);
@@ -467,3 +827,321 @@ void state_entry::flip_data()
 			break;
 	}
 }
+
+
+
+//**************************************************************************
+//  STATE REWINDER
+//**************************************************************************
+
+//-------------------------------------------------
+//  state_rewinder - constructor
+//-------------------------------------------------
+
+state_rewinder::state_rewinder(save_manager &save, const attotime &window, UINT32 memory)
+	: m_save(save),
+		m_window(window),
+		m_enabled(true),
+		m_valid(false),
+		m_bytes(save.state_size()),
+		m_words((m_bytes + 3) / 4),
+		m_dirty((m_words * 4 + save_manager::DIRTY_PAGE_SIZE - 1) / save_manager::DIRTY_PAGE_SIZE),
+		m_current_time(attotime::zero),
+		m_delta(m_words + m_words / 2 + 2),
+		m_arena(memory / 4),
+		m_head(0),
+		m_frame(256),
+		m_frame_first(0),
+		m_frame_count(0),
+		m_captures(0),
+		m_restores(0),
+		m_delta_words(0),
+		m_written_bytes(0),
+		m_last_written(0),
+		m_capture_ticks(0)
+{
+	// the padding at the end of the raw states is never written, so clear it up front
+	m_state.resize_and_clear(m_words);
+	m_next.resize_and_clear(m_words);
+}
+
+
+//-------------------------------------------------
+//  ~state_rewinder - destructor
+//-------------------------------------------------
+
+state_rewinder::~state_rewinder()
+{
+	// report the statistics
+	if (m_captures > 0)
+		osd_printf_verbose("Rewind: %d states of %d bytes captured, %d restored; average %d bytes written, %d byte delta, %d us per capture\n",
+			m_captures, m_bytes, m_restores, (int)(m_written_bytes / m_captures), (int)(m_delta_words * 4 / m_captures), (int)(m_capture_ticks * 1000000 / osd_ticks_per_second() / m_captures));
+}
+
+
+//-------------------------------------------------
+//  capture - snapshot the current state and
+//  store the difference to the previous one
+//-------------------------------------------------
+
+bool state_rewinder::capture()
+{
+	if (!m_enabled)
+		return false;
+
+	// the first time through, copy everything
+	osd_ticks_t start = osd_ticks();
+	save_error saverr;
+	if (!m_valid)
+	{
+		saverr = m_save.write_buffer(m_state, m_bytes);
+		if (saverr == STATERR_NONE)
+			memcpy(m_next, m_state, m_words * 4);
+		m_last_written = m_bytes;
+	}
+
+	// after that, only copy the pages that changed
+	else
+		saverr = m_save.update_buffer(m_next, m_bytes, m_dirty, m_last_written);
+	if (saverr != STATERR_NONE)
+	{
+		osd_printf_warning("Rewind disabled: unable to capture the state (error %d)\n", saverr);
+		m_enabled = false;
+		return false;
+	}
+	attotime now = m_save.machine().time();
+
+	if (m_valid)
+	{
+		// store the delta that gets us from the new state back to the current one
+		UINT32 size = encode_delta(m_state, m_next, m_dirty);
+		UINT32 offset;
+		if (allocate(size, offset))
+		{
+			memcpy(m_arena + offset, m_delta, size * 4);
+			append_frame(offset, size, m_current_time);
+			m_delta_words += size;
+		}
+
+		// then bring the current state up to date
+		for (int page = 0; page < m_dirty.count(); page++)
+			if (m_dirty[page] != 0)
+			{
+				UINT32 pageoffs = page * save_manager::DIRTY_PAGE_SIZE;
+				memcpy(&m_state[pageoffs / 4], &m_next[pageoffs / 4], MIN(save_manager::DIRTY_PAGE_SIZE, m_words * 4 - pageoffs));
+			}
+	}
+	m_current_time = now;
+	m_valid = true;
+	m_written_bytes += m_last_written;
+
+	// forget anything that has fallen out of the window
+	while (m_frame_count > 0 && frame(0).m_time + m_window < now)
+		drop_oldest();
+
+	m_captures++;
+	m_capture_ticks += osd_ticks() - start;
+	return true;
+}
+
+
+//-------------------------------------------------
+//  frames_back - return the number of frames to
+//  restore to get back to the latest state at
+//  least the given duration before the current
+//  one
+//-------------------------------------------------
+
+int state_rewinder::frames_back(const attotime &duration) const
+{
+	if (m_current_time < duration)
+		return m_frame_count;
+
+	attotime target = m_current_time - duration;
+	for (int index = m_frame_count - 1; index >= 0; index--)
+		if (frame(index).m_time <= target)
+			return m_frame_count - index;
+	return m_frame_count;
+}
+
+
+//-------------------------------------------------
+//  restore - go back the given number of frames
+//  and load that state into the machine; 0
+//  reloads the most recently captured state
+//-------------------------------------------------
+
+save_error state_rewinder::restore(int frames)
+{
+	if (!m_enabled || !m_valid || frames < 0 || frames > m_frame_count)
+		return STATERR_READ_ERROR;
+
+	// undo each delta in turn, newest first
+	if (frames > 0)
+	{
+		int target = m_frame_count - frames;
+		for (int index = m_frame_count - 1; index >= target; index--)
+			apply_delta(frame(index));
+
+		// everything from the target onward is now gone
+		m_current_time = frame(target).m_time;
+		m_head = frame(target).m_offset;
+		m_frame_count = target;
+		if (m_frame_count == 0)
+			m_head = 0;
+	}
+
+	// keep the capture buffer in step
+	memcpy(m_next, m_state, m_words * 4);
+
+	m_restores++;
+	return m_save.read_buffer(m_state, m_bytes);
+}
+
+
+//-------------------------------------------------
+//  encode_delta - encode the XOR of two states
+//  into m_delta as a series of runs, each one a
+//  count of unchanged words, a count of changed
+//  words, then the XORed changed words; pages
+//  not flagged in the dirty array are known to
+//  be unchanged; returns the encoded size in words
+//-------------------------------------------------
+
+UINT32 state_rewinder::encode_delta(const UINT32 *oldstate, const UINT32 *newstate, const UINT8 *dirty)
+{
+	const UINT32 pagewords = save_manager::DIRTY_PAGE_SIZE / 4;
+	UINT32 *dest = m_delta;
+	UINT32 index = 0;
+	while (index < m_words)
+	{
+		// skip over unchanged words, and whole clean pages
+		UINT32 skipstart = index;
+		while (index < m_words)
+		{
+			if (dirty[index / pagewords] == 0)
+				index = (index / pagewords + 1) * pagewords;
+			else if (oldstate[index] == newstate[index])
+				index++;
+			else
+				break;
+		}
+		if (index >= m_words)
+			break;
+
+		// copy changed words; absorb single unchanged words, since a new run costs two
+		UINT32 *header = dest;
+		dest += 2;
+		UINT32 changestart = index;
+		while (index < m_words && (oldstate[index] != newstate[index] || (index + 1 < m_words && oldstate[index + 1] != newstate[index + 1])))
+		{
+			*dest++ = oldstate[index] ^ newstate[index];
+			index++;
+		}
+		header[0] = changestart - skipstart;
+		header[1] = index - changestart;
+	}
+	return dest - m_delta;
+}
+
+
+//-------------------------------------------------
+//  apply_delta - XOR an encoded delta into the
+//  current state
+//-------------------------------------------------
+
+void state_rewinder::apply_delta(const delta_frame &delta)
+{
+	UINT32 *dest = m_state;
+	const UINT32 *src = m_arena + delta.m_offset;
+	const UINT32 *end = src + delta.m_size;
+	while (src < end)
+	{
+		dest += *src++;
+		UINT32 count = *src++;
+		while (count-- != 0)
+			*dest++ ^= *src++;
+	}
+}
+
+
+//-------------------------------------------------
+//  allocate - find contiguous space in the arena
+//  for a delta, throwing out the oldest ones as
+//  needed; returns false if it can never fit
+//-------------------------------------------------
+
+bool state_rewinder::allocate(UINT32 size, UINT32 &offset)
+{
+	UINT32 arenasize = m_arena.count();
+
+	// if it can never fit, the history is broken, so start over
+	if (size >= arenasize)
+	{
+		while (m_frame_count > 0)
+			drop_oldest();
+		return false;
+	}
+
+	while (m_frame_count > 0)
+	{
+		UINT32 tail = frame(0).m_offset;
+
+		// if the live data doesn't wrap, try after it, then at the start
+		if (m_head >= tail)
+		{
+			if (arenasize - m_head >= size)
+				break;
+			if (tail > size)
+			{
+				m_head = 0;
+				break;
+			}
+		}
+
+		// otherwise, the free space is between the two
+		else if (tail - m_head > size)
+			break;
+
+		drop_oldest();
+	}
+
+	offset = m_head;
+	m_head += size;
+	return true;
+}
+
+
+//-------------------------------------------------
+//  append_frame - add a delta to the end of the
+//  ring, growing it if needed
+//-------------------------------------------------
+
+void state_rewinder::append_frame(UINT32 offset, UINT32 size, const attotime &time)
+{
+	// if full, double the size and unwrap the entries that had wrapped around
+	int oldcount = m_frame.count();
+	if (m_frame_count == oldcount)
+	{
+		m_frame.resize_keep(oldcount * 2);
+		for (int index = 0; index < m_frame_first; index++)
+			m_frame[oldcount + index] = m_frame[index];
+	}
+
+	delta_frame &delta = frame(m_frame_count++);
+	delta.m_offset = offset;
+	delta.m_size = size;
+	delta.m_time = time;
+}
+
+
+//-------------------------------------------------
+//  drop_oldest - discard the oldest delta
+//-------------------------------------------------
+
+void state_rewinder::drop_oldest()
+{
+	m_frame_first = (m_frame_first + 1) % m_frame.count();
+	if (--m_frame_count == 0)
+		m_head = 0;
+}
@@ -108,6 +108,9 @@ class save_manager
 	template<typename _ItemType> struct type_checker<_ItemType*> { static const bool is_atom = false; static const bool is_pointer = true; };
 
 public:
+	// granularity of change tracking for in-memory states
+	static const UINT32 DIRTY_PAGE_SIZE = 4096;
+
 	// construction/destruction
 	save_manager(running_machine &machine);
 
@@ -174,13 +177,35 @@ public:
 	static save_error check_file(running_machine &machine, emu_file &file, const char *gamename, void (CLIB_DECL *errormsg)(const char *fmt, ...));
 	save_error write_file(emu_file &file);
 	save_error read_file(emu_file &file);
+	save_error verify_file(emu_file &file);
+
+	// in-memory processing
+	UINT32 state_size() const;
+	save_error write_buffer(void *buf, UINT32 size);
+	save_error update_buffer(void *buf, UINT32 size, UINT8 *dirty, UINT32 &written);
+	save_error read_buffer(const void *buf, UINT32 size);
 
 private:
 	// internal helpers
 	UINT32 signature() const;
 	void dump_registry() const;
+	save_error read_header(emu_file &file, UINT8 *header);
+	save_error read_data(emu_file &file, const UINT8 *header, dynamic_buffer &data);
 	static save_error validate_header(const UINT8 *header, const char *gamename, UINT32 signature, void (CLIB_DECL *errormsg)(const char *fmt, ...), const char *error_prefix);
 
+	// a piece of the state compressed or expanded on its own
+	struct state_chunk
+	{
+		UINT8 *             m_raw;                  // pointer to the uncompressed data
+		UINT32              m_rawsize;              // size of the uncompressed data
+		UINT8 *             m_comp;                 // pointer to the compressed data
+		UINT32              m_compsize;             // size of the compressed data (or the space for it)
+		bool                m_success;              // true if processing succeeded
+	};
+	static bool process_chunks(dynamic_array<state_chunk> &chunk, osd_work_callback callback);
+	static void *compress_chunk(void *param, int threadid);
+	static void *expand_chunk(void *param, int threadid);
+
 	// state callback item
 	class state_callback
 	{
@@ -207,6 +232,71 @@ private:
 };
 
 
+// keeps a history of recent states in memory
+class state_rewinder
+{
+public:
+	// construction/destruction
+	state_rewinder(save_manager &save, const attotime &window, UINT32 memory);
+	~state_rewinder();
+
+	// getters
+	bool enabled() const { return m_enabled; }
+	int frames() const { return m_frame_count; }
+	UINT32 last_written() const { return m_last_written; }
+	attotime current_time() const { return m_current_time; }
+
+	// snapshot management
+	bool capture();
+	int frames_back(const attotime &duration) const;
+	save_error restore(int frames);
+
+private:
+	// a single compressed delta in the arena
+	struct delta_frame
+	{
+		UINT32              m_offset;               // offset of the data within the arena, in words
+		UINT32              m_size;                 // size of the data, in words
+		attotime            m_time;                 // machine time of the state it restores
+	};
+
+	// internal helpers
+	delta_frame &frame(int index) { return m_frame[(m_frame_first + index) % m_frame.count()]; }
+	const delta_frame &frame(int index) const { return m_frame[(m_frame_first + index) % m_frame.count()]; }
+	UINT32 encode_delta(const UINT32 *oldstate, const UINT32 *newstate, const UINT8 *dirty);
+	void apply_delta(const delta_frame &delta);
+	bool allocate(UINT32 size, UINT32 &offset);
+	void append_frame(UINT32 offset, UINT32 size, const attotime &time);
+	void drop_oldest();
+
+	// internal state
+	save_manager &          m_save;                 // reference to the save manager
+	attotime                m_window;               // how far back to keep states
+	bool                    m_enabled;              // false if the state can't be captured
+	bool                    m_valid;                // true once we have a current state
+	UINT32                  m_bytes;                // size of the raw state, in bytes
+	UINT32                  m_words;                // size of the raw state, rounded up to words
+	dynamic_array<UINT32>   m_state;                // current raw state
+	dynamic_array<UINT32>   m_next;                 // raw state being captured; matches m_state between captures
+	dynamic_array<UINT8>    m_dirty;                // flag per page of m_next changed by the capture
+	attotime                m_current_time;         // machine time of the current raw state
+	dynamic_array<UINT32>   m_delta;                // scratch space for encoding a delta
+	dynamic_array<UINT32>   m_arena;                // ring buffer holding encoded deltas
+	UINT32                  m_head;                 // offset where the next delta is written
+	dynamic_array<delta_frame> m_frame;             // ring buffer of deltas, oldest first
+	int                     m_frame_first;          // index of the oldest delta
+	int                     m_frame_count;          // number of deltas held
+
+	// statistics
+	UINT32                  m_captures;             // number of states captured
+	UINT32                  m_restores;             // number of states restored
+	UINT64                  m_delta_words;          // total size of the encoded deltas
+	UINT64                  m_written_bytes;        // total state bytes copied by captures
+	UINT32                  m_last_written;         // state bytes copied by the latest capture
+	osd_ticks_t             m_capture_ticks;        // time spent capturing
+};
+
+
 // template specializations to enumerate the fundamental atomic types you are allowed to save
 ALLOW_SAVE_TYPE_AND_ARRAY(char);
 ALLOW_SAVE_TYPE_AND_ARRAY(bool);
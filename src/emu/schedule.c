@@ -23,6 +23,14 @@
 
 
 
+//**************************************************************************
+//  GLOBAL VARIABLES
+//**************************************************************************
+
+ATTR_THREAD_LOCAL device_execute_interface *device_scheduler::s_parallel_device = NULL;
+
+
+
 //**************************************************************************
 //  CONSTANTS
 //**************************************************************************
@@ -35,6 +43,10 @@ enum
 	TRIGGER_SUSPENDTIME = -4000
 };
 
+// adaptive quantum: widen by 2x after this many quiet quanta, up to this many times
+const int ADAPTIVE_QUIET_QUANTA = 8;
+const int ADAPTIVE_MAX_SHIFT = 6;
+
 
 
 //**************************************************************************
@@ -57,7 +69,11 @@ emu_timer::emu_timer()
 		m_start(attotime::zero),
 		m_expire(attotime::never),
 		m_device(NULL),
-		m_id(0)
+		m_id(0),
+		m_heapexpire(attotime::never),
+		m_heapsequence(0),
+		m_heapindex(-1),
+		m_profiler(PROFILER_TOTAL)
 {
 }
 
@@ -92,6 +108,7 @@ emu_timer &emu_timer::init(running_machine &machine, timer_expired_delegate call
 	m_expire = attotime::never;
 	m_device = NULL;
 	m_id = 0;
+	m_profiler = PROFILER_TOTAL;
 
 	// if we're not temporary, register ourselves with the save state system
 	if (!m_temporary)
@@ -124,6 +141,7 @@ emu_timer &emu_timer::init(device_t &device, device_timer_id id, void *ptr, bool
 	m_expire = attotime::never;
 	m_device = &device;
 	m_id = id;
+	m_profiler = PROFILER_TOTAL;
 
 	// if we're not temporary, register ourselves with the save state system
 	if (!m_temporary)
@@ -158,12 +176,15 @@ bool emu_timer::enable(bool enable)
 	bool old = m_enabled;
 	if (old != enable)
 	{
+		device_scheduler &scheduler = machine().scheduler();
+		scheduler.parallel_lock();
+
 		// set the enable flag
 		m_enabled = enable;
 
-		// remove the timer and insert back into the list
-		machine().scheduler().timer_list_remove(*this);
-		machine().scheduler().timer_list_insert(*this);
+		// move the timer to its new place in the heap
+		scheduler.timer_heap_update(*this);
+		scheduler.parallel_unlock();
 	}
 	return old;
 }
@@ -179,6 +200,7 @@ void emu_timer::adjust(attotime start_delay, INT32 param, const attotime &period
 {
 	// if this is the callback timer, mark it modified
 	device_scheduler &scheduler = machine().scheduler();
+	scheduler.parallel_lock();
 	if (scheduler.m_callback_timer == this)
 		scheduler.m_callback_timer_modified = true;
 
@@ -190,18 +212,22 @@ void emu_timer::adjust(attotime start_delay, INT32 param, const attotime &period
 	if (start_delay.seconds < 0)
 		start_delay = attotime::zero;
 
+	// a CPU asking to synchronize is talking to someone else
+	if (start_delay.is_zero() && scheduler.currently_executing() != NULL)
+		scheduler.m_adaptive_contact = true;
+
 	// set the start and expire times
 	m_start = scheduler.time();
 	m_expire = m_start + start_delay;
 	m_period = period;
 
-	// remove and re-insert the timer in its new order
-	scheduler.timer_list_remove(*this);
-	scheduler.timer_list_insert(*this);
+	// move the timer to its new place in the heap
+	scheduler.timer_heap_update(*this);
 
-	// if this was inserted as the head, abort the current timeslice and resync
-	if (this == scheduler.first_timer())
+	// if this is now the next timer to fire, abort the current timeslice and resync
+	if (this == scheduler.next_timer())
 		scheduler.abort_timeslice();
+	scheduler.parallel_unlock();
 }
 
 
@@ -212,7 +238,11 @@ void emu_timer::adjust(attotime start_delay, INT32 param, const attotime &period
 
 attotime emu_timer::elapsed() const
 {
-	return machine().time() - m_start;
+	device_scheduler &scheduler = machine().scheduler();
+	scheduler.parallel_lock();
+	attotime result = scheduler.time() - m_start;
+	scheduler.parallel_unlock();
+	return result;
 }
 
 
@@ -223,10 +253,12 @@ attotime emu_timer::elapsed() const
 
 attotime emu_timer::remaining() const
 {
-	attotime curtime = machine().time();
-	if (curtime >= m_expire)
-		return attotime::zero;
-	return m_expire - curtime;
+	device_scheduler &scheduler = machine().scheduler();
+	scheduler.parallel_lock();
+	attotime curtime = scheduler.time();
+	attotime result = (curtime >= m_expire) ? attotime::zero : m_expire - curtime;
+	scheduler.parallel_unlock();
+	return result;
 }
 
 
@@ -279,10 +311,8 @@ inline void emu_timer::schedule_next_period()
 	m_start = m_expire;
 	m_expire += m_period;
 
-	// remove and re-insert us
-	device_scheduler &scheduler = machine().scheduler();
-	scheduler.timer_list_remove(*this);
-	scheduler.timer_list_insert(*this);
+	// move us to our new place in the heap
+	machine().scheduler().timer_heap_update(*this);
 }
 
 
@@ -301,6 +331,22 @@ void emu_timer::dump() const
 }
 
 
+//-------------------------------------------------
+//  profiler_scope - return the profiler scope
+//  this timer's callbacks are charged to
+//-------------------------------------------------
+
+profile_type emu_timer::profiler_scope() const
+{
+	astring name;
+	if (m_device != NULL)
+		name.printf("'%s' timer %d", m_device->tag(), m_id);
+	else
+		name.cpy((m_callback.name() != NULL) ? m_callback.name() : "(unnamed timer)");
+	return g_profiler.scope(name);
+}
+
+
 
 //**************************************************************************
 //  DEVICE SCHEDULER
@@ -316,15 +362,26 @@ device_scheduler::device_scheduler(running_machine &machine) :
 	m_execute_list(NULL),
 	m_basetime(attotime::zero),
 	m_timer_list(NULL),
+	m_timer_list_tail(NULL),
+	m_timer_sequence(0),
 	m_callback_timer(NULL),
 	m_callback_timer_modified(false),
 	m_callback_timer_expire_time(attotime::zero),
 	m_suspend_changes_pending(true),
-	m_quantum_minimum(ATTOSECONDS_IN_NSEC(1) / 1000)
+	m_quantum_minimum(ATTOSECONDS_IN_NSEC(1) / 1000),
+	m_execution_timing(false),
+	m_adaptive_enabled(false),
+	m_adaptive_contact(false),
+	m_adaptive_shift(0),
+	m_adaptive_quiet(0),
+	m_parallel_enabled(false),
+	m_parallel_active(false),
+	m_parallel_queue(NULL),
+	m_parallel_lock(NULL),
+	m_parallel_target(attotime::zero)
 {
-	// append a single never-expiring timer so there is always one in the list
-	m_timer_list = &m_timer_allocator.alloc()->init(machine, timer_expired_delegate(), NULL, true);
-	m_timer_list->adjust(attotime::never);
+	// append a single never-expiring timer so there is always one in the heap
+	m_timer_allocator.alloc()->init(machine, timer_expired_delegate(), NULL, true).adjust(attotime::never);
 
 	// register global states
 	machine.save().save_item(NAME(m_basetime));
@@ -342,6 +399,12 @@ device_scheduler::~device_scheduler()
 	// remove all timers
 	while (m_timer_list != NULL)
 		m_timer_allocator.reclaim(m_timer_list->release());
+
+	// stop the parallel groups
+	if (m_parallel_queue != NULL)
+		osd_work_queue_free(m_parallel_queue);
+	if (m_parallel_lock != NULL)
+		osd_lock_free(m_parallel_lock);
 }
 
 
@@ -357,7 +420,8 @@ attotime device_scheduler::time() const
 
 	// if we're executing as a particular CPU, use its local time as a base
 	// otherwise, return the global base time
-	return (m_executing_device != NULL) ? m_executing_device->local_time() : m_basetime;
+	device_execute_interface *executing = currently_executing();
+	return (executing != NULL) ? executing->local_time() : m_basetime;
 }
 
 
@@ -406,6 +470,130 @@ inline void device_scheduler::apply_suspend_changes()
 }
 
 
+//-------------------------------------------------
+//  execute_device - execute a single device up
+//  to the target time, pulling the target in if
+//  it stops early
+//-------------------------------------------------
+
+inline void device_scheduler::execute_device(device_execute_interface &exec, attotime &target, bool call_debugger, bool parallel)
+{
+	// compute how many attoseconds to execute this CPU
+	attoseconds_t delta = target.attoseconds - exec.m_localtime.attoseconds;
+	if (delta < 0 && target.seconds > exec.m_localtime.seconds)
+		delta += ATTOSECONDS_PER_SECOND;
+#ifndef MAME_DEBUG_FAST
+	assert(delta == (target - exec.m_localtime).as_attoseconds());
+#endif
+
+	// if we have enough for at least 1 cycle, do the math
+	if (delta >= exec.m_attoseconds_per_cycle)
+	{
+		// compute how many cycles we want to execute
+		int ran = exec.m_cycles_running = divu_64x32((UINT64)delta >> exec.m_divshift, exec.m_divisor);
+		LOG(("  cpu '%s': %" I64FMT"d (%d cycles)\n", exec.device().tag(), delta, exec.m_cycles_running));
+
+		// if we're not suspended, actually execute
+		if (exec.m_suspend == 0)
+		{
+			// the profiler is only safe to use from the main thread
+			if (!parallel)
+				g_profiler.start(exec.m_profiler);
+
+			// note that this global variable cycles_stolen can be modified
+			// via the call to cpu_execute
+			exec.m_cycles_stolen = 0;
+			if (!parallel)
+				m_executing_device = &exec;
+			else
+				s_parallel_device = &exec;
+			*exec.m_icountptr = exec.m_cycles_running;
+			osd_ticks_t start = m_execution_timing ? osd_ticks() : 0;
+			if (!call_debugger)
+				exec.run();
+			else
+			{
+				debugger_start_cpu_hook(&exec.device(), target);
+				exec.run();
+				debugger_stop_cpu_hook(&exec.device());
+			}
+			if (m_execution_timing)
+				exec.m_exec_ticks += osd_ticks() - start;
+
+			// adjust for any cycles we took back
+			assert(ran >= *exec.m_icountptr);
+			ran -= *exec.m_icountptr;
+			assert(ran >= exec.m_cycles_stolen);
+			ran -= exec.m_cycles_stolen;
+			if (!parallel)
+				g_profiler.stop();
+		}
+
+		// account for these cycles
+		exec.m_totalcycles += ran;
+
+		// update the local time for this CPU
+		attotime delta(0, exec.m_attoseconds_per_cycle * ran);
+		assert(delta >= attotime::zero);
+		exec.m_localtime += delta;
+		LOG(("         %d ran, %d total, time = %s\n", ran, (INT32)exec.m_totalcycles, exec.m_localtime.as_string(PRECISION)));
+
+		// if the new local CPU time is less than our target, move the target up, but not before the base
+		if (exec.m_localtime < target)
+		{
+			target = max(exec.m_localtime, m_basetime);
+			LOG(("         (new target)\n"));
+		}
+	}
+}
+
+
+//-------------------------------------------------
+//  adaptive_quantum - widen the requested quantum
+//  while the CPUs keep to themselves, and snap it
+//  back as soon as they interact
+//-------------------------------------------------
+
+attoseconds_t device_scheduler::adaptive_quantum(attoseconds_t quantum)
+{
+	// any contact since last time puts us right back where the driver wants us
+	if (m_adaptive_contact)
+	{
+		m_adaptive_contact = false;
+		m_adaptive_shift = 0;
+		m_adaptive_quiet = 0;
+		return quantum;
+	}
+
+	// after enough quiet quanta, try twice as long
+	if (++m_adaptive_quiet >= ADAPTIVE_QUIET_QUANTA && m_adaptive_shift < ADAPTIVE_MAX_SHIFT)
+	{
+		m_adaptive_shift++;
+		m_adaptive_quiet = 0;
+	}
+
+	// never go beyond the quantum a system with no interleave requirements gets
+	attoseconds_t widest = HZ_TO_ATTOSECONDS(60);
+	if (quantum >= widest || m_adaptive_shift == 0)
+		return quantum;
+	return MIN(quantum << m_adaptive_shift, widest);
+}
+
+
+//-------------------------------------------------
+//  count_quantum - add a quantum to the
+//  profiler's histogram
+//-------------------------------------------------
+
+void device_scheduler::count_quantum(attoseconds_t quantum)
+{
+	profile_type bin = PROFILER_QUANTUM_FIRST;
+	for (attoseconds_t limit = ATTOSECONDS_IN_USEC(1); bin < PROFILER_QUANTUM_LAST && quantum >= limit; limit *= 10)
+		bin++;
+	g_profiler.count(bin);
+}
+
+
 //-------------------------------------------------
 //  timeslice - execute all devices for a single
 //  timeslice
@@ -424,14 +612,17 @@ void device_scheduler::timeslice()
 		m_quantum_allocator.reclaim(m_quantum_list.detach_head());
 
 	// loop until we hit the next timer
-	while (m_basetime < m_timer_list->m_expire)
+	while (m_basetime < m_timer_heap[0]->m_heapexpire)
 	{
 		// by default, assume our target is the end of the next quantum
-		attotime target = m_basetime + attotime(0, m_quantum_list.first()->m_actual);
+		attoseconds_t quantum = m_quantum_list.first()->m_actual;
+		if (m_adaptive_enabled)
+			quantum = adaptive_quantum(quantum);
+		attotime target = m_basetime + attotime(0, quantum);
 
 		// however, if the next timer is going to fire before then, override
-		if (m_timer_list->m_expire < target)
-			target = m_timer_list->m_expire;
+		if (m_timer_heap[0]->m_heapexpire < target)
+			target = m_timer_heap[0]->m_heapexpire;
 
 		LOG(("------------------\n"));
 		LOG(("cpu_timeslice: target = %s\n", target.as_string(PRECISION)));
@@ -440,75 +631,51 @@ void device_scheduler::timeslice()
 		if (m_suspend_changes_pending)
 			apply_suspend_changes();
 
+		// start the parallel groups first, so they overlap with everything else; the
+		// profiler isn't thread-safe, so everything runs here while it is enabled
+		bool parallel = (m_parallel_groups.count() != 0 && !g_profiler.enabled());
+		if (parallel)
+		{
+			m_parallel_target = target;
+			m_parallel_active = true;
+			osd_work_item_queue_multiple(m_parallel_queue, parallel_group_callback, m_parallel_groups.count(), &m_parallel_groups[0], sizeof(m_parallel_groups[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		}
+
 		// loop over all CPUs
 		for (device_execute_interface *exec = m_execute_list; exec != NULL; exec = exec->m_nextexec)
 		{
+			// pick up any earlier stop made by a group
+			if (parallel)
+				target = parallel_target();
+
 			// only process if this CPU is executing or truly halted (not yielding)
 			// and if our target is later than the CPU's current time (coarse check)
-			if (EXPECTED((exec->m_suspend == 0 || exec->m_eatcycles) && target.seconds >= exec->m_localtime.seconds))
+			if (EXPECTED((exec->m_suspend == 0 || exec->m_eatcycles) && target.seconds >= exec->m_localtime.seconds && (!parallel || !exec->m_parallel)))
 			{
-				// compute how many attoseconds to execute this CPU
-				attoseconds_t delta = target.attoseconds - exec->m_localtime.attoseconds;
-				if (delta < 0 && target.seconds > exec->m_localtime.seconds)
-					delta += ATTOSECONDS_PER_SECOND;
-#ifndef MAME_DEBUG_FAST
-				assert(delta == (target - exec->m_localtime).as_attoseconds());
-#endif
-
-				// if we have enough for at least 1 cycle, do the math
-				if (delta >= exec->m_attoseconds_per_cycle)
-				{
-					// compute how many cycles we want to execute
-					int ran = exec->m_cycles_running = divu_64x32((UINT64)delta >> exec->m_divshift, exec->m_divisor);
-					LOG(("  cpu '%s': %" I64FMT"d (%d cycles)\n", exec->device().tag(), delta, exec->m_cycles_running));
-
-					// if we're not suspended, actually execute
-					if (exec->m_suspend == 0)
-					{
-						g_profiler.start(exec->m_profiler);
-
-						// note that this global variable cycles_stolen can be modified
-						// via the call to cpu_execute
-						exec->m_cycles_stolen = 0;
-						m_executing_device = exec;
-						*exec->m_icountptr = exec->m_cycles_running;
-						if (!call_debugger)
-							exec->run();
-						else
-						{
-							debugger_start_cpu_hook(&exec->device(), target);
-							exec->run();
-							debugger_stop_cpu_hook(&exec->device());
-						}
-
-						// adjust for any cycles we took back
-						assert(ran >= *exec->m_icountptr);
-						ran -= *exec->m_icountptr;
-						assert(ran >= exec->m_cycles_stolen);
-						ran -= exec->m_cycles_stolen;
-						g_profiler.stop();
-					}
-
-					// account for these cycles
-					exec->m_totalcycles += ran;
-
-					// update the local time for this CPU
-					attotime delta(0, exec->m_attoseconds_per_cycle * ran);
-					assert(delta >= attotime::zero);
-					exec->m_localtime += delta;
-					LOG(("         %d ran, %d total, time = %s\n", ran, (INT32)exec->m_totalcycles, exec->m_localtime.as_string(PRECISION)));
-
-					// if the new local CPU time is less than our target, move the target up, but not before the base
-					if (exec->m_localtime < target)
-					{
-						target = max(exec->m_localtime, m_basetime);
-						LOG(("         (new target)\n"));
-					}
-				}
+				execute_device(*exec, target, call_debugger, false);
+				if (parallel)
+					parallel_pull_target(target);
 			}
 		}
 		m_executing_device = NULL;
 
+		// keep track of how long the quanta really are
+		if (g_profiler.enabled())
+			count_quantum((target - m_basetime).as_attoseconds());
+
+		// wait for the parallel groups, and stop at the earliest point any of them reached
+		if (parallel)
+		{
+			while (!osd_work_queue_wait(m_parallel_queue, osd_ticks_per_second()))
+				;
+			m_parallel_active = false;
+			target = min(target, m_parallel_target);
+
+			// a timer set from another thread may be due before the target
+			if (m_timer_heap[0]->m_heapexpire < target)
+				target = max(m_timer_heap[0]->m_heapexpire, m_basetime);
+		}
+
 		// update the base time
 		m_basetime = target;
 	}
@@ -525,8 +692,9 @@ void device_scheduler::timeslice()
 
 void device_scheduler::abort_timeslice()
 {
-	if (m_executing_device != NULL)
-		m_executing_device->abort_timeslice();
+	device_execute_interface *executing = currently_executing();
+	if (executing != NULL)
+		executing->abort_timeslice();
 }
 
 
@@ -546,8 +714,13 @@ void device_scheduler::trigger(int trigid, const attotime &after)
 
 	// send the trigger to everyone who cares
 	else
+	{
+		m_adaptive_contact = true;
+		parallel_lock();
 		for (device_execute_interface *exec = m_execute_list; exec != NULL; exec = exec->m_nextexec)
 			exec->trigger(trigid);
+		parallel_unlock();
+	}
 }
 
 
@@ -561,6 +734,7 @@ void device_scheduler::boost_interleave(const attotime &timeslice_time, const at
 	// ignore timeslices > 1 second
 	if (timeslice_time.seconds > 0)
 		return;
+	m_adaptive_contact = true;
 	add_scheduling_quantum(timeslice_time, boost_duration);
 }
 
@@ -572,7 +746,10 @@ void device_scheduler::boost_interleave(const attotime &timeslice_time, const at
 
 emu_timer *device_scheduler::timer_alloc(timer_expired_delegate callback, void *ptr)
 {
-	return &m_timer_allocator.alloc()->init(machine(), callback, ptr, false);
+	parallel_lock();
+	emu_timer *timer = &m_timer_allocator.alloc()->init(machine(), callback, ptr, false);
+	parallel_unlock();
+	return timer;
 }
 
 
@@ -584,7 +761,9 @@ emu_timer *device_scheduler::timer_alloc(timer_expired_delegate callback, void *
 
 void device_scheduler::timer_set(const attotime &duration, timer_expired_delegate callback, int param, void *ptr)
 {
+	parallel_lock();
 	m_timer_allocator.alloc()->init(machine(), callback, ptr, true).adjust(duration, param);
+	parallel_unlock();
 }
 
 
@@ -596,7 +775,9 @@ void device_scheduler::timer_set(const attotime &duration, timer_expired_delegat
 
 void device_scheduler::timer_pulse(const attotime &period, timer_expired_delegate callback, int param, void *ptr)
 {
+	parallel_lock();
 	m_timer_allocator.alloc()->init(machine(), callback, ptr, false).adjust(period, param, period);
+	parallel_unlock();
 }
 
 
@@ -607,7 +788,10 @@ void device_scheduler::timer_pulse(const attotime &period, timer_expired_delegat
 
 emu_timer *device_scheduler::timer_alloc(device_t &device, device_timer_id id, void *ptr)
 {
-	return &m_timer_allocator.alloc()->init(device, id, ptr, false);
+	parallel_lock();
+	emu_timer *timer = &m_timer_allocator.alloc()->init(device, id, ptr, false);
+	parallel_unlock();
+	return timer;
 }
 
 
@@ -619,7 +803,9 @@ emu_timer *device_scheduler::timer_alloc(device_t &device, device_timer_id id, v
 
 void device_scheduler::timer_set(const attotime &duration, device_t &device, device_timer_id id, int param, void *ptr)
 {
+	parallel_lock();
 	m_timer_allocator.alloc()->init(device, id, ptr, true).adjust(duration, param);
+	parallel_unlock();
 }
 
 
@@ -664,26 +850,28 @@ void device_scheduler::presave()
 
 void device_scheduler::postload()
 {
-	// remove all timers and make a private list of permanent ones
-	simple_list<emu_timer> private_list;
-	while (m_timer_list != NULL)
+	// empty the heap, keeping the timers in their current order
+	dynamic_array<emu_timer *> order;
+	while (m_timer_heap.count() != 0)
 	{
-		emu_timer &timer = *m_timer_list;
+		emu_timer &timer = *m_timer_heap[0];
+		order.append(&timer);
+		timer_heap_remove(timer);
+	}
+
+	for (int timernum = 0; timernum < order.count(); timernum++)
+	{
+		emu_timer &timer = *order[timernum];
 
 		// temporary timers go away entirely (except our special never-expiring one)
 		if (timer.m_temporary && !timer.expire().is_never())
 			m_timer_allocator.reclaim(timer.release());
 
-		// permanent ones get added to our private list
+		// permanent ones get re-inserted; this effectively re-sorts them by time
 		else
-			private_list.append(timer_list_remove(timer));
+			timer_heap_insert(timer);
 	}
 
-	// now re-insert them; this effectively re-sorts them by time
-	emu_timer *timer;
-	while ((timer = private_list.detach_head()) != NULL)
-		timer_list_insert(*timer);
-
 	m_suspend_changes_pending = true;
 	rebuild_execute_list();
 
@@ -747,6 +935,10 @@ void device_scheduler::rebuild_execute_list()
 	// if we haven't yet set a scheduling quantum, do it now
 	if (m_quantum_list.first() == NULL)
 	{
+		// parallel groups only run when asked for, and never under the debugger
+		m_parallel_enabled = machine().options().parallel_execute() && (machine().debug_flags & DEBUG_FLAG_ENABLED) == 0;
+		m_adaptive_enabled = machine().options().adaptive_quantum();
+
 		// set the core scheduling quantum
 		attotime min_quantum = machine().config().m_minimum_quantum;
 
@@ -803,55 +995,139 @@ void device_scheduler::rebuild_execute_list()
 
 	// append the suspend list to the end of the active list
 	*active_tailptr = suspend_list;
+
+	// split out the groups that run on their own threads
+	if (m_parallel_enabled)
+		rebuild_parallel_groups();
 }
 
 
 //-------------------------------------------------
-//  timer_list_insert - insert a new timer into
-//  the list at the appropriate location
+//  rebuild_parallel_groups - sort the devices
+//  that the configuration marks as loosely
+//  coupled into groups that run on their own
+//  threads
 //-------------------------------------------------
 
-emu_timer &device_scheduler::timer_list_insert(emu_timer &timer)
+void device_scheduler::rebuild_parallel_groups()
 {
-	// disabled timers sort to the end
-	const attotime &expire = timer.m_enabled ? timer.m_expire : attotime::never;
+	// start with all the groups empty
+	for (parallel_group *group = m_parallel_list.first(); group != NULL; group = group->next())
+		group->m_devices.resize(0);
+	m_parallel_groups.resize(0);
 
-	// loop over the timer list
-	emu_timer *prevtimer = NULL;
-	for (emu_timer *curtimer = m_timer_list; curtimer != NULL; prevtimer = curtimer, curtimer = curtimer->next())
+	// add each device to its group, keeping the execution order
+	for (device_execute_interface *exec = m_execute_list; exec != NULL; exec = exec->m_nextexec)
 	{
-		// if the current list entry expires after us, we should be inserted before it
-		if (curtimer->m_expire > expire)
-		{
-			// link the new guy in before the current list entry
-			timer.m_prev = curtimer->m_prev;
-			timer.m_next = curtimer;
+		exec->m_parallel = (exec->m_parallel_group != 0);
+		if (!exec->m_parallel)
+			continue;
+
+		parallel_group *group;
+		for (group = m_parallel_list.first(); group != NULL; group = group->next())
+			if (group->m_group == exec->m_parallel_group)
+				break;
+		if (group == NULL)
+			group = &m_parallel_list.append(*global_alloc(parallel_group(*this, exec->m_parallel_group)));
+
+		if (group->m_devices.count() == 0)
+			m_parallel_groups.append(group);
+		group->m_devices.append(exec);
+	}
 
-			if (curtimer->m_prev != NULL)
-				curtimer->m_prev->m_next = &timer;
-			else
-				m_timer_list = &timer;
+	// create the threads the first time we need them
+	if (m_parallel_groups.count() != 0 && m_parallel_queue == NULL)
+	{
+		m_parallel_lock = osd_lock_alloc();
+		m_parallel_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
+		if (m_parallel_queue == NULL || m_parallel_lock == NULL)
+			fatalerror("Unable to allocate threads for parallel execution\n");
+	}
+}
+
+
+//-------------------------------------------------
+//  parallel_target - return the current target
+//  shared by all the threads in this timeslice
+//-------------------------------------------------
+
+attotime device_scheduler::parallel_target()
+{
+	osd_lock_acquire(m_parallel_lock);
+	attotime result = m_parallel_target;
+	osd_lock_release(m_parallel_lock);
+	return result;
+}
+
+
+//-------------------------------------------------
+//  parallel_pull_target - pull the shared target
+//  in after a device stopped early; this is how
+//  an abort reaches the other threads, since
+//  nobody may touch the icount of a device that
+//  is running on another thread
+//-------------------------------------------------
+
+void device_scheduler::parallel_pull_target(const attotime &target)
+{
+	osd_lock_acquire(m_parallel_lock);
+	if (target < m_parallel_target)
+		m_parallel_target = target;
+	osd_lock_release(m_parallel_lock);
+}
 
-			curtimer->m_prev = &timer;
-			return timer;
+
+//-------------------------------------------------
+//  parallel_group_callback - run the devices in
+//  one group up to the shared target on a worker
+//  thread
+//-------------------------------------------------
+
+void *device_scheduler::parallel_group_callback(void *param, int threadid)
+{
+	parallel_group &group = **reinterpret_cast<parallel_group **>(param);
+	device_scheduler &scheduler = group.m_scheduler;
+
+	for (int devnum = 0; devnum < group.m_devices.count(); devnum++)
+	{
+		device_execute_interface &exec = *group.m_devices[devnum];
+		attotime target = scheduler.parallel_target();
+		if ((exec.m_suspend == 0 || exec.m_eatcycles) && target.seconds >= exec.m_localtime.seconds)
+		{
+			scheduler.execute_device(exec, target, false, true);
+			scheduler.parallel_pull_target(target);
 		}
 	}
+	s_parallel_device = NULL;
+	return NULL;
+}
+
+
+//-------------------------------------------------
+//  timer_list_insert - add a new timer to the
+//  list of all timers and to the heap
+//-------------------------------------------------
 
-	// need to insert after the last one
-	if (prevtimer != NULL)
-		prevtimer->m_next = &timer;
+emu_timer &device_scheduler::timer_list_insert(emu_timer &timer)
+{
+	// append to the list of all timers; the order here doesn't matter
+	timer.m_prev = m_timer_list_tail;
+	timer.m_next = NULL;
+	if (m_timer_list_tail != NULL)
+		m_timer_list_tail->m_next = &timer;
 	else
 		m_timer_list = &timer;
+	m_timer_list_tail = &timer;
 
-	timer.m_prev = prevtimer;
-	timer.m_next = NULL;
+	// the heap is what keeps them in order
+	timer_heap_insert(timer);
 	return timer;
 }
 
 
 //-------------------------------------------------
 //  timer_list_remove - remove a timer from the
-//  linked list
+//  list of all timers and from the heap
 //-------------------------------------------------
 
 emu_timer &device_scheduler::timer_list_remove(emu_timer &timer)
@@ -864,24 +1140,148 @@ emu_timer &device_scheduler::timer_list_remove(emu_timer &timer)
 
 	if (timer.m_next != NULL)
 		timer.m_next->m_prev = timer.m_prev;
+	else
+		m_timer_list_tail = timer.m_prev;
 
+	// and from the heap, if it's there
+	if (timer.m_heapindex != -1)
+		timer_heap_remove(timer);
 	return timer;
 }
 
 
+//-------------------------------------------------
+//  timer_heap_insert - insert a timer into the
+//  heap according to its current expiration
+//-------------------------------------------------
+
+void device_scheduler::timer_heap_insert(emu_timer &timer)
+{
+	// disabled timers sort to the end
+	timer.m_heapexpire = timer.m_enabled ? timer.m_expire : attotime::never;
+	timer.m_heapsequence = m_timer_sequence++;
+
+	// add at the bottom and let it rise
+	timer.m_heapindex = m_timer_heap.count();
+	m_timer_heap.append(&timer);
+	timer_heap_move_up(timer.m_heapindex);
+}
+
+
+//-------------------------------------------------
+//  timer_heap_remove - remove a timer from the
+//  heap
+//-------------------------------------------------
+
+void device_scheduler::timer_heap_remove(emu_timer &timer)
+{
+	int index = timer.m_heapindex;
+	int last = m_timer_heap.count() - 1;
+	timer.m_heapindex = -1;
+
+	// move the last entry into the hole, then let it settle either way
+	if (index != last)
+	{
+		emu_timer *moved = m_timer_heap[last];
+		m_timer_heap[index] = moved;
+		moved->m_heapindex = index;
+		m_timer_heap.resize_keep(last);
+		timer_heap_move_up(index);
+		if (moved->m_heapindex == index)
+			timer_heap_move_down(index);
+	}
+	else
+		m_timer_heap.resize_keep(last);
+}
+
+
+//-------------------------------------------------
+//  timer_heap_update - move a timer to the right
+//  place in the heap after its expiration or
+//  enabled state changed
+//-------------------------------------------------
+
+void device_scheduler::timer_heap_update(emu_timer &timer)
+{
+	// re-sequence it, so it fires after anything else already due at the same time
+	timer.m_heapexpire = timer.m_enabled ? timer.m_expire : attotime::never;
+	timer.m_heapsequence = m_timer_sequence++;
+
+	int index = timer.m_heapindex;
+	timer_heap_move_up(index);
+	if (timer.m_heapindex == index)
+		timer_heap_move_down(index);
+}
+
+
+//-------------------------------------------------
+//  timer_heap_move_up - move an entry towards the
+//  top of the heap until it is in order
+//-------------------------------------------------
+
+void device_scheduler::timer_heap_move_up(int index)
+{
+	emu_timer *timer = m_timer_heap[index];
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (!timer->heap_before(*m_timer_heap[parent]))
+			break;
+		m_timer_heap[index] = m_timer_heap[parent];
+		m_timer_heap[index]->m_heapindex = index;
+		index = parent;
+	}
+	m_timer_heap[index] = timer;
+	timer->m_heapindex = index;
+}
+
+
+//-------------------------------------------------
+//  timer_heap_move_down - move an entry towards
+//  the bottom of the heap until it is in order
+//-------------------------------------------------
+
+void device_scheduler::timer_heap_move_down(int index)
+{
+	int count = m_timer_heap.count();
+	if (index >= count)
+		return;
+
+	emu_timer *timer = m_timer_heap[index];
+	while (true)
+	{
+		// pick the earlier of the two children
+		int child = index * 2 + 1;
+		if (child >= count)
+			break;
+		if (child + 1 < count && m_timer_heap[child + 1]->heap_before(*m_timer_heap[child]))
+			child++;
+
+		// stop once we are earlier than both
+		if (!m_timer_heap[child]->heap_before(*timer))
+			break;
+		m_timer_heap[index] = m_timer_heap[child];
+		m_timer_heap[index]->m_heapindex = index;
+		index = child;
+	}
+	m_timer_heap[index] = timer;
+	timer->m_heapindex = index;
+}
+
+
 //-------------------------------------------------
 //  execute_timers - execute timers that are due
 //-------------------------------------------------
 
 inline void device_scheduler::execute_timers()
 {
-	LOG(("execute_timers: new=%s head->expire=%s\n", m_basetime.as_string(PRECISION), m_timer_list->m_expire.as_string(PRECISION)));
+	LOG(("execute_timers: new=%s head->expire=%s\n", m_basetime.as_string(PRECISION), m_timer_heap[0]->m_heapexpire.as_string(PRECISION)));
 
 	// now process any timers that are overdue
-	while (m_timer_list->m_expire <= m_basetime)
+	while (m_timer_heap[0]->m_heapexpire <= m_basetime)
 	{
 		// if this is a one-shot timer, disable it now
-		emu_timer &timer = *m_timer_list;
+		emu_timer &timer = *m_timer_heap[0];
 		bool was_enabled = timer.m_enabled;
 		if (timer.m_period.is_zero() || timer.m_period.is_never())
 			timer.m_enabled = false;
@@ -895,6 +1295,9 @@ inline void device_scheduler::execute_timers()
 		if (was_enabled)
 		{
 			g_profiler.start(PROFILER_TIMER_CALLBACK);
+			if (g_profiler.enabled() && timer.m_profiler == PROFILER_TOTAL)
+				timer.m_profiler = timer.profiler_scope();
+			g_profiler.start(timer.m_profiler);
 
 			if (timer.m_device != NULL)
 			{
@@ -908,6 +1311,7 @@ inline void device_scheduler::execute_timers()
 			}
 
 			g_profiler.stop();
+			g_profiler.stop();
 		}
 
 		// clear the callback timer global
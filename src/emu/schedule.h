@@ -93,6 +93,17 @@ private:
 	void register_save();
 	void schedule_next_period();
 	void dump() const;
+	profile_type profiler_scope() const;
+
+	// timers due at the same time fire in the order they were scheduled
+	bool heap_before(const emu_timer &other) const
+	{
+		if (m_heapexpire.seconds != other.m_heapexpire.seconds)
+			return m_heapexpire.seconds < other.m_heapexpire.seconds;
+		if (m_heapexpire.attoseconds != other.m_heapexpire.attoseconds)
+			return m_heapexpire.attoseconds < other.m_heapexpire.attoseconds;
+		return m_heapsequence < other.m_heapsequence;
+	}
 
 	// internal state
 	running_machine *   m_machine;      // reference to the owning machine
@@ -108,6 +119,10 @@ private:
 	attotime            m_expire;       // time when the timer will expire
 	device_t *          m_device;       // for device timers, a pointer to the device
 	device_timer_id     m_id;           // for device timers, the ID of the timer
+	attotime            m_heapexpire;   // expiration time the heap is ordered by
+	UINT64              m_heapsequence; // order of insertion, to break ties
+	int                 m_heapindex;    // index in the scheduler's heap, or -1 if not present
+	profile_type        m_profiler;     // profiler scope, assigned the first time it fires while profiling
 };
 
 
@@ -127,7 +142,8 @@ public:
 	running_machine &machine() const { return m_machine; }
 	attotime time() const;
 	emu_timer *first_timer() const { return m_timer_list; }
-	device_execute_interface *currently_executing() const { return m_executing_device; }
+	emu_timer *next_timer() const { return m_timer_heap[0]; }
+	device_execute_interface *currently_executing() const { return (s_parallel_device != NULL) ? s_parallel_device : m_executing_device; }
 	bool can_save() const;
 
 	// execution
@@ -135,7 +151,8 @@ public:
 	void abort_timeslice();
 	void trigger(int trigid, const attotime &after = attotime::zero);
 	void boost_interleave(const attotime &timeslice_time, const attotime &boost_duration);
-	void suspend_resume_changed() { m_suspend_changes_pending = true; }
+	void suspend_resume_changed() { m_suspend_changes_pending = true; m_adaptive_contact = true; }
+	void set_execution_timing(bool enable) { m_execution_timing = enable; }
 
 	// timers, specified by callback/name
 	emu_timer *timer_alloc(timer_expired_delegate callback, void *ptr = NULL);
@@ -170,10 +187,27 @@ private:
 	void rebuild_execute_list();
 	void apply_suspend_changes();
 	void add_scheduling_quantum(const attotime &quantum, const attotime &duration);
+	void execute_device(device_execute_interface &exec, attotime &target, bool call_debugger, bool parallel);
+	attoseconds_t adaptive_quantum(attoseconds_t quantum);
+	void count_quantum(attoseconds_t quantum);
+
+	// parallel execution helpers
+	class parallel_group;
+	void rebuild_parallel_groups();
+	static void *parallel_group_callback(void *param, int threadid);
+	void parallel_lock() { if (m_parallel_active) osd_lock_acquire(m_parallel_lock); }
+	void parallel_unlock() { if (m_parallel_active) osd_lock_release(m_parallel_lock); }
+	attotime parallel_target();
+	void parallel_pull_target(const attotime &target);
 
 	// timer helpers
 	emu_timer &timer_list_insert(emu_timer &timer);
 	emu_timer &timer_list_remove(emu_timer &timer);
+	void timer_heap_insert(emu_timer &timer);
+	void timer_heap_remove(emu_timer &timer);
+	void timer_heap_update(emu_timer &timer);
+	void timer_heap_move_up(int index);
+	void timer_heap_move_down(int index);
 	void execute_timers();
 
 	// internal state
@@ -183,7 +217,10 @@ private:
 	attotime                    m_basetime;                 // global basetime; everything moves forward from here
 
 	// list of active timers
-	emu_timer *                 m_timer_list;               // head of the active list
+	emu_timer *                 m_timer_list;               // head of the list of all timers, unordered
+	emu_timer *                 m_timer_list_tail;          // tail of the list of all timers
+	dynamic_array<emu_timer *>  m_timer_heap;               // binary heap of all timers, soonest first
+	UINT64                      m_timer_sequence;           // sequence number for the next heap insertion
 	fixed_allocator<emu_timer>  m_timer_allocator;          // allocator for timers
 
 	// other internal states
@@ -208,6 +245,42 @@ private:
 	simple_list<quantum_slot>   m_quantum_list;             // list of active quanta
 	fixed_allocator<quantum_slot> m_quantum_allocator;      // allocator for quanta
 	attoseconds_t               m_quantum_minimum;          // duration of minimum quantum
+	bool                        m_execution_timing;         // true to accumulate wall-clock time per device
+
+	// adaptive quantum state
+	bool                        m_adaptive_enabled;         // true if we may widen the quantum
+	volatile bool               m_adaptive_contact;         // true if CPUs interacted since the last check
+	int                         m_adaptive_shift;           // current widening, as a power of 2
+	int                         m_adaptive_quiet;           // number of quiet quanta at the current width
+
+	// groups of devices that run on their own threads
+	class parallel_group
+	{
+		friend class simple_list<parallel_group>;
+
+	public:
+		parallel_group(device_scheduler &scheduler, int group)
+			: m_next(NULL),
+				m_scheduler(scheduler),
+				m_group(group) { }
+
+		parallel_group *next() const { return m_next; }
+
+		parallel_group *        m_next;
+		device_scheduler &      m_scheduler;                // the owning scheduler
+		int                     m_group;                    // group number from the configuration
+		dynamic_array<device_execute_interface *> m_devices; // devices in the group, in execution order
+	};
+	bool                        m_parallel_enabled;         // true if parallel groups are allowed at all
+	volatile bool               m_parallel_active;          // true while groups are running
+	simple_list<parallel_group> m_parallel_list;            // list of all groups
+	dynamic_array<parallel_group *> m_parallel_groups;      // groups with devices to run
+	osd_work_queue *            m_parallel_queue;           // queue the groups run on
+	osd_lock *                  m_parallel_lock;            // lock for timer changes while groups run
+	attotime                    m_parallel_target;          // target shared by all threads, under the lock
+
+	// the device being executed by a parallel group on the current thread
+	static ATTR_THREAD_LOCAL device_execute_interface *s_parallel_device;
 };
 
 
@@ -74,7 +74,8 @@ screen_device::screen_device(const machine_config &mconfig, const char *tag, dev
 		m_scanline0_timer(NULL),
 		m_scanline_timer(NULL),
 		m_frame_number(0),
-		m_partial_updates_this_frame(0)
+		m_partial_updates_this_frame(0),
+		m_profiler(PROFILER_VIDEO)
 {
 	m_unique_id = m_id_counter;
 	m_id_counter++;
@@ -280,6 +281,7 @@ void screen_device::device_start()
 	m_screen_update_ind16.bind_relative_to(*owner());
 	m_screen_update_rgb32.bind_relative_to(*owner());
 	m_screen_vblank.bind_relative_to(*owner());
+	m_profiler = g_profiler.scope(astring("'", tag(), "' update"));
 
 	// if we have a palette and it's not started, wait for it
 	if (m_palette != NULL && !m_palette->started())
@@ -615,6 +617,9 @@ bool screen_device::update_partial(int scanline)
 	// otherwise, render
 	LOG_PARTIAL_UPDATES(("updating %d-%d\n", clip.min_y, clip.max_y));
 	g_profiler.start(PROFILER_VIDEO);
+	g_profiler.start(m_profiler);
+	frame_benchmark *bench = machine().benchmark();
+	osd_ticks_t start = (bench != NULL) ? osd_ticks() : 0;
 
 	UINT32 flags = UPDATE_HAS_NOT_CHANGED;
 	screen_bitmap &curbitmap = m_bitmap[m_curbitmap];
@@ -626,6 +631,9 @@ bool screen_device::update_partial(int scanline)
 	}
 
 	m_partial_updates_this_frame++;
+	if (bench != NULL)
+		bench->add_video_ticks(osd_ticks() - start);
+	g_profiler.stop();
 	g_profiler.stop();
 
 	// if we modified the bitmap, we have to commit
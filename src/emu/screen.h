@@ -298,6 +298,7 @@ private:
 	emu_timer *         m_scanline_timer;           // scanline timer
 	UINT64              m_frame_number;             // the current frame number
 	UINT32              m_partial_updates_this_frame;// partial update counter this frame
+	profile_type        m_profiler;                 // profiler scope for screen updates
 
 	// VBLANK callbacks
 	class callback_item
@@ -51,6 +51,7 @@ const attotime sound_manager::STREAMS_UPDATE_ATTOTIME = attotime::from_hz(STREAM
 sound_stream::sound_stream(device_t &device, int inputs, int outputs, int sample_rate,  stream_update_delegate callback)
 	: m_device(device),
 		m_next(NULL),
+		m_schedule_level(-1),
 		m_sample_rate(sample_rate),
 		m_new_sample_rate(0),
 		m_attoseconds_per_sample(0),
@@ -64,7 +65,8 @@ sound_stream::sound_stream(device_t &device, int inputs, int outputs, int sample
 		m_output_sampindex(0),
 		m_output_update_sampindex(0),
 		m_output_base_sampindex(0),
-		m_callback(callback)
+		m_callback(callback),
+		m_profiler(g_profiler.scope(astring("'", device.tag(), "' stream")))
 {
 	// get the device's sound interface
 	device_sound_interface *sound;
@@ -248,6 +250,7 @@ void sound_stream::set_input(int index, sound_stream *input_stream, int output_i
 	// update the dependent info
 	if (input.m_source != NULL)
 		input.m_source->m_dependents++;
+	m_device.machine().sound().m_schedule_dirty = true;
 
 	// update sample rates now that we know the input
 	recompute_sample_rate_data();
@@ -280,12 +283,18 @@ void sound_stream::update()
 		update_sampindex -= m_sample_rate;
 	}
 
+	// nothing to do if we've already been brought up to date
+	if (update_sampindex == m_output_sampindex)
+		return;
+
 	// generate samples to get us up to the appropriate time
 	g_profiler.start(PROFILER_SOUND);
+	g_profiler.start(m_profiler);
 	assert(m_output_sampindex - m_output_base_sampindex >= 0);
 	assert(update_sampindex - m_output_base_sampindex <= m_output_bufalloc);
 	generate_samples(update_sampindex - m_output_sampindex);
 	g_profiler.stop();
+	g_profiler.stop();
 
 	// remember this info for next time
 	m_output_sampindex = update_sampindex;
@@ -502,6 +511,23 @@ void sound_stream::recompute_sample_rate_data()
 			else if (input.m_source->m_stream->m_sample_rate == m_sample_rate)
 				latency = 0;
 
+			// the band-limited filter needs half of its taps' worth of samples from the
+			// future, so only use it if that fits within an update
+			input.m_filter_taps = 0;
+			if (m_device.machine().options().resample_quality() > 0 && input.m_source->m_stream->m_sample_rate != m_sample_rate)
+			{
+				UINT32 step = (UINT64(input.m_source->m_stream->m_sample_rate) << FRAC_BITS) / m_sample_rate;
+				int taps = stream_resample_taps(step);
+				attoseconds_t filter_latency = MAX(new_attosecs_per_sample, m_attoseconds_per_sample) + (taps / 2) * new_attosecs_per_sample;
+				if (taps != 0 && filter_latency < update_attoseconds)
+				{
+					input.m_filter.resize(RESAMPLE_PHASES * taps);
+					stream_build_resample_filter(&input.m_filter[0], taps, step);
+					input.m_filter_taps = taps;
+					latency = MAX(latency, filter_latency);
+				}
+			}
+
 			// we generally don't want to tweak the latency, so we just keep the greatest
 			// one we've computed thus far
 			input.m_latency_attoseconds = MAX(input.m_latency_attoseconds, latency);
@@ -667,79 +693,15 @@ stream_sample_t *sound_stream::generate_resampled_data(stream_input &input, UINT
 	// compute the stepping fraction
 	UINT32 step = (UINT64(input_stream.m_sample_rate) << FRAC_BITS) / m_sample_rate;
 
-	// if we have equal sample rates, we just need to copy
-	if (step == FRAC_ONE)
-	{
-		while (numsamples--)
-		{
-			// compute the sample
-			INT64 sample = *source++;
-			*dest++ = (sample * gain) >> 8;
-		}
-	}
-
-	// input is undersampled: point sample except where our sample period covers a boundary
-	else if (step < FRAC_ONE)
-	{
-		while (numsamples != 0)
-		{
-			// fill in with point samples until we hit a boundary
-			int nextfrac;
-			while ((nextfrac = basefrac + step) < FRAC_ONE && numsamples--)
-			{
-				*dest++ = (source[0] * gain) >> 8;
-				basefrac = nextfrac;
-			}
-
-			// if we're done, we're done
-			if (INT32(numsamples--) < 0)
-				break;
-
-			// compute starting and ending fractional positions
-			int startfrac = basefrac >> (FRAC_BITS - 12);
-			int endfrac = nextfrac >> (FRAC_BITS - 12);
-
-			// blend between the two samples accordingly
-			INT64 sample = ((INT64) source[0] * (0x1000 - startfrac) + (INT64) source[1] * (endfrac - 0x1000)) / (endfrac - startfrac);
-			*dest++ = (sample * gain) >> 8;
-
-			// advance
-			basefrac = nextfrac & FRAC_MASK;
-			source++;
-		}
-	}
-
-	// input is oversampled: sum the energy
+	// use the band-limited filter if we have one and enough history for it
+	int history = input.m_filter_taps / 2 - 1;
+	if (input.m_filter_taps != 0 && basesample - history >= input_stream.m_output_base_sampindex)
+		stream_resample_bandlimited(dest, source - history, numsamples, basefrac, step, &input.m_filter[0], input.m_filter_taps);
 	else
-	{
-		// use 8 bits to allow some extra headroom
-		int smallstep = step >> (FRAC_BITS - 8);
-		while (numsamples--)
-		{
-			INT64 remainder = smallstep;
-			int tpos = 0;
-
-			// compute the sample
-			INT64 scale = (FRAC_ONE - basefrac) >> (FRAC_BITS - 8);
-			INT64 sample = (INT64) source[tpos++] * scale;
-			remainder -= scale;
-			while (remainder > 0x100)
-			{
-				sample += (INT64) source[tpos++] * (INT64) 0x100;
-				remainder -= 0x100;
-			}
-			sample += (INT64) source[tpos] * remainder;
-			sample /= smallstep;
-
-			*dest++ = (sample * gain) >> 8;
-
-			// advance
-			basefrac += step;
-			source += basefrac >> FRAC_BITS;
-			basefrac &= FRAC_MASK;
-		}
-	}
+		stream_resample_linear(dest, source, numsamples, basefrac, step);
 
+	// apply the gain afterwards, where it can be done in bulk
+	stream_scale_samples(dest, numsamples, gain);
 	return input.m_resample;
 }
 
@@ -757,7 +719,8 @@ sound_stream::stream_input::stream_input()
 	: m_source(NULL),
 		m_latency_attoseconds(0),
 		m_gain(0x100),
-		m_user_gain(0x100)
+		m_user_gain(0x100),
+		m_filter_taps(0)
 {
 }
 
@@ -799,7 +762,9 @@ sound_manager::sound_manager(running_machine &machine)
 		m_nosound_mode(machine.osd().no_sound()),
 		m_wavfile(NULL),
 		m_update_attoseconds(STREAMS_UPDATE_ATTOTIME.attoseconds),
-		m_last_update(attotime::zero)
+		m_last_update(attotime::zero),
+		m_schedule_dirty(true),
+		m_stream_queue(NULL)
 {
 	// get filename for WAV file or AVI file if specified
 	const char *wavfile = machine.options().wav_write();
@@ -819,6 +784,10 @@ sound_manager::sound_manager(running_machine &machine)
 	if (wavfile[0] != 0)
 		m_wavfile = wav_open(wavfile, machine.sample_rate(), 2);
 
+	// set up worker threads if streams are to be updated in parallel
+	if (machine.options().parallel_sound())
+		m_stream_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+
 	// register callbacks
 	config_register(machine, "mixer", config_saveload_delegate(FUNC(sound_manager::config_load), this), config_saveload_delegate(FUNC(sound_manager::config_save), this));
 	machine.add_notifier(MACHINE_NOTIFY_PAUSE, machine_notify_delegate(FUNC(sound_manager::pause), this));
@@ -847,6 +816,10 @@ sound_manager::~sound_manager()
 	if (m_wavfile != NULL)
 		wav_close(m_wavfile);
 	m_wavfile = NULL;
+
+	// free the work queue
+	if (m_stream_queue != NULL)
+		osd_work_queue_free(m_stream_queue);
 }
 
 
@@ -856,6 +829,7 @@ sound_manager::~sound_manager()
 
 sound_stream *sound_manager::stream_alloc(device_t &device, int inputs, int outputs, int sample_rate, stream_update_delegate callback)
 {
+	m_schedule_dirty = true;
 	return &m_stream_list.append(*global_alloc(sound_stream(device, inputs, outputs, sample_rate, callback)));
 }
 
@@ -1017,6 +991,11 @@ void sound_manager::update(void *ptr, int param)
 	VPRINTF(("sound_update\n"));
 
 	g_profiler.start(PROFILER_SOUND);
+	frame_benchmark *bench = machine().benchmark();
+	osd_ticks_t start = (bench != NULL) ? osd_ticks() : 0;
+
+	// bring all the streams up to date, inputs first
+	update_streams();
 
 	// force all the speaker streams to generate the proper number of samples
 	int samples_this_update = 0;
@@ -1028,28 +1007,38 @@ void sound_manager::update(void *ptr, int param)
 	UINT32 finalmix_step = machine().video().speed_factor();
 	UINT32 finalmix_offset = 0;
 	INT16 *finalmix = m_finalmix;
-	int sample;
-	for (sample = m_finalmix_leftover; sample < samples_this_update * 1000; sample += finalmix_step)
+	if (finalmix_step == 1000)
+	{
+		// at normal speed every sample is used once, so this is just a clamp and interleave
+		stream_clamp_interleave(finalmix, m_leftmix, m_rightmix, samples_this_update);
+		finalmix_offset = samples_this_update * 2;
+	}
+	else
 	{
-		int sampindex = sample / 1000;
-
-		// clamp the left side
-		INT32 samp = m_leftmix[sampindex];
-		if (samp < -32768)
-			samp = -32768;
-		else if (samp > 32767)
-			samp = 32767;
-		finalmix[finalmix_offset++] = samp;
-
-		// clamp the right side
-		samp = m_rightmix[sampindex];
-		if (samp < -32768)
-			samp = -32768;
-		else if (samp > 32767)
-			samp = 32767;
-		finalmix[finalmix_offset++] = samp;
+		// otherwise, we skip or repeat samples as needed
+		int sample;
+		for (sample = m_finalmix_leftover; sample < samples_this_update * 1000; sample += finalmix_step)
+		{
+			int sampindex = sample / 1000;
+
+			// clamp the left side
+			INT32 samp = m_leftmix[sampindex];
+			if (samp < -32768)
+				samp = -32768;
+			else if (samp > 32767)
+				samp = 32767;
+			finalmix[finalmix_offset++] = samp;
+
+			// clamp the right side
+			samp = m_rightmix[sampindex];
+			if (samp < -32768)
+				samp = -32768;
+			else if (samp > 32767)
+				samp = 32767;
+			finalmix[finalmix_offset++] = samp;
+		}
+		m_finalmix_leftover = sample - samples_this_update * 1000;
 	}
-	m_finalmix_leftover = sample - samples_this_update * 1000;
 
 	// play the result
 	if (finalmix_offset > 0)
@@ -1081,5 +1070,114 @@ void sound_manager::update(void *ptr, int param)
 	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
 		stream->apply_sample_rate_changes();
 
+	if (bench != NULL)
+		bench->add_sound_ticks(osd_ticks() - start);
 	g_profiler.stop();
 }
+
+
+//-------------------------------------------------
+//  update_streams - update every stream in
+//  schedule order, so that each one's inputs are
+//  already up to date when it pulls from them
+//-------------------------------------------------
+
+void sound_manager::update_streams()
+{
+	if (m_schedule_dirty)
+		build_schedule();
+
+	for (int level = 0; level < m_schedule_level_start.count() - 1; level++)
+	{
+		int first = m_schedule_level_start[level];
+		int count = m_schedule_level_start[level + 1] - first;
+
+		// streams at the same level don't feed each other, so they can go in parallel;
+		// the profiler isn't thread-safe, so don't do this while it's running
+		if (m_stream_queue != NULL && count > 1 && !g_profiler.enabled())
+		{
+			osd_work_item_queue_multiple(m_stream_queue, update_stream_callback, count, &m_schedule[first], sizeof(m_schedule[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+			while (!osd_work_queue_wait(m_stream_queue, osd_ticks_per_second()))
+				;
+		}
+		else
+			for (int index = first; index < first + count; index++)
+				m_schedule[index]->update();
+	}
+}
+
+
+//-------------------------------------------------
+//  update_stream_callback - update a single
+//  stream on a worker thread
+//-------------------------------------------------
+
+void *sound_manager::update_stream_callback(void *param, int threadid)
+{
+	sound_stream *stream = *reinterpret_cast<sound_stream **>(param);
+	stream->update();
+	return NULL;
+}
+
+
+//-------------------------------------------------
+//  build_schedule - sort the streams by level,
+//  so that every stream comes after all of its
+//  inputs
+//-------------------------------------------------
+
+void sound_manager::build_schedule()
+{
+	// work out each stream's level
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		stream->m_schedule_level = -1;
+	int levels = 0;
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		levels = MAX(levels, schedule_level(*stream) + 1);
+
+	// count the streams at each level, and turn that into starting indexes
+	m_schedule_level_start.resize_and_clear(levels + 1);
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		m_schedule_level_start[stream->m_schedule_level + 1]++;
+	for (int level = 0; level < levels; level++)
+		m_schedule_level_start[level + 1] += m_schedule_level_start[level];
+
+	// then drop the streams into place
+	dynamic_array<int> next;
+	next.copyfrom(m_schedule_level_start);
+	m_schedule.resize(m_stream_list.count());
+	for (sound_stream *stream = m_stream_list.first(); stream != NULL; stream = stream->next())
+		m_schedule[next[stream->m_schedule_level]++] = stream;
+
+	osd_printf_verbose("Sound: %d streams scheduled in %d levels%s\n", m_schedule.count(), levels, (m_stream_queue != NULL) ? ", updated in parallel" : "");
+	m_schedule_dirty = false;
+}
+
+
+//-------------------------------------------------
+//  schedule_level - return the level of a stream:
+//  0 if it has no inputs, otherwise one more
+//  than the highest level of its inputs
+//-------------------------------------------------
+
+int sound_manager::schedule_level(sound_stream &stream)
+{
+	// already computed
+	if (stream.m_schedule_level >= 0)
+		return stream.m_schedule_level;
+
+	// in progress means a loop, which can't be updated anyway; just don't hang here
+	if (stream.m_schedule_level == -2)
+		return 0;
+
+	stream.m_schedule_level = -2;
+	int level = 0;
+	for (int inputnum = 0; inputnum < stream.m_input.count(); inputnum++)
+	{
+		sound_stream::stream_input &input = stream.m_input[inputnum];
+		if (input.m_source != NULL)
+			level = MAX(level, schedule_level(*input.m_source->m_stream) + 1);
+	}
+	stream.m_schedule_level = level;
+	return level;
+}
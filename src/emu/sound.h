@@ -17,6 +17,8 @@
 #ifndef __SOUND_H__
 #define __SOUND_H__
 
+#include "resample.h"
+
 
 //**************************************************************************
 //  CONSTANTS
@@ -86,13 +88,15 @@ class sound_stream
 		attoseconds_t       m_latency_attoseconds;  // latency between this stream and the input stream
 		INT16               m_gain;                 // gain to apply to this input
 		INT16               m_user_gain;            // user-controlled gain to apply to this input
+		dynamic_array<float> m_filter;              // band-limited resampling filter, if any
+		int                 m_filter_taps;          // number of taps in the filter, or 0 to resample linearly
 	};
 
 	// constants
 	static const int OUTPUT_BUFFER_UPDATES      = 5;
-	static const UINT32 FRAC_BITS               = 22;
-	static const UINT32 FRAC_ONE                = 1 << FRAC_BITS;
-	static const UINT32 FRAC_MASK               = FRAC_ONE - 1;
+	static const UINT32 FRAC_BITS               = RESAMPLE_FRAC_BITS;
+	static const UINT32 FRAC_ONE                = RESAMPLE_FRAC_ONE;
+	static const UINT32 FRAC_MASK               = RESAMPLE_FRAC_MASK;
 
 	// construction/destruction
 	sound_stream(device_t &device, int inputs, int outputs, int sample_rate, stream_update_delegate callback);
@@ -141,6 +145,7 @@ private:
 	// linking information
 	device_t &          m_device;                     // owning device
 	sound_stream *      m_next;                       // next stream in the chain
+	int                 m_schedule_level;             // number of streams feeding this one in series
 
 	// general information
 	UINT32              m_sample_rate;                // sample rate of this stream
@@ -171,6 +176,7 @@ private:
 
 	// callback information
 	stream_update_delegate  m_callback;                   // callback function
+	profile_type        m_profiler;                   // profiler scope for the callback
 };
 
 
@@ -226,6 +232,10 @@ private:
 	void config_save(int config_type, xml_data_node *parentnode);
 
 	void update(void *ptr = NULL, INT32 param = 0);
+	void update_streams();
+	void build_schedule();
+	int schedule_level(sound_stream &stream);
+	static void *update_stream_callback(void *param, int threadid);
 
 	// internal state
 	running_machine &   m_machine;              // reference to our machine
@@ -246,6 +256,12 @@ private:
 	simple_list<sound_stream> m_stream_list;    // list of streams
 	attoseconds_t       m_update_attoseconds;   // attoseconds between global updates
 	attotime            m_last_update;          // last update time
+
+	// update schedule
+	dynamic_array<sound_stream *> m_schedule;   // streams in order of level, inputs first
+	dynamic_array<int>  m_schedule_level_start; // index of the first stream at each level, plus the end
+	bool                m_schedule_dirty;       // true if streams have been added or rewired
+	osd_work_queue *    m_stream_queue;         // work queue for updating streams in parallel, if enabled
 };
 
 
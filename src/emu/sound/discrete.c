@@ -61,6 +61,22 @@ const device_type DISCRETE = &device_creator<discrete_sound_device>;
 
 #define MAX_SAMPLES_PER_TASK_SLICE  (960/4)
 
+/*
+ * Waking up the worker threads costs about as much as a few thousand
+ * node steps. Updates with fewer steps than this (samples times the
+ * number of step nodes) are run on the calling thread, one task after
+ * the other.
+ */
+
+#define MIN_STEPS_FOR_PARALLEL_UPDATE   (8192)
+
+/*
+ * Thread id used to lock tasks when the updating thread takes part in
+ * processing them. Worker threads are numbered from 0.
+ */
+
+#define CALLER_THREADID             (0x7fffffff)
+
 /*************************************
  *
  *  Debugging
@@ -87,7 +103,8 @@ struct output_buffer
 {
 	double                      *node_buf;
 	const double                *source;
-	volatile double             *ptr;
+	double                      *ptr;               /* write position, only touched by the producing task */
+	volatile INT32              published;          /* samples in node_buf visible to consuming tasks */
 	int                         node_num;
 };
 
@@ -98,6 +115,32 @@ struct input_buffer
 	double                      buffer;             /* input[] will point here */
 };
 
+/* fused node types; anything not listed runs its own step() */
+enum
+{
+	FUSED_STEP = 0,
+	FUSED_ADDER,
+	FUSED_CLAMP,
+	FUSED_GAIN,
+	FUSED_SWITCH,
+	FUSED_ASWITCH,
+	FUSED_LOGIC_INV,
+	FUSED_LOGIC_AND,
+	FUSED_LOGIC_NAND,
+	FUSED_LOGIC_OR,
+	FUSED_LOGIC_NOR,
+	FUSED_LOGIC_XOR,
+	FUSED_LOGIC_NXOR
+};
+
+struct fused_op
+{
+	int                         type;               /* FUSED_xxx */
+	discrete_step_interface *   node;               /* node this op stands for */
+	double *                    out;                /* the node's output 0 */
+	const double *              in[5];              /* the node's inputs, resolved once */
+};
+
 class discrete_task
 {
 	friend class discrete_device;
@@ -105,6 +148,7 @@ public:
 	virtual ~discrete_task(void) { }
 
 	inline void step_nodes(void);
+	inline void step_validate(void);
 	inline bool lock_threadid(INT32 threadid)
 	{
 		INT32 prev_id;
@@ -124,11 +168,13 @@ public:
 
 protected:
 	discrete_task(discrete_device &pdev)
-	: task_group(0), m_device(pdev), m_threadid(-1)
+	: task_group(0), m_device(pdev), m_run_time(0), m_blocks(0), m_stalls(0),
+		m_validated(0), m_mismatches(0), m_first_mismatch(NULL), m_threadid(-1)
 	{
 		source_list.clear();
 		step_list.clear();
 		m_buffers.clear();
+		m_ops.clear();
 	}
 
 	static void *task_callback(void *param, int threadid);
@@ -136,10 +182,22 @@ protected:
 
 	void check(discrete_task *dest_task);
 	void prepare_for_queue(int samples);
+	void compile(void);
 
 	dynamic_array_t<output_buffer>      m_buffers;
+	dynamic_array_t<fused_op>           m_ops;
 	discrete_device &                   m_device;
 
+	/* profiling */
+	osd_ticks_t             m_run_time;         /* time spent stepping, including buffering */
+	UINT64                  m_blocks;           /* number of blocks processed */
+	UINT64                  m_stalls;           /* times we had to wait for a source task */
+
+	/* validation */
+	UINT64                  m_validated;        /* fused results compared */
+	UINT64                  m_mismatches;       /* fused results that differed */
+	discrete_base_node *    m_first_mismatch;   /* first node that differed */
+
 private:
 	volatile INT32          m_threadid;
 	volatile int            m_samples;
@@ -168,6 +226,74 @@ private:
 
 
 
+/*************************************
+ *
+ *  Fused nodes
+ *
+ *************************************/
+
+/* must match the step() of the corresponding node exactly */
+static inline double fused_eval(const fused_op &op)
+{
+	switch (op.type)
+	{
+		case FUSED_ADDER:
+			return *op.in[0] ? *op.in[1] + *op.in[2] + *op.in[3] + *op.in[4] : 0;
+		case FUSED_CLAMP:
+			return (*op.in[0] < *op.in[1]) ? *op.in[1] : (*op.in[0] > *op.in[2]) ? *op.in[2] : *op.in[0];
+		case FUSED_GAIN:
+			return *op.in[0] * *op.in[1] + *op.in[2];
+		case FUSED_SWITCH:
+			return *op.in[0] ? (*op.in[1] ? *op.in[3] : *op.in[2]) : 0;
+		case FUSED_ASWITCH:
+			return *op.in[0] > *op.in[2] ? *op.in[1] : 0;
+		case FUSED_LOGIC_INV:
+			return *op.in[0] ? 0.0 : 1.0;
+		case FUSED_LOGIC_AND:
+			return (*op.in[0] && *op.in[1] && *op.in[2] && *op.in[3]) ? 1.0 : 0.0;
+		case FUSED_LOGIC_NAND:
+			return (*op.in[0] && *op.in[1] && *op.in[2] && *op.in[3]) ? 0.0 : 1.0;
+		case FUSED_LOGIC_OR:
+			return (*op.in[0] || *op.in[1] || *op.in[2] || *op.in[3]) ? 1.0 : 0.0;
+		case FUSED_LOGIC_NOR:
+			return (*op.in[0] || *op.in[1] || *op.in[2] || *op.in[3]) ? 0.0 : 1.0;
+		case FUSED_LOGIC_XOR:
+			return ((*op.in[0] && !*op.in[1]) || (!*op.in[0] && *op.in[1])) ? 1.0 : 0.0;
+		case FUSED_LOGIC_NXOR:
+			return ((*op.in[0] && !*op.in[1]) || (!*op.in[0] && *op.in[1])) ? 0.0 : 1.0;
+	}
+	return 0;
+}
+
+static int fused_type(discrete_base_node *node)
+{
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_adder) *>(node) != NULL)
+		return FUSED_ADDER;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_clamp) *>(node) != NULL)
+		return FUSED_CLAMP;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_gain) *>(node) != NULL)
+		return FUSED_GAIN;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_switch) *>(node) != NULL)
+		return FUSED_SWITCH;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_aswitch) *>(node) != NULL)
+		return FUSED_ASWITCH;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_inv) *>(node) != NULL)
+		return FUSED_LOGIC_INV;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_and) *>(node) != NULL)
+		return FUSED_LOGIC_AND;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_nand) *>(node) != NULL)
+		return FUSED_LOGIC_NAND;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_or) *>(node) != NULL)
+		return FUSED_LOGIC_OR;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_nor) *>(node) != NULL)
+		return FUSED_LOGIC_NOR;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_xor) *>(node) != NULL)
+		return FUSED_LOGIC_XOR;
+	if (dynamic_cast<DISCRETE_CLASS_NAME(dst_logic_nxor) *>(node) != NULL)
+		return FUSED_LOGIC_NXOR;
+	return FUSED_STEP;
+}
+
 /*************************************
  *
  *  Task implementation
@@ -181,14 +307,21 @@ inline void discrete_task::step_nodes(void)
 		sn->buffer = *sn->ptr++;
 	}
 
-	if (EXPECTED(!m_device.profiling()))
+	if (EXPECTED(!m_device.profiling() && !m_device.validating()))
 	{
-		for_each(discrete_step_interface **, entry, &step_list)
+		for_each(fused_op *, op, &m_ops)
 		{
 			/* Now step the node */
-			(*entry)->step();
+			if (op->type == FUSED_STEP)
+				op->node->step();
+			else
+				*op->out = fused_eval(*op);
 		}
 	}
+	else if (!m_device.profiling())
+	{
+		step_validate();
+	}
 	else
 	{
 		osd_ticks_t last = get_profile_ticks();
@@ -209,6 +342,24 @@ inline void discrete_task::step_nodes(void)
 		*(outbuf->ptr++) = *outbuf->source;
 }
 
+inline void discrete_task::step_validate(void)
+{
+	for_each(fused_op *, op, &m_ops)
+	{
+		if (op->type == FUSED_STEP)
+			op->node->step();
+		else
+		{
+			/* compute the fused result, then let the node step itself and compare bit for bit */
+			double fused = fused_eval(*op);
+			op->node->step();
+			m_validated++;
+			if (memcmp(&fused, op->out, sizeof(fused)) != 0 && m_mismatches++ == 0)
+				m_first_mismatch = op->node->self;
+		}
+	}
+}
+
 void *discrete_task::task_callback(void *param, int threadid)
 {
 	task_list_t *list = (task_list_t *) param;
@@ -233,25 +384,52 @@ bool discrete_task::process(void)
 {
 	int samples = MIN(m_samples, MAX_SAMPLES_PER_TASK_SLICE);
 
-	/* check dependencies */
+	/* check dependencies
+	 * Every task works through the update in blocks of the same size and
+	 * sources publish whole blocks, so either our next block is there or
+	 * we have to come back later.
+	 */
 	for_each(input_buffer *, sn, &source_list)
 	{
 		int avail;
 
-		avail = sn->linked_outbuf->ptr - sn->ptr;
+		avail = sn->linked_outbuf->published - (sn->ptr - sn->linked_outbuf->node_buf);
 		assert_always(avail >= 0, "task_callback: available samples are negative");
 		if (avail < samples)
-			samples = avail;
+		{
+			if (m_device.profiling())
+				m_stalls++;
+			return true;
+		}
 	}
 
 	m_samples -= samples;
 	assert_always(m_samples >=0, "task_callback: task_samples got negative");
-	while (samples > 0)
+	if (EXPECTED(!m_device.profiling()))
 	{
-		/* step */
-		step_nodes();
-		samples--;
+		while (samples > 0)
+		{
+			/* step */
+			step_nodes();
+			samples--;
+		}
 	}
+	else
+	{
+		m_run_time -= get_profile_ticks();
+		while (samples > 0)
+		{
+			step_nodes();
+			samples--;
+		}
+		m_run_time += get_profile_ticks();
+		m_blocks++;
+	}
+
+	/* hand the block to the consuming tasks; the exchange orders the buffer writes before the count */
+	for_each(output_buffer *, ob, &m_buffers)
+		atomic_exchange32(&ob->published, ob->ptr - ob->node_buf);
+
 	if (m_samples == 0)
 	{
 		/* return and keep the task locked so it is not picked up by other worker threads */
@@ -265,7 +443,10 @@ void discrete_task::prepare_for_queue(int samples)
 	m_samples = samples;
 	/* set up task buffers */
 	for_each(output_buffer *, ob, &m_buffers)
+	{
 		ob->ptr = ob->node_buf;
+		ob->published = 0;
+	}
 
 	/* initialize sources */
 	for_each(input_buffer *, sn, &source_list)
@@ -274,6 +455,24 @@ void discrete_task::prepare_for_queue(int samples)
 	}
 }
 
+void discrete_task::compile(void)
+{
+	/* inputs must have been redirected to the source buffers already */
+	m_ops.clear();
+	for_each(discrete_step_interface **, entry, &step_list)
+	{
+		discrete_base_node *node = (*entry)->self;
+		fused_op op;
+
+		op.type = m_device.fusing() ? fused_type(node) : FUSED_STEP;
+		op.node = *entry;
+		op.out = &node->m_output[0];
+		for (int inputnum = 0; inputnum < ARRAY_LENGTH(op.in); inputnum++)
+			op.in[inputnum] = node->m_input[inputnum];
+		m_ops.add(op);
+	}
+}
+
 void discrete_task::check(discrete_task *dest_task)
 {
 	int inputnum;
@@ -318,6 +517,7 @@ void discrete_task::check(discrete_task *dest_task)
 							buf.node_buf = auto_alloc_array(m_device.machine(), double,
 									((task_node->sample_rate() + sound_manager::STREAMS_UPDATE_FREQUENCY) / sound_manager::STREAMS_UPDATE_FREQUENCY));
 							buf.ptr = buf.node_buf;
+							buf.published = 0;
 							buf.source = dest_node->m_input[inputnum];
 							buf.node_num = inputnode_num;
 							//buf.node = device->discrete_find_node(inputnode);
@@ -654,13 +854,36 @@ void discrete_device::display_profiling(void)
 	{
 		tt =  step_list_run_time((*task)->step_list);
 
-		printf("Task(%d): %8.2f %15.2f\n", (*task)->task_group, tt / (double) total * 100.0, tt / (double) m_total_samples);
+		printf("Task(%d): %8.2f %15.2f %15.2f %10" I64FMT "d %10" I64FMT "d\n", (*task)->task_group, tt / (double) total * 100.0, tt / (double) m_total_samples,
+				(double) (*task)->m_run_time / (double) m_total_samples, (*task)->m_blocks, (*task)->m_stalls);
 	}
+	printf("Updates run on the calling thread: %" I64FMT "d of %" I64FMT "d\n", m_inline_updates, m_total_stream_updates);
 
 	printf("Average samples/double->update: %8.2f\n", (double) m_total_samples / (double) m_total_stream_updates);
 }
 
 
+void discrete_device::display_validation(void)
+{
+	UINT64 validated = 0;
+	UINT64 mismatches = 0;
+	int fused = 0;
+
+	for_each(discrete_task **, task, &task_list)
+	{
+		for_each(fused_op *, op, &(*task)->m_ops)
+			if (op->type != FUSED_STEP)
+				fused++;
+		validated += (*task)->m_validated;
+		mismatches += (*task)->m_mismatches;
+		if ((*task)->m_first_mismatch != NULL)
+			printf("Task(%d): first mismatch in NODE_%02d (%s)\n", (*task)->task_group, (*task)->m_first_mismatch->index(), (*task)->m_first_mismatch->module_name());
+	}
+	printf("Fused nodes    : %d of %d\n", fused, m_step_count);
+	printf("Fused results  : %16" I64FMT "d compared, %" I64FMT "d mismatches\n", validated, mismatches);
+}
+
+
 /*************************************
  *
  *  First pass init of nodes
@@ -832,11 +1055,15 @@ discrete_device::discrete_device(const machine_config &mconfig, device_type type
 		m_sample_time(0),
 		m_neg_sample_time(0),
 		m_indexed_node(NULL),
+		m_step_count(0),
 		m_disclogfile(NULL),
 		m_queue(NULL),
 		m_profiling(0),
+		m_fusing(false),
+		m_validating(0),
 		m_total_samples(0),
-		m_total_stream_updates(0)
+		m_total_stream_updates(0),
+		m_inline_updates(0)
 {
 }
 
@@ -883,6 +1110,14 @@ void discrete_device::device_start()
 	if (getenv("DISCRETE_PROFILING"))
 		m_profiling = atoi(getenv("DISCRETE_PROFILING"));
 
+	/* evaluate stateless math and logic nodes inline instead of through their step() */
+	m_fusing = machine().options().discrete_fused();
+
+	/* enable validation of fused nodes */
+	m_validating = 0;
+	if (getenv("DISCRETE_VALIDATE"))
+		m_validating = atoi(getenv("DISCRETE_VALIDATE"));
+
 	/* Build the final block list */
 	sound_block_list_t block_list;
 	discrete_build_list(intf_start, block_list);
@@ -905,8 +1140,9 @@ void discrete_device::device_start()
 		(*node)->resolve_input_nodes();
 	}
 
-	/* allocate a queue */
-	m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
+	/* allocate a queue if there is anything to run in parallel */
+	if (task_list.count() > 1)
+		m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
 
 	/* Process nodes which have a start func */
 	for_each(discrete_base_node **, node, &m_node_list)
@@ -923,6 +1159,23 @@ void discrete_device::device_start()
 				(*dest_task)->check((*task));
 		}
 	}
+
+	/* sources live in lower task groups, so running tasks in group order never has to wait */
+	m_inline_order.clear();
+	m_step_count = 0;
+	for_each(discrete_task **, task, &task_list)
+	{
+		int pos = m_inline_order.count();
+		m_inline_order.add(*task);
+		while (pos > 0 && m_inline_order[pos - 1]->task_group > (*task)->task_group)
+		{
+			m_inline_order[pos] = m_inline_order[pos - 1];
+			pos--;
+		}
+		m_inline_order[pos] = *task;
+		m_step_count += (*task)->step_list.count();
+		(*task)->compile();
+	}
 }
 
 void discrete_device::device_stop()
@@ -937,6 +1190,11 @@ void discrete_device::device_stop()
 		display_profiling();
 	}
 
+	if (m_validating && !m_profiling)
+	{
+		display_validation();
+	}
+
 	/* Process nodes which have a stop func */
 
 	for_each(discrete_base_node **, node, &m_node_list)
@@ -1042,17 +1300,28 @@ void discrete_device::process(int samples)
 		(*task)->prepare_for_queue(samples);
 	}
 
-	for_each(discrete_task **, task, &task_list)
+	bool run_inline = (m_queue == NULL || samples * m_step_count < MIN_STEPS_FOR_PARALLEL_UPDATE);
+	if (run_inline)
+	{
+		/* not worth waking the workers: run each task to completion, sources first */
+		for_each(discrete_task **, task, &m_inline_order)
+			while ((*task)->process())
+				;
+	}
+	else
 	{
-		/* Fire a work item for each task */
-		osd_work_item_queue(m_queue, discrete_task::task_callback, (void *) &task_list, WORK_ITEM_FLAG_AUTO_RELEASE);
+		/* every call of the callback completes one task; we take care of one ourselves */
+		osd_work_item_queue_multiple(m_queue, discrete_task::task_callback, task_list.count() - 1, (void *) &task_list, 0, WORK_ITEM_FLAG_AUTO_RELEASE);
+		discrete_task::task_callback((void *) &task_list, CALLER_THREADID);
+		osd_work_queue_wait(m_queue, osd_ticks_per_second()*10);
 	}
-	osd_work_queue_wait(m_queue, osd_ticks_per_second()*10);
 
 	if (m_profiling)
 	{
 		m_total_samples += samples;
 		m_total_stream_updates++;
+		if (run_inline)
+			m_inline_updates++;
 	}
 }
 
@@ -4313,6 +4313,12 @@ public:
 	/* are we profiling */
 	inline int profiling(void) { return m_profiling; }
 
+	/* are simple nodes evaluated inline by their task */
+	inline bool fusing(void) { return m_fusing; }
+
+	/* are we checking fused nodes against their step() */
+	inline int validating(void) { return m_validating; }
+
 	inline int sample_rate(void) { return m_sample_rate; }
 	inline double sample_time(void) { return m_sample_time; }
 
@@ -4343,6 +4349,7 @@ private:
 	void discrete_build_list(const discrete_block *intf, sound_block_list_t &block_list);
 	void discrete_sanity_check(const sound_block_list_t &block_list);
 	void display_profiling(void);
+	void display_validation(void);
 	void init_nodes(const sound_block_list_t &block_list);
 
 	/* internal node tracking */
@@ -4350,6 +4357,8 @@ private:
 
 	/* tasks */
 	task_list_t             task_list;      /* discrete_task_context * */
+	task_list_t             m_inline_order; /* tasks sorted by task group */
+	int                     m_step_count;   /* step nodes in all tasks */
 
 	/* debugging statistics */
 	FILE *                  m_disclogfile;
@@ -4359,8 +4368,11 @@ private:
 
 	/* profiling */
 	int                     m_profiling;
+	bool                    m_fusing;
+	int                     m_validating;
 	UINT64                  m_total_samples;
 	UINT64                  m_total_stream_updates;
+	UINT64                  m_inline_updates;
 };
 
 // ======================> discrete_sound_device
@@ -129,23 +129,13 @@ void speaker_device::mix(INT32 *leftmix, INT32 *rightmix, int &samples_this_upda
 	// mix if sound is enabled
 	if (!suppress)
 	{
-		// if the speaker is centered, send to both left and right
-		if (m_x == 0)
-			for (int sample = 0; sample < samples_this_update; sample++)
-			{
-				leftmix[sample] += stream_buf[sample];
-				rightmix[sample] += stream_buf[sample];
-			}
-
-		// if the speaker is to the left, send only to the left
-		else if (m_x < 0)
-			for (int sample = 0; sample < samples_this_update; sample++)
-				leftmix[sample] += stream_buf[sample];
-
-		// if the speaker is to the right, send only to the right
-		else
-			for (int sample = 0; sample < samples_this_update; sample++)
-				rightmix[sample] += stream_buf[sample];
+		// if the speaker is centered or to the left, send to the left
+		if (m_x <= 0)
+			stream_add_samples(leftmix, stream_buf, samples_this_update);
+
+		// if the speaker is centered or to the right, send to the right
+		if (m_x >= 0)
+			stream_add_samples(rightmix, stream_buf, samples_this_update);
 	}
 }
 
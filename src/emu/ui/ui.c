@@ -933,7 +933,10 @@ bool ui_manager::show_fps_counter()
 void ui_manager::set_show_profiler(bool show)
 {
 	m_show_profiler = show;
-	g_profiler.enable(show);
+
+	// keep profiling if we have been asked to write it all out at the end
+	if (show || machine().options().profiler_output()[0] == 0)
+		g_profiler.enable(show);
 }
 
 
@@ -1600,6 +1603,13 @@ UINT32 ui_manager::handler_ingame(running_machine &machine, render_container *co
 		return machine.ui().set_handler(handler_load_save, LOADSAVE_LOAD);
 	}
 
+	// handle a rewind request; this pauses so the user can keep stepping back
+	if (ui_input_pressed(machine, IPT_UI_REWIND_SINGLE) && machine.rewinder() != NULL)
+	{
+		machine.pause();
+		machine.schedule_rewind(1);
+	}
+
 	// handle a save snapshot request
 	if (ui_input_pressed(machine, IPT_UI_SNAPSHOT))
 		machine.video().save_active_screen_snapshots();
@@ -35,6 +35,8 @@ const char *AV_METADATA_FORMAT = "FPS:%d.%06d WIDTH:%d HEIGHT:%d INTERLACED:%d C
 
 static const UINT32 METADATA_HEADER_SIZE = 16;          // metadata header size
 
+static const UINT32 READAHEAD_TRIGGER = 2;                  // sequential hunk reads before reading ahead
+
 static const UINT8 V34_MAP_ENTRY_FLAG_TYPE_MASK = 0x0f;     // what type of hunk
 static const UINT8 V34_MAP_ENTRY_FLAG_NO_CRC = 0x10;        // no CRC is present
 
@@ -173,9 +175,13 @@ inline void chd_file::file_read(UINT64 offset, void *dest, UINT32 length)
 	if (m_file == NULL)
 		throw CHDERR_NOT_OPEN;
 
-	// seek and read
+	// seek and read; the read-ahead worker shares the file with us
+	if (m_file_lock != NULL)
+		osd_lock_acquire(m_file_lock);
 	core_fseek(m_file, offset, SEEK_SET);
 	UINT32 count = core_fread(m_file, dest, length);
+	if (m_file_lock != NULL)
+		osd_lock_release(m_file_lock);
 	if (count != length)
 		throw CHDERR_READ_ERROR;
 }
@@ -269,10 +275,16 @@ inline UINT8 chd_file::bits_for_value(UINT64 value)
 
 chd_file::chd_file()
 	: m_file(NULL),
-		m_owns_file(false)
+		m_owns_file(false),
+		m_lru_hunks(0),
+		m_lru_lock(NULL),
+		m_file_lock(NULL),
+		m_readahead_queue(NULL)
 {
 	// reset state
 	memset(m_decompressor, 0, sizeof(m_decompressor));
+	memset(m_readahead_decompressor, 0, sizeof(m_readahead_decompressor));
+	memset(&m_cache_stats, 0, sizeof(m_cache_stats));
 	close();
 }
 
@@ -672,6 +684,9 @@ chd_error chd_file::open(core_file &file, bool writeable, chd_file *parent)
 
 void chd_file::close()
 {
+	// stop reading ahead before the file goes away
+	cache_free();
+
 	// reset file characteristics
 	if (m_owns_file && m_file != NULL)
 		core_fclose(m_file);
@@ -723,6 +738,24 @@ void chd_file::close()
 //-------------------------------------------------
 
 chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
+{
+	// go through the hunk cache if we have one; lossy codecs that decode
+	// elsewhere pass a NULL buffer, but they never have a cache
+	if (m_lru_hunks != 0 && buffer != NULL)
+		return read_hunk_cached(hunknum, reinterpret_cast<UINT8 *>(buffer));
+	return decode_hunk(hunknum, reinterpret_cast<UINT8 *>(buffer), m_decompressor, m_compressed, false);
+}
+
+
+//-------------------------------------------------
+//  decode_hunk - read and decompress a single
+//  hunk using the given codecs and buffer for
+//  compressed data; the read-ahead worker passes
+//  its own, and can't follow hunks into the
+//  parent
+//-------------------------------------------------
+
+chd_error chd_file::decode_hunk(UINT32 hunknum, UINT8 *dest, chd_decompressor * const *decompressor, UINT8 *compbuf, bool readahead)
 {
 	// wrap this for clean reporting
 	try
@@ -740,7 +773,6 @@ chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 		UINT32 blocklen;
 		UINT32 blockcrc;
 		UINT8 *rawmap;
-		UINT8 *dest = reinterpret_cast<UINT8 *>(buffer);
 		switch (m_version)
 		{
 			// v3/v4 map entries
@@ -753,8 +785,8 @@ chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 				{
 					case V34_MAP_ENTRY_TYPE_COMPRESSED:
 						blocklen = be_read(&rawmap[12], 2) + (rawmap[14] << 16);
-						file_read(blockoffs, m_compressed, blocklen);
-						m_decompressor[0]->decompress(m_compressed, blocklen, dest, m_hunkbytes);
+						file_read(blockoffs, compbuf, blocklen);
+						decompressor[0]->decompress(compbuf, blocklen, dest, m_hunkbytes);
 						if (!(rawmap[15] & V34_MAP_ENTRY_FLAG_NO_CRC) && dest != NULL && crc32_creator::simple(dest, m_hunkbytes) != blockcrc)
 							throw CHDERR_DECOMPRESSION_ERROR;
 						return CHDERR_NONE;
@@ -774,10 +806,12 @@ chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 						return CHDERR_NONE;
 
 					case V34_MAP_ENTRY_TYPE_SELF_HUNK:
+						if (readahead)
+							return decode_hunk(blockoffs, dest, decompressor, compbuf, true);
 						return read_hunk(blockoffs, dest);
 
 					case V34_MAP_ENTRY_TYPE_PARENT_HUNK:
-						if (m_parent_missing)
+						if (m_parent_missing || readahead)
 							throw CHDERR_REQUIRES_PARENT;
 						return m_parent->read_hunk(blockoffs, dest);
 				}
@@ -793,7 +827,7 @@ chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 					blockoffs = UINT64(be_read(rawmap, 4)) * UINT64(m_hunkbytes);
 					if (blockoffs != 0)
 						file_read(blockoffs, dest, m_hunkbytes);
-					else if (m_parent_missing)
+					else if (m_parent_missing || (readahead && m_parent != NULL))
 						throw CHDERR_REQUIRES_PARENT;
 					else if (m_parent != NULL)
 						m_parent->read_hunk(hunknum, dest);
@@ -812,11 +846,11 @@ chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 					case COMPRESSION_TYPE_1:
 					case COMPRESSION_TYPE_2:
 					case COMPRESSION_TYPE_3:
-						file_read(blockoffs, m_compressed, blocklen);
-						m_decompressor[rawmap[0]]->decompress(m_compressed, blocklen, dest, m_hunkbytes);
-						if (!m_decompressor[rawmap[0]]->lossy() && dest != NULL && crc16_creator::simple(dest, m_hunkbytes) != blockcrc)
+						file_read(blockoffs, compbuf, blocklen);
+						decompressor[rawmap[0]]->decompress(compbuf, blocklen, dest, m_hunkbytes);
+						if (!decompressor[rawmap[0]]->lossy() && dest != NULL && crc16_creator::simple(dest, m_hunkbytes) != blockcrc)
 							throw CHDERR_DECOMPRESSION_ERROR;
-						if (m_decompressor[rawmap[0]]->lossy() && crc16_creator::simple(m_compressed, blocklen) != blockcrc)
+						if (decompressor[rawmap[0]]->lossy() && crc16_creator::simple(compbuf, blocklen) != blockcrc)
 							throw CHDERR_DECOMPRESSION_ERROR;
 						return CHDERR_NONE;
 
@@ -827,10 +861,12 @@ chd_error chd_file::read_hunk(UINT32 hunknum, void *buffer)
 						return CHDERR_NONE;
 
 					case COMPRESSION_SELF:
+						if (readahead)
+							return decode_hunk(blockoffs, dest, decompressor, compbuf, true);
 						return read_hunk(blockoffs, dest);
 
 					case COMPRESSION_PARENT:
-						if (m_parent_missing)
+						if (m_parent_missing || readahead)
 							throw CHDERR_REQUIRES_PARENT;
 						return m_parent->read_bytes(UINT64(blockoffs) * UINT64(m_parent->unit_bytes()), dest, m_hunkbytes);
 				}
@@ -1348,6 +1384,116 @@ chd_error chd_file::codec_configure(chd_codec_type codec, int param, void *confi
 }
 
 
+//-------------------------------------------------
+//  cache_configure - set up an LRU cache of
+//  decompressed hunks, and a worker that reads
+//  up to readahead hunks ahead once reads become
+//  sequential; 0 hunks turns the cache off
+//-------------------------------------------------
+
+chd_error chd_file::cache_configure(UINT32 hunks, UINT32 readahead)
+{
+	// throw away what we have
+	cache_free();
+	if (hunks == 0)
+		return CHDERR_NONE;
+
+	// punt if no file
+	if (m_file == NULL)
+		return CHDERR_NOT_OPEN;
+
+	// writes don't go through the cache, so it's only for read-only files
+	if (m_allow_writes)
+		return CHDERR_NOT_SUPPORTED;
+
+	// lossy codecs and A/V codecs decode straight to their own output, so there's nothing to cache
+	for (int decompnum = 0; decompnum < ARRAY_LENGTH(m_decompressor); decompnum++)
+		if ((m_decompressor[decompnum] != NULL && m_decompressor[decompnum]->lossy()) || m_compression[decompnum] == CHD_CODEC_AVHUFF)
+			return CHDERR_NOT_SUPPORTED;
+
+	// A/V files are read a frame at a time into their own buffers, however they are stored
+	astring metadata;
+	if (read_metadata(AV_METADATA_TAG, 0, metadata) == CHDERR_NONE)
+		return CHDERR_NOT_SUPPORTED;
+
+	// wrap this for clean reporting
+	try
+	{
+		// allocate the slots, all empty
+		hunks = MIN(hunks, m_hunkcount);
+		m_lru_data.resize(hunks * m_hunkbytes);
+		m_lru_slot.resize(hunks);
+		for (UINT32 slotnum = 0; slotnum < hunks; slotnum++)
+		{
+			cache_slot &slot = m_lru_slot[slotnum];
+			slot.m_chd = this;
+			slot.m_hunknum = ~0;
+			slot.m_reading = false;
+			slot.m_prefetched = false;
+			slot.m_lastuse = 0;
+			slot.m_item = NULL;
+		}
+		m_lru_map.resize_and_clear(m_hunkcount, 0xff);
+		m_lru_clock = 0;
+		m_lru_lock = osd_lock_alloc();
+		memset(&m_cache_stats, 0, sizeof(m_cache_stats));
+
+		// leave at least half the cache for hunks that have already been read
+		m_readahead = MIN(readahead, hunks / 2);
+		m_last_hunk = ~0;
+		m_sequential = 0;
+		m_readahead_next = 0;
+		if (m_readahead != 0)
+		{
+			// the worker gets its own codecs, and shares the file with us
+			for (int decompnum = 0; decompnum < ARRAY_LENGTH(m_compression); decompnum++)
+			{
+				m_readahead_decompressor[decompnum] = chd_codec_list::new_decompressor(m_compression[decompnum], *this);
+				if (m_readahead_decompressor[decompnum] == NULL && m_compression[decompnum] != 0)
+					throw CHDERR_UNKNOWN_COMPRESSION;
+			}
+			m_readahead_compressed.resize(m_hunkbytes);
+			m_file_lock = osd_lock_alloc();
+			m_readahead_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+			if (m_readahead_queue == NULL)
+				m_readahead = 0;
+		}
+
+		// turn it on now that everything is ready
+		m_lru_hunks = hunks;
+		return CHDERR_NONE;
+	}
+
+	// clean up after any errors
+	catch (chd_error &err)
+	{
+		cache_free();
+		return err;
+	}
+	catch (std::bad_alloc &)
+	{
+		cache_free();
+		return CHDERR_OUT_OF_MEMORY;
+	}
+}
+
+
+//-------------------------------------------------
+//  cache_stats - return statistics for the hunk
+//  cache since it was configured
+//-------------------------------------------------
+
+chd_cache_stats chd_file::cache_stats()
+{
+	if (m_lru_lock != NULL)
+		osd_lock_acquire(m_lru_lock);
+	chd_cache_stats result = m_cache_stats;
+	if (m_lru_lock != NULL)
+		osd_lock_release(m_lru_lock);
+	return result;
+}
+
+
 //-------------------------------------------------
 //  error_string - return an error string for
 //  the given CHD error
@@ -2191,6 +2337,239 @@ void chd_file::hunk_copy_from_parent(UINT32 hunknum, UINT64 parentunit)
 }
 
 
+//-------------------------------------------------
+//  read_hunk_cached - read a hunk through the
+//  cache, decompressing it here if it is neither
+//  there nor on its way
+//-------------------------------------------------
+
+chd_error chd_file::read_hunk_cached(UINT32 hunknum, UINT8 *dest)
+{
+	// return an error if out of range
+	if (hunknum >= m_hunkcount)
+		return CHDERR_HUNK_OUT_OF_RANGE;
+
+	// if the worker is reading this one, wait for it
+	osd_lock_acquire(m_lru_lock);
+	INT32 slotnum = m_lru_map[hunknum];
+	if (slotnum != -1 && m_lru_slot[slotnum].m_reading)
+	{
+		osd_work_item *item = m_lru_slot[slotnum].m_item;
+		m_cache_stats.m_readahead_waits++;
+		osd_lock_release(m_lru_lock);
+		while (!osd_work_item_wait(item, osd_ticks_per_second()))
+			;
+		osd_lock_acquire(m_lru_lock);
+
+		// if it failed, the slot will have been emptied
+		slotnum = m_lru_map[hunknum];
+	}
+
+	// if we have it, copy it out
+	if (slotnum != -1)
+	{
+		cache_slot &slot = m_lru_slot[slotnum];
+		if (slot.m_prefetched)
+			m_cache_stats.m_readahead_hits++;
+		else
+			m_cache_stats.m_hits++;
+		slot.m_prefetched = false;
+		slot.m_lastuse = ++m_lru_clock;
+		memcpy(dest, &m_lru_data[slotnum * m_hunkbytes], m_hunkbytes);
+		cache_note_access(hunknum);
+		osd_lock_release(m_lru_lock);
+		return CHDERR_NONE;
+	}
+
+	// otherwise, start the worker on what comes next while we decompress this one
+	m_cache_stats.m_misses++;
+	cache_note_access(hunknum);
+	osd_lock_release(m_lru_lock);
+	chd_error err = decode_hunk(hunknum, dest, m_decompressor, m_compressed, false);
+	if (err != CHDERR_NONE)
+		return err;
+
+	// and keep a copy, unless the worker has picked it up in the meantime
+	osd_lock_acquire(m_lru_lock);
+	if (m_lru_map[hunknum] == -1)
+	{
+		slotnum = cache_claim_slot(hunknum);
+		if (slotnum != -1)
+			memcpy(&m_lru_data[slotnum * m_hunkbytes], dest, m_hunkbytes);
+	}
+	osd_lock_release(m_lru_lock);
+	return CHDERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  cache_claim_slot - evict the least recently
+//  used hunk that isn't being read ahead and
+//  give its slot to a new one; the caller holds
+//  the cache lock
+//-------------------------------------------------
+
+INT32 chd_file::cache_claim_slot(UINT32 hunknum)
+{
+	// find the oldest slot the worker isn't using; empty ones are oldest of all
+	INT32 slotnum = -1;
+	for (INT32 scan = 0; scan < m_lru_slot.count(); scan++)
+		if (!m_lru_slot[scan].m_reading && (slotnum == -1 || m_lru_slot[scan].m_lastuse < m_lru_slot[slotnum].m_lastuse))
+			slotnum = scan;
+	if (slotnum == -1)
+		return -1;
+
+	// evict whatever was there
+	cache_slot &slot = m_lru_slot[slotnum];
+	if (slot.m_hunknum != ~0)
+		m_lru_map[slot.m_hunknum] = -1;
+	if (slot.m_prefetched)
+		m_cache_stats.m_readahead_unused++;
+	if (slot.m_item != NULL)
+		osd_work_item_release(slot.m_item);
+
+	// and move in
+	slot.m_hunknum = hunknum;
+	slot.m_prefetched = false;
+	slot.m_lastuse = ++m_lru_clock;
+	slot.m_item = NULL;
+	m_lru_map[hunknum] = slotnum;
+	return slotnum;
+}
+
+
+//-------------------------------------------------
+//  cache_note_access - track sequential reads,
+//  keeping the worker up to m_readahead hunks
+//  ahead of them; the caller holds the cache
+//  lock
+//-------------------------------------------------
+
+void chd_file::cache_note_access(UINT32 hunknum)
+{
+	// reading the same hunk again doesn't break a run
+	if (hunknum == m_last_hunk + 1)
+		m_sequential++;
+	else if (hunknum != m_last_hunk)
+	{
+		m_sequential = 0;
+		m_readahead_next = hunknum + 1;
+	}
+	m_last_hunk = hunknum;
+
+	// wait for a pattern to show up
+	if (m_readahead == 0 || m_sequential < READAHEAD_TRIGGER)
+		return;
+
+	// queue anything coming up that we don't have
+	if (m_readahead_next <= hunknum)
+		m_readahead_next = hunknum + 1;
+	for ( ; m_readahead_next < m_hunkcount && m_readahead_next <= hunknum + m_readahead; m_readahead_next++)
+		if (m_lru_map[m_readahead_next] == -1)
+		{
+			INT32 slotnum = cache_claim_slot(m_readahead_next);
+			if (slotnum == -1)
+				break;
+
+			cache_slot &slot = m_lru_slot[slotnum];
+			slot.m_reading = true;
+			slot.m_prefetched = true;
+			slot.m_item = osd_work_item_queue(m_readahead_queue, readahead_static, &slot, 0);
+			if (slot.m_item == NULL)
+			{
+				// give the slot back if we couldn't queue it
+				m_lru_map[slot.m_hunknum] = -1;
+				slot.m_hunknum = ~0;
+				slot.m_reading = false;
+				slot.m_prefetched = false;
+				slot.m_lastuse = 0;
+				break;
+			}
+			m_cache_stats.m_readahead++;
+		}
+}
+
+
+//-------------------------------------------------
+//  cache_free - stop the read-ahead worker and
+//  free the hunk cache
+//-------------------------------------------------
+
+void chd_file::cache_free()
+{
+	// turn it off first
+	m_lru_hunks = 0;
+	m_readahead = 0;
+
+	// let the worker finish before freeing anything it uses
+	if (m_readahead_queue != NULL)
+	{
+		while (!osd_work_queue_wait(m_readahead_queue, osd_ticks_per_second()))
+			;
+		for (int slotnum = 0; slotnum < m_lru_slot.count(); slotnum++)
+			if (m_lru_slot[slotnum].m_item != NULL)
+				osd_work_item_release(m_lru_slot[slotnum].m_item);
+		osd_work_queue_free(m_readahead_queue);
+		m_readahead_queue = NULL;
+	}
+	for (int decompnum = 0; decompnum < ARRAY_LENGTH(m_readahead_decompressor); decompnum++)
+	{
+		delete m_readahead_decompressor[decompnum];
+		m_readahead_decompressor[decompnum] = NULL;
+	}
+	m_readahead_compressed.reset();
+
+	// then the cache itself
+	m_lru_data.reset();
+	m_lru_slot.reset();
+	m_lru_map.reset();
+	if (m_lru_lock != NULL)
+		osd_lock_free(m_lru_lock);
+	m_lru_lock = NULL;
+	if (m_file_lock != NULL)
+		osd_lock_free(m_file_lock);
+	m_file_lock = NULL;
+}
+
+
+//-------------------------------------------------
+//  readahead_static - read a hunk ahead on the
+//  worker thread
+//-------------------------------------------------
+
+void *chd_file::readahead_static(void *param, int threadid)
+{
+	cache_slot &slot = *reinterpret_cast<cache_slot *>(param);
+	slot.m_chd->readahead(slot);
+	return NULL;
+}
+
+
+//-------------------------------------------------
+//  readahead - decompress a hunk straight into
+//  its slot, which nothing else touches while it
+//  is being read
+//-------------------------------------------------
+
+void chd_file::readahead(cache_slot &slot)
+{
+	UINT32 slotnum = &slot - &m_lru_slot[0];
+	chd_error err = decode_hunk(slot.m_hunknum, &m_lru_data[slotnum * m_hunkbytes], m_readahead_decompressor, m_readahead_compressed, true);
+
+	// leave anything we couldn't read for the caller to read and report
+	osd_lock_acquire(m_lru_lock);
+	if (err != CHDERR_NONE)
+	{
+		m_lru_map[slot.m_hunknum] = -1;
+		slot.m_hunknum = ~0;
+		slot.m_prefetched = false;
+		slot.m_lastuse = 0;
+	}
+	slot.m_reading = false;
+	osd_lock_release(m_lru_lock);
+}
+
+
 //-------------------------------------------------
 //  metadata_find - find a metadata entry
 //-------------------------------------------------
@@ -282,6 +282,20 @@ enum chd_error
 class chd_codec;
 
 
+// ======================> chd_cache_stats
+
+// statistics from the decompressed hunk cache
+struct chd_cache_stats
+{
+	UINT64                  m_hits;             // reads satisfied from the cache
+	UINT64                  m_readahead_hits;   // reads satisfied by a hunk that was read ahead
+	UINT64                  m_readahead_waits;  // reads that had to wait for one being read ahead
+	UINT64                  m_misses;           // reads decompressed on demand
+	UINT64                  m_readahead;        // hunks queued for read-ahead
+	UINT64                  m_readahead_unused; // hunks read ahead but evicted before being used
+};
+
+
 // ======================> chd_file
 
 // core file class
@@ -363,6 +377,10 @@ public:
 	// codec interfaces
 	chd_error codec_configure(chd_codec_type codec, int param, void *config);
 
+	// hunk cache
+	chd_error cache_configure(UINT32 hunks, UINT32 readahead);
+	chd_cache_stats cache_stats();
+
 	// static helpers
 	static const char *error_string(chd_error err);
 
@@ -370,6 +388,17 @@ private:
 	struct metadata_entry;
 	struct metadata_hash;
 
+	// a slot in the hunk cache
+	struct cache_slot
+	{
+		chd_file *          m_chd;              // owning file, for the read-ahead worker
+		UINT32              m_hunknum;          // hunk held here, or ~0 if empty
+		bool                m_reading;          // being filled by the read-ahead worker?
+		bool                m_prefetched;       // read ahead and not yet used?
+		UINT64              m_lastuse;          // LRU timestamp
+		osd_work_item *     m_item;             // read-ahead work item, if any
+	};
+
 	// inline helpers
 	UINT64 be_read(const UINT8 *base, int numbytes);
 	void be_write(UINT8 *base, UINT64 value, int numbytes);
@@ -394,6 +423,13 @@ private:
 	void hunk_write_compressed(UINT32 hunknum, INT8 compression, const UINT8 *compressed, UINT32 complength, crc16_t crc16);
 	void hunk_copy_from_self(UINT32 hunknum, UINT32 otherhunk);
 	void hunk_copy_from_parent(UINT32 hunknum, UINT64 parentunit);
+	chd_error decode_hunk(UINT32 hunknum, UINT8 *dest, chd_decompressor * const *decompressor, UINT8 *compbuf, bool readahead);
+	chd_error read_hunk_cached(UINT32 hunknum, UINT8 *dest);
+	INT32 cache_claim_slot(UINT32 hunknum);
+	void cache_note_access(UINT32 hunknum);
+	void cache_free();
+	static void *readahead_static(void *param, int threadid);
+	void readahead(cache_slot &slot);
 	bool metadata_find(chd_metadata_tag metatag, INT32 metaindex, metadata_entry &metaentry, bool resume = false);
 	void metadata_set_previous_next(UINT64 prevoffset, UINT64 nextoffset);
 	void metadata_update_hash();
@@ -436,6 +472,25 @@ private:
 	// caching
 	dynamic_buffer          m_cache;            // single-hunk cache for partial reads/writes
 	UINT32                  m_cachehunk;        // which hunk is in the cache?
+
+	// decompressed hunk cache
+	UINT32                  m_lru_hunks;        // number of hunks in the cache, or 0 if disabled
+	dynamic_buffer          m_lru_data;         // decompressed data for each slot
+	dynamic_array<cache_slot> m_lru_slot;       // state of each slot
+	dynamic_array<INT32>    m_lru_map;          // slot holding each hunk, or -1
+	UINT64                  m_lru_clock;        // LRU timestamp of the latest use
+	osd_lock *              m_lru_lock;         // guards the cache against the read-ahead worker
+	osd_lock *              m_file_lock;        // serializes file access with the read-ahead worker
+	chd_cache_stats         m_cache_stats;      // statistics
+
+	// read-ahead
+	UINT32                  m_readahead;        // maximum hunks to read ahead of the caller
+	osd_work_queue *        m_readahead_queue;  // queue for the read-ahead worker
+	chd_decompressor *      m_readahead_decompressor[4]; // the worker's own codecs
+	dynamic_buffer          m_readahead_compressed; // and buffer for compressed data
+	UINT32                  m_last_hunk;        // last hunk the caller read
+	UINT32                  m_sequential;       // number of sequential reads leading up to it
+	UINT32                  m_readahead_next;   // next hunk to queue for read-ahead
 };
 
 
@@ -175,6 +175,10 @@ static _7z_file *_7z_cache[_7Z_CACHE_SIZE];
 /* cache management */
 static void free__7z_file(_7z_file *_7z);
 
+/* decompression */
+static _7z_error extract_file(_7z_file *new_7z, int index, void *buffer, UINT32 length);
+static int CLIB_DECL compare_block_order(const void *item1, const void *item2);
+
 
 /***************************************************************************
     _7Z FILE ACCESS
@@ -426,10 +430,71 @@ void _7z_file_cache_clear(void)
 -------------------------------------------------*/
 
 _7z_error _7z_file_decompress(_7z_file *new_7z, void *buffer, UINT32 length)
+{
+	return extract_file(new_7z, new_7z->curr_file_idx, buffer, length);
+}
+
+
+/*-------------------------------------------------
+    _7z_file_decompress_multiple - decompress
+    several files from a _7Z, grouped by solid
+    block so that each block is decoded once no
+    matter what order they are asked for in
+-------------------------------------------------*/
+
+_7z_error _7z_file_decompress_multiple(_7z_file *new_7z, _7z_file_request *requests, int count)
+{
+	UINT64 *order;
+	int reqnum;
+
+	if (count == 0)
+		return _7ZERR_NONE;
+
+	/* sort by block, then by position in the request list */
+	order = (UINT64 *)malloc(count * sizeof(*order));
+	if (order == NULL)
+		return _7ZERR_OUT_OF_MEMORY;
+	for (reqnum = 0; reqnum < count; reqnum++)
+	{
+		int index = requests[reqnum].index;
+		UINT32 block = (index >= 0 && index < new_7z->db.db.NumFiles) ? new_7z->db.FileIndexToFolderIndexMap[index] : 0xffffffff;
+		order[reqnum] = ((UINT64)block << 32) | reqnum;
+	}
+	qsort(order, count, sizeof(order[0]), compare_block_order);
+
+	/* extract in that order */
+	for (reqnum = 0; reqnum < count; reqnum++)
+	{
+		_7z_file_request &request = requests[(UINT32)order[reqnum]];
+		request.error = extract_file(new_7z, request.index, request.buffer, request.length);
+	}
+	free(order);
+
+	/* return the first error */
+	for (reqnum = 0; reqnum < count; reqnum++)
+		if (requests[reqnum].error != _7ZERR_NONE)
+			return requests[reqnum].error;
+	return _7ZERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    extract_file - decompress a file from a _7Z
+    into the target buffer, reusing the last
+    solid block decoded if the file is in it
+-------------------------------------------------*/
+
+static _7z_error extract_file(_7z_file *new_7z, int index, void *buffer, UINT32 length)
 {
 	file_error err;
 	SRes res;
-	int index = new_7z->curr_file_idx;
+
+	if (index < 0 || index >= new_7z->db.db.NumFiles)
+		return _7ZERR_FILE_ERROR;
+
+	/* empty files aren't in any block; don't let them throw away the one we have */
+	if (new_7z->db.FileIndexToFolderIndexMap[index] == 0xffffffff)
+		return _7ZERR_NONE;
 
 	/* make sure the file is open.. */
 	if (new_7z->archiveStream.file._7z_osdfile==NULL)
@@ -457,6 +522,19 @@ _7z_error _7z_file_decompress(_7z_file *new_7z, void *buffer, UINT32 length)
 }
 
 
+/*-------------------------------------------------
+    compare_block_order - compare two entries in
+    the extraction order for qsort
+-------------------------------------------------*/
+
+static int CLIB_DECL compare_block_order(const void *item1, const void *item2)
+{
+	UINT64 order1 = *(const UINT64 *)item1;
+	UINT64 order2 = *(const UINT64 *)item2;
+	return (order1 < order2) ? -1 : (order1 > order2) ? 1 : 0;
+}
+
+
 
 /***************************************************************************
     CACHE MANAGEMENT
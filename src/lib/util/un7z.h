@@ -113,6 +113,16 @@ struct  _7z_file
 };
 
 
+/* describes one file to decompress with _7z_file_decompress_multiple */
+struct _7z_file_request
+{
+	int             index;                  /* file index, from _7z_search_crc_match */
+	void *          buffer;                 /* buffer to decompress into */
+	UINT32          length;                 /* length of the buffer */
+	_7z_error       error;                  /* result for this file */
+};
+
+
 
 /***************************************************************************
     FUNCTION PROTOTYPES
@@ -139,5 +149,8 @@ int _7z_search_crc_match(_7z_file *new_7z, UINT32 crc, const char *search_filena
 /* decompress the most recently found file in the _7Z */
 _7z_error _7z_file_decompress(_7z_file *_7z, void *buffer, UINT32 length);
 
+/* decompress several files from the _7Z, decoding each solid block only once; returns the first error */
+_7z_error _7z_file_decompress_multiple(_7z_file *_7z, _7z_file_request *requests, int count);
+
 
 #endif  /* __UN_7Z_H__ */
@@ -73,6 +73,37 @@
 
 
 
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* the central directory of a ZIP file, parsed once and shared by every
+   handle open on it, whether in use or sitting in the cache */
+struct zip_directory
+{
+	zip_directory * next;                   /* next directory in the list */
+	char *          filename;               /* ZIP filename */
+	UINT64          length;                 /* length of the ZIP file it was read from */
+	int             refcount;               /* number of handles using it */
+
+	zip_ecd         ecd;                    /* end of central directory */
+	UINT8 *         cd;                     /* central directory raw data */
+
+	zip_file_header *entries;               /* parsed entries, in directory order */
+	UINT32          entry_count;            /* number of entries */
+	char *          names;                  /* NULL-terminated copies of the entry filenames */
+};
+
+
+/* one member being decompressed by zip_file_decompress_multiple */
+struct decompress_work
+{
+	zip_file *      zip;                    /* ZIP it comes from */
+	zip_file_request *request;              /* what to decompress and where */
+};
+
+
+
 /***************************************************************************
     INLINE FUNCTIONS
 ***************************************************************************/
@@ -95,6 +126,12 @@ INLINE UINT32 read_dword(UINT8 *buf)
 
 static zip_file *zip_cache[ZIP_CACHE_SIZE];
 
+/* directories of every ZIP with a handle open or cached, newest first */
+static zip_directory *zip_directories;
+
+/* files may be decompressed and closed on worker threads, so guard the cache */
+static osd_lock *zip_cache_lock;
+
 
 
 /***************************************************************************
@@ -102,15 +139,23 @@ static zip_file *zip_cache[ZIP_CACHE_SIZE];
 ***************************************************************************/
 
 /* cache management */
+static void acquire_cache_lock(void);
 static void free_zip_file(zip_file *zip);
+static void release_directory(zip_directory *dir);
+static void free_directory(zip_directory *dir);
 
 /* ZIP file parsing */
-static zip_error read_ecd(zip_file *zip);
-static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset);
+static zip_error read_directory(const char *filename, osd_file *file, UINT64 length, zip_directory **dir);
+static zip_error read_ecd(zip_directory *dir, osd_file *file);
+static zip_error parse_directory(zip_directory *dir);
+static zip_error open_file_handle(zip_file *zip);
+static zip_error get_compressed_data_offset(osd_file *file, const zip_file_header *header, UINT64 *offset);
 
 /* decompression interfaces */
-static zip_error decompress_data_type_0(zip_file *zip, UINT64 offset, void *buffer, UINT32 length);
-static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buffer, UINT32 length);
+static zip_error decompress_file(zip_file *zip, osd_file *file, const zip_file_header *header, void *buffer, UINT32 length, UINT8 *inbuf);
+static void *decompress_callback(void *param, int threadid);
+static zip_error decompress_data_type_0(osd_file *file, const zip_file_header *header, UINT64 offset, void *buffer);
+static zip_error decompress_data_type_8(osd_file *file, const zip_file_header *header, UINT64 offset, void *buffer, UINT32 length, UINT8 *inbuf);
 
 
 
@@ -126,15 +171,15 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 {
 	zip_error ziperr = ZIPERR_NONE;
 	file_error filerr;
-	UINT32 read_length;
+	zip_directory *dir;
 	zip_file *newzip;
-	char *string;
 	int cachenum;
 
 	/* ensure we start with a NULL result */
 	*zip = NULL;
 
 	/* see if we are in the cache, and reopen if so */
+	acquire_cache_lock();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
 	{
 		zip_file *cached = zip_cache[cachenum];
@@ -144,9 +189,11 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 		{
 			*zip = cached;
 			zip_cache[cachenum] = NULL;
+			osd_lock_release(zip_cache_lock);
 			return ZIPERR_NONE;
 		}
 	}
+	osd_lock_release(zip_cache_lock);
 
 	/* allocate memory for the zip_file structure */
 	newzip = (zip_file *)malloc(sizeof(*newzip));
@@ -162,43 +209,31 @@ zip_error zip_file_open(const char *filename, zip_file **zip)
 		goto error;
 	}
 
-	/* read ecd data */
-	ziperr = read_ecd(newzip);
-	if (ziperr != ZIPERR_NONE)
-		goto error;
-
-	/* verify that we can work with this zipfile (no disk spanning allowed) */
-	if (newzip->ecd.disk_number != newzip->ecd.cd_start_disk_number || newzip->ecd.cd_disk_entries != newzip->ecd.cd_total_entries)
-	{
-		ziperr = ZIPERR_UNSUPPORTED;
-		goto error;
-	}
-
-	/* allocate memory for the central directory */
-	newzip->cd = (UINT8 *)malloc(newzip->ecd.cd_size + 1);
-	if (newzip->cd == NULL)
-	{
-		ziperr = ZIPERR_OUT_OF_MEMORY;
-		goto error;
-	}
+	/* if another handle is open on the same file, share its directory, as long as the file hasn't changed size */
+	acquire_cache_lock();
+	for (dir = zip_directories; dir != NULL; dir = dir->next)
+		if (dir->length == newzip->length && strcmp(filename, dir->filename) == 0)
+		{
+			dir->refcount++;
+			break;
+		}
+	osd_lock_release(zip_cache_lock);
 
-	/* read the central directory */
-	filerr = osd_read(newzip->file, newzip->cd, newzip->ecd.cd_start_disk_offset, newzip->ecd.cd_size, &read_length);
-	if (filerr != FILERR_NONE || read_length != newzip->ecd.cd_size)
+	/* otherwise, read it in and add it to the list */
+	if (dir == NULL)
 	{
-		ziperr = (filerr == FILERR_NONE) ? ZIPERR_FILE_TRUNCATED : ZIPERR_FILE_ERROR;
-		goto error;
+		ziperr = read_directory(filename, newzip->file, newzip->length, &dir);
+		if (ziperr != ZIPERR_NONE)
+			goto error;
+
+		acquire_cache_lock();
+		dir->next = zip_directories;
+		zip_directories = dir;
+		osd_lock_release(zip_cache_lock);
 	}
 
-	/* make a copy of the filename for caching purposes */
-	string = (char *)malloc(strlen(filename) + 1);
-	if (string == NULL)
-	{
-		ziperr = ZIPERR_OUT_OF_MEMORY;
-		goto error;
-	}
-	strcpy(string, filename);
-	newzip->filename = string;
+	newzip->directory = dir;
+	newzip->filename = dir->filename;
 	*zip = newzip;
 	return ZIPERR_NONE;
 
@@ -223,6 +258,7 @@ void zip_file_close(zip_file *zip)
 	zip->file = NULL;
 
 	/* find the first NULL entry in the cache */
+	acquire_cache_lock();
 	for (cachenum = 0; cachenum < ARRAY_LENGTH(zip_cache); cachenum++)
 		if (zip_cache[cachenum] == NULL)
 			break;
@@ -235,6 +271,7 @@ void zip_file_close(zip_file *zip)
 	if (cachenum != 0)
 		memmove(&zip_cache[1], &zip_cache[0], cachenum * sizeof(zip_cache[0]));
 	zip_cache[0] = zip;
+	osd_lock_release(zip_cache_lock);
 }
 
 
@@ -254,6 +291,11 @@ void zip_file_cache_clear(void)
 			free_zip_file(zip_cache[cachenum]);
 			zip_cache[cachenum] = NULL;
 		}
+
+	/* and the lock that guards it */
+	if (zip_cache_lock != NULL)
+		osd_lock_free(zip_cache_lock);
+	zip_cache_lock = NULL;
 }
 
 
@@ -270,7 +312,7 @@ void zip_file_cache_clear(void)
 const zip_file_header *zip_file_first_file(zip_file *zip)
 {
 	/* reset the position and go from there */
-	zip->cd_pos = 0;
+	zip->entry = 0;
 	return zip_file_next_file(zip);
 }
 
@@ -282,53 +324,13 @@ const zip_file_header *zip_file_first_file(zip_file *zip)
 
 const zip_file_header *zip_file_next_file(zip_file *zip)
 {
-	/* fix up any modified data */
-	if (zip->header.raw != NULL)
-	{
-		zip->header.raw[ZIPCFN + zip->header.filename_length] = zip->header.saved;
-		zip->header.raw = NULL;
-	}
-
 	/* if we're at or past the end, we're done */
-	if (zip->cd_pos >= zip->ecd.cd_size)
-		return NULL;
-
-	/* extract file header info */
-	zip->header.raw                 = zip->cd + zip->cd_pos;
-	zip->header.rawlength           = ZIPCFN;
-	zip->header.signature           = read_dword(zip->header.raw + ZIPCENSIG);
-	zip->header.version_created     = read_word (zip->header.raw + ZIPCVER);
-	zip->header.version_needed      = read_word (zip->header.raw + ZIPCVXT);
-	zip->header.bit_flag            = read_word (zip->header.raw + ZIPCFLG);
-	zip->header.compression         = read_word (zip->header.raw + ZIPCMTHD);
-	zip->header.file_time           = read_word (zip->header.raw + ZIPCTIM);
-	zip->header.file_date           = read_word (zip->header.raw + ZIPCDAT);
-	zip->header.crc                 = read_dword(zip->header.raw + ZIPCCRC);
-	zip->header.compressed_length   = read_dword(zip->header.raw + ZIPCSIZ);
-	zip->header.uncompressed_length = read_dword(zip->header.raw + ZIPCUNC);
-	zip->header.filename_length     = read_word (zip->header.raw + ZIPCFNL);
-	zip->header.extra_field_length  = read_word (zip->header.raw + ZIPCXTL);
-	zip->header.file_comment_length = read_word (zip->header.raw + ZIPCCML);
-	zip->header.start_disk_number   = read_word (zip->header.raw + ZIPDSK);
-	zip->header.internal_attributes = read_word (zip->header.raw + ZIPINT);
-	zip->header.external_attributes = read_dword(zip->header.raw + ZIPEXT);
-	zip->header.local_header_offset = read_dword(zip->header.raw + ZIPOFST);
-	zip->header.filename            = (char *)zip->header.raw + ZIPCFN;
-
-	/* make sure we have enough data */
-	zip->header.rawlength += zip->header.filename_length;
-	zip->header.rawlength += zip->header.extra_field_length;
-	zip->header.rawlength += zip->header.file_comment_length;
-	if (zip->cd_pos + zip->header.rawlength > zip->ecd.cd_size)
+	if (zip->entry >= zip->directory->entry_count)
 		return NULL;
 
-	/* NULL terminate the filename */
-	zip->header.saved = zip->header.raw[ZIPCFN + zip->header.filename_length];
-	zip->header.raw[ZIPCFN + zip->header.filename_length] = 0;
-
-	/* advance the position */
-	zip->cd_pos += zip->header.rawlength;
-	return &zip->header;
+	/* the entries were all parsed when the directory was read */
+	zip->header = &zip->directory->entries[zip->entry++];
+	return zip->header;
 }
 
 
@@ -340,37 +342,81 @@ const zip_file_header *zip_file_next_file(zip_file *zip)
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
 {
 	zip_error ziperr;
-	UINT64 offset;
-
-	/* if we don't have enough buffer, error */
-	if (length < zip->header.uncompressed_length)
-		return ZIPERR_BUFFER_TOO_SMALL;
 
-	/* make sure the info in the header aligns with what we know */
-	if (zip->header.start_disk_number != zip->ecd.disk_number)
-		return ZIPERR_UNSUPPORTED;
+	/* make sure we have found a file */
+	if (zip->header == NULL)
+		return ZIPERR_FILE_ERROR;
 
-	/* get the compressed data offset */
-	ziperr = get_compressed_data_offset(zip, &offset);
+	/* make sure the file handle is open */
+	ziperr = open_file_handle(zip);
 	if (ziperr != ZIPERR_NONE)
 		return ziperr;
 
-	/* handle compression types */
-	switch (zip->header.compression)
+	return decompress_file(zip, zip->file, zip->header, buffer, length, zip->buffer);
+}
+
+
+/*-------------------------------------------------
+    zip_file_decompress_multiple - decompress
+    several files from a ZIP at once, spread
+    across worker threads
+-------------------------------------------------*/
+
+zip_error zip_file_decompress_multiple(zip_file *zip, zip_file_request *requests, int count)
+{
+	osd_work_queue *queue = NULL;
+	decompress_work *work = NULL;
+	zip_error ziperr;
+	int reqnum;
+
+	if (count == 0)
+		return ZIPERR_NONE;
+
+	/* make sure the archive is still there */
+	ziperr = open_file_handle(zip);
+	if (ziperr != ZIPERR_NONE)
 	{
-		case 0:
-			ziperr = decompress_data_type_0(zip, offset, buffer, length);
-			break;
+		for (reqnum = 0; reqnum < count; reqnum++)
+			requests[reqnum].error = ziperr;
+		return ziperr;
+	}
 
-		case 8:
-			ziperr = decompress_data_type_8(zip, offset, buffer, length);
-			break;
+	/* anything the workers don't get to reports out of memory */
+	for (reqnum = 0; reqnum < count; reqnum++)
+		requests[reqnum].error = ZIPERR_OUT_OF_MEMORY;
 
-		default:
-			ziperr = ZIPERR_UNSUPPORTED;
-			break;
+	/* a single file isn't worth handing off */
+	if (count > 1)
+	{
+		work = (decompress_work *)malloc(count * sizeof(*work));
+		if (work != NULL)
+			queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
 	}
-	return ziperr;
+
+	if (queue != NULL)
+	{
+		for (reqnum = 0; reqnum < count; reqnum++)
+		{
+			work[reqnum].zip = zip;
+			work[reqnum].request = &requests[reqnum];
+		}
+		osd_work_item_queue_multiple(queue, decompress_callback, count, work, sizeof(work[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		while (!osd_work_queue_wait(queue, osd_ticks_per_second()))
+			;
+		osd_work_queue_free(queue);
+	}
+	else
+		for (reqnum = 0; reqnum < count; reqnum++)
+			requests[reqnum].error = decompress_file(zip, zip->file, requests[reqnum].header, requests[reqnum].buffer, requests[reqnum].length, zip->buffer);
+
+	if (work != NULL)
+		free(work);
+
+	/* return the first error */
+	for (reqnum = 0; reqnum < count; reqnum++)
+		if (requests[reqnum].error != ZIPERR_NONE)
+			return requests[reqnum].error;
+	return ZIPERR_NONE;
 }
 
 
@@ -379,6 +425,19 @@ zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
     CACHE MANAGEMENT
 ***************************************************************************/
 
+/*-------------------------------------------------
+    acquire_cache_lock - take the cache lock,
+    allocating it on first use
+-------------------------------------------------*/
+
+static void acquire_cache_lock(void)
+{
+	if (zip_cache_lock == NULL)
+		zip_cache_lock = osd_lock_alloc();
+	osd_lock_acquire(zip_cache_lock);
+}
+
+
 /*-------------------------------------------------
     free_zip_file - free all the data for a
     zip_file
@@ -390,27 +449,139 @@ static void free_zip_file(zip_file *zip)
 	{
 		if (zip->file != NULL)
 			osd_close(zip->file);
-		if (zip->filename != NULL)
-			free((void *)zip->filename);
-		if (zip->ecd.raw != NULL)
-			free(zip->ecd.raw);
-		if (zip->cd != NULL)
-			free(zip->cd);
+		if (zip->directory != NULL)
+			release_directory(zip->directory);
 		free(zip);
 	}
 }
 
 
+/*-------------------------------------------------
+    release_directory - drop a reference to a
+    directory, freeing it once no handle uses it
+-------------------------------------------------*/
+
+static void release_directory(zip_directory *dir)
+{
+	zip_directory **scan;
+
+	acquire_cache_lock();
+	if (--dir->refcount == 0)
+	{
+		/* unlink it from the list */
+		for (scan = &zip_directories; *scan != NULL; scan = &(*scan)->next)
+			if (*scan == dir)
+			{
+				*scan = dir->next;
+				break;
+			}
+		free_directory(dir);
+	}
+	osd_lock_release(zip_cache_lock);
+}
+
+
+/*-------------------------------------------------
+    free_directory - free all the data for a
+    zip_directory
+-------------------------------------------------*/
+
+static void free_directory(zip_directory *dir)
+{
+	if (dir->filename != NULL)
+		free(dir->filename);
+	if (dir->ecd.raw != NULL)
+		free(dir->ecd.raw);
+	if (dir->cd != NULL)
+		free(dir->cd);
+	if (dir->entries != NULL)
+		free(dir->entries);
+	if (dir->names != NULL)
+		free(dir->names);
+	free(dir);
+}
+
+
 
 /***************************************************************************
     ZIP FILE PARSING
 ***************************************************************************/
 
+/*-------------------------------------------------
+    read_directory - read the central directory
+    of a ZIP file and index its entries
+-------------------------------------------------*/
+
+static zip_error read_directory(const char *filename, osd_file *file, UINT64 length, zip_directory **dir)
+{
+	zip_error ziperr;
+	file_error filerr;
+	UINT32 read_length;
+	zip_directory *newdir;
+
+	/* allocate memory for the zip_directory structure */
+	newdir = (zip_directory *)malloc(sizeof(*newdir));
+	if (newdir == NULL)
+		return ZIPERR_OUT_OF_MEMORY;
+	memset(newdir, 0, sizeof(*newdir));
+	newdir->length = length;
+	newdir->refcount = 1;
+
+	/* read ecd data */
+	ziperr = read_ecd(newdir, file);
+	if (ziperr != ZIPERR_NONE)
+		goto error;
+
+	/* verify that we can work with this zipfile (no disk spanning allowed) */
+	if (newdir->ecd.disk_number != newdir->ecd.cd_start_disk_number || newdir->ecd.cd_disk_entries != newdir->ecd.cd_total_entries)
+	{
+		ziperr = ZIPERR_UNSUPPORTED;
+		goto error;
+	}
+
+	/* allocate memory for the central directory */
+	newdir->cd = (UINT8 *)malloc(newdir->ecd.cd_size + 1);
+	if (newdir->cd == NULL)
+	{
+		ziperr = ZIPERR_OUT_OF_MEMORY;
+		goto error;
+	}
+
+	/* read the central directory */
+	filerr = osd_read(file, newdir->cd, newdir->ecd.cd_start_disk_offset, newdir->ecd.cd_size, &read_length);
+	if (filerr != FILERR_NONE || read_length != newdir->ecd.cd_size)
+	{
+		ziperr = (filerr == FILERR_NONE) ? ZIPERR_FILE_TRUNCATED : ZIPERR_FILE_ERROR;
+		goto error;
+	}
+
+	/* index the entries */
+	ziperr = parse_directory(newdir);
+	if (ziperr != ZIPERR_NONE)
+		goto error;
+
+	/* make a copy of the filename for caching purposes */
+	newdir->filename = (char *)malloc(strlen(filename) + 1);
+	if (newdir->filename == NULL)
+	{
+		ziperr = ZIPERR_OUT_OF_MEMORY;
+		goto error;
+	}
+	strcpy(newdir->filename, filename);
+	*dir = newdir;
+	return ZIPERR_NONE;
+
+error:
+	free_directory(newdir);
+	return ziperr;
+}
+
+
 /*-------------------------------------------------
     read_ecd - read the ECD data
 -------------------------------------------------*/
 
-static zip_error read_ecd(zip_file *zip)
+static zip_error read_ecd(zip_directory *dir, osd_file *file)
 {
 	UINT32 buflen = 1024;
 	UINT8 *buffer;
@@ -423,8 +594,8 @@ static zip_error read_ecd(zip_file *zip)
 		INT32 offset;
 
 		/* max out the buffer length at the size of the file */
-		if (buflen > zip->length)
-			buflen = zip->length;
+		if (buflen > dir->length)
+			buflen = dir->length;
 
 		/* allocate buffer */
 		buffer = (UINT8 *)malloc(buflen + 1);
@@ -432,7 +603,7 @@ static zip_error read_ecd(zip_file *zip)
 			return ZIPERR_OUT_OF_MEMORY;
 
 		/* read in one buffers' worth of data */
-		error = osd_read(zip->file, buffer, zip->length - buflen, buflen, &read_length);
+		error = osd_read(file, buffer, dir->length - buflen, buflen, &read_length);
 		if (error != FILERR_NONE || read_length != buflen)
 		{
 			free(buffer);
@@ -448,29 +619,29 @@ static zip_error read_ecd(zip_file *zip)
 		if (offset >= 0)
 		{
 			/* reuse the buffer as our ECD buffer */
-			zip->ecd.raw = buffer;
-			zip->ecd.rawlength = buflen - offset;
+			dir->ecd.raw = buffer;
+			dir->ecd.rawlength = buflen - offset;
 
 			/* append a NULL terminator to the comment */
-			memmove(&buffer[0], &buffer[offset], zip->ecd.rawlength);
-			zip->ecd.raw[zip->ecd.rawlength] = 0;
+			memmove(&buffer[0], &buffer[offset], dir->ecd.rawlength);
+			dir->ecd.raw[dir->ecd.rawlength] = 0;
 
 			/* extract ecd info */
-			zip->ecd.signature            = read_dword(zip->ecd.raw + ZIPESIG);
-			zip->ecd.disk_number          = read_word (zip->ecd.raw + ZIPEDSK);
-			zip->ecd.cd_start_disk_number = read_word (zip->ecd.raw + ZIPECEN);
-			zip->ecd.cd_disk_entries      = read_word (zip->ecd.raw + ZIPENUM);
-			zip->ecd.cd_total_entries     = read_word (zip->ecd.raw + ZIPECENN);
-			zip->ecd.cd_size              = read_dword(zip->ecd.raw + ZIPECSZ);
-			zip->ecd.cd_start_disk_offset = read_dword(zip->ecd.raw + ZIPEOFST);
-			zip->ecd.comment_length       = read_word (zip->ecd.raw + ZIPECOML);
-			zip->ecd.comment              = (const char *)(zip->ecd.raw + ZIPECOM);
+			dir->ecd.signature            = read_dword(dir->ecd.raw + ZIPESIG);
+			dir->ecd.disk_number          = read_word (dir->ecd.raw + ZIPEDSK);
+			dir->ecd.cd_start_disk_number = read_word (dir->ecd.raw + ZIPECEN);
+			dir->ecd.cd_disk_entries      = read_word (dir->ecd.raw + ZIPENUM);
+			dir->ecd.cd_total_entries     = read_word (dir->ecd.raw + ZIPECENN);
+			dir->ecd.cd_size              = read_dword(dir->ecd.raw + ZIPECSZ);
+			dir->ecd.cd_start_disk_offset = read_dword(dir->ecd.raw + ZIPEOFST);
+			dir->ecd.comment_length       = read_word (dir->ecd.raw + ZIPECOML);
+			dir->ecd.comment              = (const char *)(dir->ecd.raw + ZIPECOM);
 			return ZIPERR_NONE;
 		}
 
 		/* didn't find it; free this buffer and expand our search */
 		free(buffer);
-		if (buflen < zip->length)
+		if (buflen < dir->length)
 			buflen *= 2;
 		else
 			return ZIPERR_BAD_SIGNATURE;
@@ -480,32 +651,116 @@ static zip_error read_ecd(zip_file *zip)
 
 
 /*-------------------------------------------------
-    get_compressed_data_offset - return the
-    offset of the compressed data
+    parse_directory - extract the header of every
+    entry in the central directory, stopping at
+    the first one that is truncated
 -------------------------------------------------*/
 
-static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset)
+static zip_error parse_directory(zip_directory *dir)
 {
-	file_error error;
-	UINT32 read_length;
+	UINT32 count = 0, namelength = 0;
+	UINT32 pos, entrynum;
+	char *name;
 
-	/* make sure the file handle is open */
+	/* first count the entries and the space for their names */
+	for (pos = 0; pos + ZIPCFN <= dir->ecd.cd_size; count++)
+	{
+		UINT8 *raw = dir->cd + pos;
+		UINT32 rawlength = ZIPCFN + read_word(raw + ZIPCFNL) + read_word(raw + ZIPCXTL) + read_word(raw + ZIPCCML);
+		if (pos + rawlength > dir->ecd.cd_size)
+			break;
+		namelength += read_word(raw + ZIPCFNL) + 1;
+		pos += rawlength;
+	}
+
+	/* allocate the index and the names */
+	dir->entries = (zip_file_header *)malloc((count + 1) * sizeof(dir->entries[0]));
+	dir->names = (char *)malloc(namelength + 1);
+	if (dir->entries == NULL || dir->names == NULL)
+		return ZIPERR_OUT_OF_MEMORY;
+	dir->entry_count = count;
+
+	/* then fill them in */
+	name = dir->names;
+	for (pos = 0, entrynum = 0; entrynum < count; entrynum++)
+	{
+		zip_file_header *header = &dir->entries[entrynum];
+
+		/* extract file header info */
+		header->raw                 = dir->cd + pos;
+		header->rawlength           = ZIPCFN;
+		header->signature           = read_dword(header->raw + ZIPCENSIG);
+		header->version_created     = read_word (header->raw + ZIPCVER);
+		header->version_needed      = read_word (header->raw + ZIPCVXT);
+		header->bit_flag            = read_word (header->raw + ZIPCFLG);
+		header->compression         = read_word (header->raw + ZIPCMTHD);
+		header->file_time           = read_word (header->raw + ZIPCTIM);
+		header->file_date           = read_word (header->raw + ZIPCDAT);
+		header->crc                 = read_dword(header->raw + ZIPCCRC);
+		header->compressed_length   = read_dword(header->raw + ZIPCSIZ);
+		header->uncompressed_length = read_dword(header->raw + ZIPCUNC);
+		header->filename_length     = read_word (header->raw + ZIPCFNL);
+		header->extra_field_length  = read_word (header->raw + ZIPCXTL);
+		header->file_comment_length = read_word (header->raw + ZIPCCML);
+		header->start_disk_number   = read_word (header->raw + ZIPDSK);
+		header->internal_attributes = read_word (header->raw + ZIPINT);
+		header->external_attributes = read_dword(header->raw + ZIPEXT);
+		header->local_header_offset = read_dword(header->raw + ZIPOFST);
+
+		/* make a NULL-terminated copy of the filename */
+		memcpy(name, header->raw + ZIPCFN, header->filename_length);
+		name[header->filename_length] = 0;
+		header->filename = name;
+		name += header->filename_length + 1;
+
+		/* advance the position */
+		header->rawlength += header->filename_length;
+		header->rawlength += header->extra_field_length;
+		header->rawlength += header->file_comment_length;
+		pos += header->rawlength;
+	}
+	return ZIPERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    open_file_handle - make sure the file handle
+    is open; it is closed while the ZIP sits in
+    the cache
+-------------------------------------------------*/
+
+static zip_error open_file_handle(zip_file *zip)
+{
 	if (zip->file == NULL)
 	{
-		int filerr = osd_open(zip->filename, OPEN_FLAG_READ, &zip->file, &zip->length);
+		file_error filerr = osd_open(zip->filename, OPEN_FLAG_READ, &zip->file, &zip->length);
 		if (filerr != FILERR_NONE)
 			return ZIPERR_FILE_ERROR;
 	}
+	return ZIPERR_NONE;
+}
 
-	/* now go read the fixed-sized part of the local file header */
-	error = osd_read(zip->file, zip->buffer, zip->header.local_header_offset, ZIPNAME, &read_length);
+
+/*-------------------------------------------------
+    get_compressed_data_offset - return the
+    offset of the compressed data
+-------------------------------------------------*/
+
+static zip_error get_compressed_data_offset(osd_file *file, const zip_file_header *header, UINT64 *offset)
+{
+	UINT8 local[ZIPNAME];
+	file_error error;
+	UINT32 read_length;
+
+	/* go read the fixed-sized part of the local file header */
+	error = osd_read(file, local, header->local_header_offset, ZIPNAME, &read_length);
 	if (error != FILERR_NONE || read_length != ZIPNAME)
 		return (error == FILERR_NONE) ? ZIPERR_FILE_TRUNCATED : ZIPERR_FILE_ERROR;
 
 	/* compute the final offset */
-	*offset = zip->header.local_header_offset + ZIPNAME;
-	*offset += read_word(zip->buffer + ZIPFNLN);
-	*offset += read_word(zip->buffer + ZIPXTRALN);
+	*offset = header->local_header_offset + ZIPNAME;
+	*offset += read_word(local + ZIPFNLN);
+	*offset += read_word(local + ZIPXTRALN);
 
 	return ZIPERR_NONE;
 }
@@ -516,21 +771,101 @@ static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset)
     DECOMPRESSION INTERFACES
 ***************************************************************************/
 
+/*-------------------------------------------------
+    decompress_file - decompress a file from a
+    ZIP through the given open handle, reading
+    compressed data through inbuf, which must
+    hold ZIP_DECOMPRESS_BUFSIZE + 1 bytes
+-------------------------------------------------*/
+
+static zip_error decompress_file(zip_file *zip, osd_file *file, const zip_file_header *header, void *buffer, UINT32 length, UINT8 *inbuf)
+{
+	zip_error ziperr;
+	UINT64 offset;
+
+	/* if we don't have enough buffer, error */
+	if (length < header->uncompressed_length)
+		return ZIPERR_BUFFER_TOO_SMALL;
+
+	/* make sure the info in the header aligns with what we know */
+	if (header->start_disk_number != zip->directory->ecd.disk_number)
+		return ZIPERR_UNSUPPORTED;
+
+	/* get the compressed data offset */
+	ziperr = get_compressed_data_offset(file, header, &offset);
+	if (ziperr != ZIPERR_NONE)
+		return ziperr;
+
+	/* handle compression types */
+	switch (header->compression)
+	{
+		case 0:
+			ziperr = decompress_data_type_0(file, header, offset, buffer);
+			break;
+
+		case 8:
+			ziperr = decompress_data_type_8(file, header, offset, buffer, length, inbuf);
+			break;
+
+		default:
+			ziperr = ZIPERR_UNSUPPORTED;
+			break;
+	}
+	return ziperr;
+}
+
+
+/*-------------------------------------------------
+    decompress_callback - decompress one file of
+    a batch on a worker thread
+-------------------------------------------------*/
+
+static void *decompress_callback(void *param, int threadid)
+{
+	decompress_work *work = (decompress_work *)param;
+	zip_file_request *request = work->request;
+
+	osd_file *file;
+	UINT64 length;
+
+	/* each worker needs its own buffer for the compressed data */
+	UINT8 *inbuf = (UINT8 *)malloc(ZIP_DECOMPRESS_BUFSIZE + 1);
+	if (inbuf == NULL)
+		return NULL;
+
+	/* and its own handle, since reads on a shared one aren't atomic on every platform */
+	if (osd_open(work->zip->filename, OPEN_FLAG_READ, &file, &length) != FILERR_NONE)
+		request->error = ZIPERR_FILE_ERROR;
+	else if (length != work->zip->length)
+	{
+		request->error = ZIPERR_FILE_ERROR;
+		osd_close(file);
+	}
+	else
+	{
+		request->error = decompress_file(work->zip, file, request->header, request->buffer, request->length, inbuf);
+		osd_close(file);
+	}
+	free(inbuf);
+	return NULL;
+}
+
+
 /*-------------------------------------------------
     decompress_data_type_0 - "decompress"
     type 0 data (which is uncompressed)
 -------------------------------------------------*/
 
-static zip_error decompress_data_type_0(zip_file *zip, UINT64 offset, void *buffer, UINT32 length)
+static zip_error decompress_data_type_0(osd_file *file, const zip_file_header *header, UINT64 offset, void *buffer)
 {
 	file_error filerr;
 	UINT32 read_length;
 
 	/* the data is uncompressed; just read it */
-	filerr = osd_read(zip->file, buffer, offset, zip->header.compressed_length, &read_length);
+	filerr = osd_read(file, buffer, offset, header->compressed_length, &read_length);
 	if (filerr != FILERR_NONE)
 		return ZIPERR_FILE_ERROR;
-	else if (read_length != zip->header.compressed_length)
+	else if (read_length != header->compressed_length)
 		return ZIPERR_FILE_TRUNCATED;
 	else
 		return ZIPERR_NONE;
@@ -542,16 +877,16 @@ static zip_error decompress_data_type_0(zip_file *zip, UINT64 offset, void *buff
     type 8 data (which is deflated)
 -------------------------------------------------*/
 
-static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buffer, UINT32 length)
+static zip_error decompress_data_type_8(osd_file *file, const zip_file_header *header, UINT64 offset, void *buffer, UINT32 length, UINT8 *inbuf)
 {
-	UINT32 input_remaining = zip->header.compressed_length;
+	UINT32 input_remaining = header->compressed_length;
 	UINT32 read_length;
 	z_stream stream;
 	int filerr;
 	int zerr;
 
 	/* make sure we don't need a newer mechanism */
-	if (zip->header.version_needed > 0x14)
+	if (header->version_needed > 0x14)
 		return ZIPERR_UNSUPPORTED;
 
 	/* reset the stream */
@@ -568,7 +903,7 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
 	while (1)
 	{
 		/* read in the next chunk of data */
-		filerr = osd_read(zip->file, zip->buffer, offset, MIN(input_remaining, sizeof(zip->buffer)), &read_length);
+		filerr = osd_read(file, inbuf, offset, MIN(input_remaining, ZIP_DECOMPRESS_BUFSIZE), &read_length);
 		if (filerr != FILERR_NONE)
 		{
 			inflateEnd(&stream);
@@ -584,13 +919,16 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
 		}
 
 		/* fill out the input data */
-		stream.next_in = zip->buffer;
+		stream.next_in = inbuf;
 		stream.avail_in = read_length;
 		input_remaining -= read_length;
 
-		/* add a dummy byte at end of compressed data */
+		/* add a dummy byte at end of compressed data; inbuf has room for it */
 		if (input_remaining == 0)
+		{
+			inbuf[read_length] = 0;
 			stream.avail_in++;
+		}
 
 		/* now inflate */
 		zerr = inflate(&stream, Z_NO_FLUSH);
@@ -20,7 +20,7 @@
     CONSTANTS
 ***************************************************************************/
 
-#define ZIP_DECOMPRESS_BUFSIZE  16384
+#define ZIP_DECOMPRESS_BUFSIZE  65536
 
 /* Error types */
 enum zip_error
@@ -66,7 +66,6 @@ struct zip_file_header
 
 	UINT8 *         raw;                    /* pointer to the raw data */
 	UINT32          rawlength;              /* length of the raw data */
-	UINT8           saved;                  /* saved byte from after filename */
 };
 
 
@@ -88,20 +87,32 @@ struct zip_ecd
 };
 
 
+/* parsed central directory, shared by all open handles on the same ZIP */
+struct zip_directory;
+
+
 /* describes an open ZIP file */
 struct zip_file
 {
-	const char *    filename;               /* copy of ZIP filename (for caching) */
+	const char *    filename;               /* ZIP filename (owned by the directory) */
 	osd_file *      file;                   /* OSD file handle */
 	UINT64          length;                 /* length of zip file */
 
-	zip_ecd         ecd;                    /* end of central directory */
+	zip_directory * directory;              /* central directory index */
+	UINT32          entry;                  /* index of the next entry to return */
+	const zip_file_header *header;          /* current file header */
+
+	UINT8           buffer[ZIP_DECOMPRESS_BUFSIZE + 1]; /* buffer for decompression */
+};
 
-	UINT8 *         cd;                     /* central directory raw data */
-	UINT32          cd_pos;                 /* position in central directory */
-	zip_file_header header;                 /* current file header */
 
-	UINT8           buffer[ZIP_DECOMPRESS_BUFSIZE]; /* buffer for decompression */
+/* describes one file to decompress with zip_file_decompress_multiple */
+struct zip_file_request
+{
+	const zip_file_header *header;          /* file to decompress, from zip_file_first_file/next_file */
+	void *          buffer;                 /* buffer to decompress into */
+	UINT32          length;                 /* length of the buffer */
+	zip_error       error;                  /* result for this file */
 };
 
 
@@ -134,5 +145,8 @@ const zip_file_header *zip_file_next_file(zip_file *zip);
 /* decompress the most recently found file in the ZIP */
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length);
 
+/* decompress several files from the ZIP in parallel; returns the first error */
+zip_error zip_file_decompress_multiple(zip_file *zip, zip_file_request *requests, int count);
+
 
 #endif  /* __UNZIP_H__ */
@@ -53,6 +53,9 @@ typedef void *PVOID;
 
 #define SPIN_LOOP_TIME          (osd_ticks_per_second() / 10000)
 
+// size of each thread's deque; must be a power of 2
+#define WORK_DEQUE_SIZE         256
+
 //============================================================
 //  MACROS
 //============================================================
@@ -93,19 +96,36 @@ static void spin_while_not(const volatile _PtrType * volatile ptr, const _PtrTyp
 //  TYPE DEFINITIONS
 //============================================================
 
+// Each thread keeps a Chase-Lev style deque of items it has taken
+// from the queue: the owner pushes and pops at the bottom without
+// locking, while idle threads steal from the top with a single
+// compare/exchange. The counters only ever increase, and are
+// compared by their difference so that they can safely wrap.
+struct work_deque
+{
+	osd_work_item * volatile item[WORK_DEQUE_SIZE]; // ring of items
+	volatile INT32      top;            // index of the next item to steal
+	volatile INT32      bottom;         // index of the next free slot
+};
+
+
 struct work_thread_info
 {
 	osd_work_queue *    queue;          // pointer back to the queue
 	osd_thread *        handle;         // handle to the thread
 	osd_event *         wakeevent;      // wake event for the thread
 	volatile INT32      active;         // are we actively processing work?
+	volatile INT32      owned;          // is some thread using our deque right now?
+	work_deque          deque;          // items taken by this thread
 
 #if KEEP_STATISTICS
 	INT32               itemsdone;
+	INT32               steals;         // items stolen from other threads
 	osd_ticks_t         actruntime;
 	osd_ticks_t         runtime;
 	osd_ticks_t         spintime;
 	osd_ticks_t         waittime;
+	osd_ticks_t         idletime;       // time spent looking for something to steal
 #endif
 };
 
@@ -117,6 +137,8 @@ struct osd_work_queue
 	osd_work_item ** volatile tailptr;  // pointer to the tail pointer of work items in the queue
 	osd_work_item * volatile free;      // free list of work items
 	volatile INT32      items;          // items in the queue
+	volatile INT32      listitems;      // items in the list, not yet taken by a thread
+	volatile INT32      pending;        // items not yet picked up to run
 	volatile INT32      livethreads;    // number of live threads
 	volatile INT32      waiting;        // is someone waiting on the queue to complete?
 	volatile INT32      exiting;        // should the threads exit on their next opportunity?
@@ -130,6 +152,10 @@ struct osd_work_queue
 	volatile INT32      setevents;      // number of times we called SetEvent
 	volatile INT32      extraitems;     // how many extra items we got after the first in the queue loop
 	volatile INT32      spinloops;      // how many times spinning bought us more items
+	volatile INT32      batches;        // how many times a thread took items off the list
+	volatile INT32      maxdepth;       // largest number of items ever in the queue
+	INT64               depthtotal;     // sum of the depth seen at each queue call (approximate)
+	INT32               depthsamples;   // number of queue calls sampled
 #endif
 };
 
@@ -160,6 +186,8 @@ static int effective_num_processors(void);
 static void * worker_thread_entry(void *param);
 static void worker_thread_process(osd_work_queue *queue, work_thread_info *thread);
 static bool queue_has_list_items(osd_work_queue *queue);
+static osd_work_item *take_list_items(osd_work_queue *queue, work_thread_info *thread, bool usedeque);
+static osd_work_item *steal_item(osd_work_queue *queue, work_thread_info *thread);
 
 
 //============================================================
@@ -172,7 +200,6 @@ osd_work_queue *osd_work_queue_alloc(int flags)
 	int numprocs = effective_num_processors();
 	osd_work_queue *queue;
 	int osdthreadnum = 0;
-	int allocthreadnum;
 	const char *osdworkqueuemaxthreads = osd_getenv(ENV_WORKQUEUEMAXTHREADS);
 
 	// allocate a new queue
@@ -209,20 +236,23 @@ osd_work_queue *osd_work_queue_alloc(int flags)
 	// clamp to the maximum
 	queue->threads = MIN(threadnum, WORK_MAX_THREADS);
 
-	// allocate memory for thread array (+1 to count the calling thread if WORK_QUEUE_FLAG_MULTI)
+#if KEEP_STATISTICS
+	// count the calling thread if WORK_QUEUE_FLAG_MULTI
+	int allocthreadnum;
 	if (flags & WORK_QUEUE_FLAG_MULTI)
 		allocthreadnum = queue->threads + 1;
 	else
 		allocthreadnum = queue->threads;
 
-#if KEEP_STATISTICS
 	printf("osdprocs: %d effecprocs: %d threads: %d allocthreads: %d osdthreads: %d maxthreads: %d queuethreads: %d\n", osd_num_processors, numprocs, threadnum, allocthreadnum, osdthreadnum, WORK_MAX_THREADS, queue->threads);
 #endif
 
-	queue->thread = (work_thread_info *)osd_malloc_array(allocthreadnum * sizeof(queue->thread[0]));
+	// allocate memory for thread array; there is always an extra entry whose
+	// deque is used by the calling thread when it processes items itself
+	queue->thread = (work_thread_info *)osd_malloc_array((queue->threads + 1) * sizeof(queue->thread[0]));
 	if (queue->thread == NULL)
 		goto error;
-	memset(queue->thread, 0, allocthreadnum * sizeof(queue->thread[0]));
+	memset(queue->thread, 0, (queue->threads + 1) * sizeof(queue->thread[0]));
 
 	// iterate over threads
 	for (threadnum = 0; threadnum < queue->threads; threadnum++)
@@ -378,10 +408,11 @@ void osd_work_queue_free(osd_work_queue *queue)
 		{
 			work_thread_info *thread = &queue->thread[threadnum];
 			osd_ticks_t total = thread->runtime + thread->waittime + thread->spintime;
-			printf("Thread %d:  items=%9d run=%5.2f%% (%5.2f%%)  spin=%5.2f%%  wait/other=%5.2f%% total=%9d\n",
-					threadnum, thread->itemsdone,
+			printf("Thread %d:  items=%9d steals=%9d run=%5.2f%% (%5.2f%%)  idle=%5.2f%%  spin=%5.2f%%  wait/other=%5.2f%% total=%9d\n",
+					threadnum, thread->itemsdone, thread->steals,
 					(double)thread->runtime * 100.0 / (double)total,
 					(double)thread->actruntime * 100.0 / (double)total,
+					(double)thread->idletime * 100.0 / (double)total,
 					(double)thread->spintime * 100.0 / (double)total,
 					(double)thread->waittime * 100.0 / (double)total,
 					(UINT32) total);
@@ -422,6 +453,9 @@ void osd_work_queue_free(osd_work_queue *queue)
 	printf("SetEvent calls = %9d\n", queue->setevents);
 	printf("Extra items    = %9d\n", queue->extraitems);
 	printf("Spin loops     = %9d\n", queue->spinloops);
+	printf("List batches   = %9d\n", queue->batches);
+	printf("Max depth      = %9d\n", queue->maxdepth);
+	printf("Average depth  = %9.2f\n", (queue->depthsamples != 0) ? (double)queue->depthtotal / (double)queue->depthsamples : 0.0);
 #endif
 
 	osd_scalable_lock_free(queue->lock);
@@ -484,16 +518,30 @@ osd_work_item *osd_work_item_queue_multiple(osd_work_queue *queue, osd_work_call
 		parambase = (UINT8 *)parambase + paramstep;
 	}
 
+	// count the items as pending before anyone can see them
+	atomic_add32(&queue->pending, numitems);
+
 	// enqueue the whole thing within the critical section
 	lockslot = osd_scalable_lock_acquire(queue->lock);
 	*queue->tailptr = itemlist;
 	queue->tailptr = item_tailptr;
+	atomic_add32(&queue->listitems, numitems);
 	osd_scalable_lock_release(queue->lock, lockslot);
 
 	// increment the number of items in the queue
-	atomic_add32(&queue->items, numitems);
+	INT32 depth = atomic_add32(&queue->items, numitems);
 	add_to_stat(&queue->itemsqueued, numitems);
 
+#if KEEP_STATISTICS
+	// track the queue depth
+	INT32 maxdepth;
+	while ((maxdepth = queue->maxdepth) < depth && compare_exchange32(&queue->maxdepth, maxdepth, depth) != maxdepth) { }
+	queue->depthtotal += depth;
+	queue->depthsamples++;
+#else
+	(void)depth;
+#endif
+
 	// look for free threads to do the work
 	if (queue->livethreads < queue->threads)
 	{
@@ -668,11 +716,11 @@ static void *worker_thread_entry(void *param)
 			worker_thread_process(queue, thread);
 
 			// if we're a high frequency queue, spin for a while before giving up
-			if (queue->flags & WORK_QUEUE_FLAG_HIGH_FREQ && queue->list == NULL)
+			if (queue->flags & WORK_QUEUE_FLAG_HIGH_FREQ && queue->pending == 0)
 			{
 				// spin for a while looking for more work
 				begin_timing(thread->spintime);
-				spin_while(&queue->list, (osd_work_item *)NULL, SPIN_LOOP_TIME);
+				spin_while(&queue->pending, 0, SPIN_LOOP_TIME);
 				end_timing(thread->spintime);
 			}
 
@@ -695,6 +743,141 @@ static void *worker_thread_entry(void *param)
 }
 
 
+//============================================================
+//  deque_push - add an item to the bottom of a
+//  thread's deque; only the owner may call this
+//============================================================
+
+static void deque_push(work_deque *deque, osd_work_item *item)
+{
+	INT32 bottom = deque->bottom;
+	deque->item[bottom & (WORK_DEQUE_SIZE - 1)] = item;
+
+	// the exchange makes sure the item is visible before the new bottom
+	atomic_exchange32(&deque->bottom, (INT32)((UINT32)bottom + 1));
+}
+
+
+//============================================================
+//  deque_pop - remove the most recently pushed
+//  item from a thread's deque; only the owner may
+//  call this
+//============================================================
+
+static osd_work_item *deque_pop(work_deque *deque)
+{
+	// claim the bottom slot before looking at the top
+	INT32 bottom = (INT32)((UINT32)deque->bottom - 1);
+	atomic_exchange32(&deque->bottom, bottom);
+	INT32 top = deque->top;
+	INT32 count = (INT32)((UINT32)bottom - (UINT32)top);
+
+	// if we went past the top, it was empty; put things back
+	if (count < 0)
+	{
+		atomic_exchange32(&deque->bottom, top);
+		return NULL;
+	}
+
+	// if there is more than one item, no thief can get in our way
+	osd_work_item *item = deque->item[bottom & (WORK_DEQUE_SIZE - 1)];
+	if (count > 0)
+		return item;
+
+	// otherwise, race any thieves for the last one
+	INT32 newtop = (INT32)((UINT32)top + 1);
+	if (compare_exchange32(&deque->top, top, newtop) != top)
+		item = NULL;
+	atomic_exchange32(&deque->bottom, newtop);
+	return item;
+}
+
+
+//============================================================
+//  deque_steal - remove the oldest item from
+//  another thread's deque
+//============================================================
+
+static osd_work_item *deque_steal(work_deque *deque)
+{
+	INT32 top = deque->top;
+	INT32 bottom = deque->bottom;
+	if ((INT32)((UINT32)bottom - (UINT32)top) <= 0)
+		return NULL;
+
+	// read the item before claiming it; if we lose the race, someone else has it
+	osd_work_item *item = deque->item[top & (WORK_DEQUE_SIZE - 1)];
+	if (compare_exchange32(&deque->top, top, (INT32)((UINT32)top + 1)) != top)
+		return NULL;
+	return item;
+}
+
+
+//============================================================
+//  take_list_items - take a share of the items
+//  on the queue's list; the first is returned and
+//  the rest go onto our deque
+//============================================================
+
+static osd_work_item *take_list_items(osd_work_queue *queue, work_thread_info *thread, bool usedeque)
+{
+	osd_work_item *batch[WORK_DEQUE_SIZE + 1];
+	int count = 0;
+
+	// don't bother with the lock if there's nothing there
+	if (queue->listitems == 0)
+		return NULL;
+
+	// take our fair share of the list in one go, leaving the rest for the other threads
+	INT32 lockslot = osd_scalable_lock_acquire(queue->lock);
+	int wanted = usedeque ? MIN(queue->listitems / (queue->threads + 1) + 1, WORK_DEQUE_SIZE + 1) : 1;
+	while (count < wanted && queue->list != NULL)
+	{
+		batch[count++] = (osd_work_item *)queue->list;
+		queue->list = queue->list->next;
+	}
+	if (queue->list == NULL)
+		queue->tailptr = (osd_work_item **)&queue->list;
+	if (count != 0)
+		atomic_add32(&queue->listitems, -count);
+	osd_scalable_lock_release(queue->lock, lockslot);
+
+	if (count == 0)
+		return NULL;
+	add_to_stat(&queue->batches, 1);
+
+	// push the extras in reverse, so that we pop them in queue order
+	for (int itemnum = count - 1; itemnum > 0; itemnum--)
+		deque_push(&thread->deque, batch[itemnum]);
+	return batch[0];
+}
+
+
+//============================================================
+//  steal_item - take an item from another
+//  thread's deque
+//============================================================
+
+static osd_work_item *steal_item(osd_work_queue *queue, work_thread_info *thread)
+{
+	int threadid = thread - queue->thread;
+	int numthreads = queue->threads + 1;
+
+	// start with our neighbor, so that thieves spread out
+	for (int offset = 1; offset < numthreads; offset++)
+	{
+		work_thread_info *victim = &queue->thread[(threadid + offset) % numthreads];
+		osd_work_item *item = deque_steal(&victim->deque);
+		if (item != NULL)
+		{
+			add_to_stat(&thread->steals, 1);
+			return item;
+		}
+	}
+	return NULL;
+}
+
+
 //============================================================
 //  worker_thread_process
 //============================================================
@@ -703,6 +886,10 @@ static void worker_thread_process(osd_work_queue *queue, work_thread_info *threa
 {
 	int threadid = thread - queue->thread;
 
+	// the calling thread's entry can be shared by several threads; only one
+	// of them at a time gets to use the deque, the others just take and steal
+	bool usedeque = (compare_exchange32(&thread->owned, FALSE, TRUE) == FALSE);
+
 	begin_timing(thread->runtime);
 
 	// loop until everything is processed
@@ -710,67 +897,62 @@ static void worker_thread_process(osd_work_queue *queue, work_thread_info *threa
 	{
 		osd_work_item *item = NULL;
 
-		bool end_loop = false;
+		// our own deque first, then the shared list, then everyone else's deques
+		if (usedeque)
+			item = deque_pop(&thread->deque);
+		if (item == NULL)
+			item = take_list_items(queue, thread, usedeque);
+		if (item == NULL)
+		{
+			begin_timing(thread->idletime);
+			item = steal_item(queue, thread);
+			end_timing(thread->idletime);
+		}
 
-		// use a critical section to synchronize the removal of items
+		// if we came up empty, stop once nothing is left waiting to run; otherwise
+		// an item is on its way between the list and a deque, so look again
+		if (item == NULL)
 		{
-			INT32 lockslot = osd_scalable_lock_acquire(queue->lock);
-			if (queue->list == NULL)
-			{
-				end_loop = true;
-			}
-			else
-			{
-				// pull the item from the queue
-				item = (osd_work_item *)queue->list;
-				if (item != NULL)
-				{
-					queue->list = item->next;
-					if (queue->list == NULL)
-						queue->tailptr = (osd_work_item **)&queue->list;
-				}
-			}
-			osd_scalable_lock_release(queue->lock, lockslot);
+			if (queue->pending <= 0)
+				break;
+			continue;
 		}
+		atomic_decrement32(&queue->pending);
 
-		if (end_loop)
-			break;
+		// call the callback and stash the result
+		begin_timing(thread->actruntime);
+		item->result = (*item->callback)(item->param, threadid);
+		end_timing(thread->actruntime);
 
-		// process non-NULL items
-		if (item != NULL)
+		// decrement the item count after we are done
+		atomic_decrement32(&queue->items);
+		atomic_exchange32(&item->done, TRUE);
+		add_to_stat(&thread->itemsdone, 1);
+
+		// if it's an auto-release item, release it
+		if (item->flags & WORK_ITEM_FLAG_AUTO_RELEASE)
+			osd_work_item_release(item);
+
+		// set the result and signal the event
+		else
 		{
-			// call the callback and stash the result
-			begin_timing(thread->actruntime);
-			item->result = (*item->callback)(item->param, threadid);
-			end_timing(thread->actruntime);
-
-			// decrement the item count after we are done
-			atomic_decrement32(&queue->items);
-			atomic_exchange32(&item->done, TRUE);
-			add_to_stat(&thread->itemsdone, 1);
-
-			// if it's an auto-release item, release it
-			if (item->flags & WORK_ITEM_FLAG_AUTO_RELEASE)
-				osd_work_item_release(item);
-
-			// set the result and signal the event
-			else
+			INT32 lockslot = osd_scalable_lock_acquire(item->queue->lock);
+			if (item->event != NULL)
 			{
-				INT32 lockslot = osd_scalable_lock_acquire(item->queue->lock);
-				if (item->event != NULL)
-				{
-					osd_event_set(item->event);
-					add_to_stat(&item->queue->setevents, 1);
-				}
-				osd_scalable_lock_release(item->queue->lock, lockslot);
+				osd_event_set(item->event);
+				add_to_stat(&item->queue->setevents, 1);
 			}
-
-			// if we removed an item and there's still work to do, bump the stats
-			if (queue_has_list_items(queue))
-				add_to_stat(&queue->extraitems, 1);
+			osd_scalable_lock_release(item->queue->lock, lockslot);
 		}
+
+		// if we removed an item and there's still work to do, bump the stats
+		if (queue_has_list_items(queue))
+			add_to_stat(&queue->extraitems, 1);
 	}
 
+	if (usedeque)
+		atomic_exchange32(&thread->owned, FALSE);
+
 	// we don't need to set the doneevent for multi queues because they spin
 	if (queue->waiting)
 	{
@@ -783,8 +965,6 @@ static void worker_thread_process(osd_work_queue *queue, work_thread_info *threa
 
 bool queue_has_list_items(osd_work_queue *queue)
 {
-	INT32 lockslot = osd_scalable_lock_acquire(queue->lock);
-	bool has_list_items = (queue->list != NULL);
-	osd_scalable_lock_release(queue->lock, lockslot);
-	return has_list_items;
+	// anything queued that nobody has picked up yet, whether on the list or in a deque
+	return (queue->pending > 0);
 }
@@ -194,6 +194,47 @@ file_error osd_truncate(osd_file *file, UINT64 offset);
 file_error osd_rmfile(const char *filename);
 
 
+/*-----------------------------------------------------------------------------
+    osd_map_file: map the start of a file into memory, copy-on-write
+
+    Parameters:
+
+        path - path to the file to map
+
+        length - number of bytes to map; must not exceed the file's size
+
+        base - pointer to a void * to receive the address of the mapping
+
+    Return value:
+
+        a file_error describing any error that occurred while mapping
+        the file, or FILERR_NONE if no error occurred
+
+    Notes:
+
+        The mapping is private: writes to it go to copies of the pages
+        they touch, and never reach the file. OSDs that cannot map files
+        return an error, and callers fall back to reading the file.
+-----------------------------------------------------------------------------*/
+file_error osd_map_file(const char *path, UINT64 length, void **base);
+
+
+/*-----------------------------------------------------------------------------
+    osd_unmap_file: release a mapping made by osd_map_file
+
+    Parameters:
+
+        base - the address returned by osd_map_file
+
+        length - the length passed to osd_map_file
+
+    Return value:
+
+        None
+-----------------------------------------------------------------------------*/
+void osd_unmap_file(void *base, UINT64 length);
+
+
 /*-----------------------------------------------------------------------------
     osd_getenv: return pointer to environment variable
 
@@ -282,6 +323,7 @@ struct osd_directory_entry
 	const char *        name;           /* name of the entry */
 	osd_dir_entry_type  type;           /* type of the entry */
 	UINT64              size;           /* size of the entry */
+	UINT64              modified;       /* last modification time, in OSD-specific units; 0 if unknown */
 };
 
 
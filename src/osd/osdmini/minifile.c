@@ -111,6 +111,27 @@ file_error osd_rmfile(const char *filename)
 }
 
 
+//============================================================
+//  osd_map_file
+//============================================================
+
+file_error osd_map_file(const char *path, UINT64 length, void **base)
+{
+	// there is no standard way of doing this, so callers read the file instead
+	*base = NULL;
+	return FILERR_FAILURE;
+}
+
+
+//============================================================
+//  osd_unmap_file
+//============================================================
+
+void osd_unmap_file(void *base, UINT64 length)
+{
+}
+
+
 //============================================================
 //  osd_get_physical_drive_geometry
 //============================================================
@@ -150,6 +171,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = (char *)(result + 1);
 	result->type = ENTTYPE_NONE;
 	result->size = 0;
+	result->modified = 0;
 
 	FILE *f = fopen(path, "rb");
 	if (f != NULL)
@@ -217,6 +217,7 @@ const osd_directory_entry *osd_readdir(osd_directory *dir)
 	dir->ent.type = get_attributes_stat(temp);
 	#endif
 	dir->ent.size = osd_get_file_size(temp);
+	dir->ent.modified = 0;
 	osd_free(temp);
 	return &dir->ent;
 }
@@ -34,6 +34,9 @@
 #endif
 
 #include <sys/stat.h>
+#ifndef SDLMAME_OS2
+#include <sys/mman.h>
+#endif
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -422,6 +425,44 @@ file_error osd_rmfile(const char *filename)
 	return FILERR_NONE;
 }
 
+//============================================================
+//  osd_map_file
+//============================================================
+
+file_error osd_map_file(const char *path, UINT64 length, void **base)
+{
+	*base = NULL;
+
+	#ifdef SDLMAME_OS2
+	return FILERR_FAILURE;
+	#else
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return error_to_file_error(errno);
+
+	// a private mapping gives writers their own copy of each page they touch
+	void *result = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	int err = errno;
+	close(fd);
+	if (result == MAP_FAILED)
+		return error_to_file_error(err);
+
+	*base = result;
+	return FILERR_NONE;
+	#endif
+}
+
+//============================================================
+//  osd_unmap_file
+//============================================================
+
+void osd_unmap_file(void *base, UINT64 length)
+{
+	#ifndef SDLMAME_OS2
+	munmap(base, length);
+	#endif
+}
+
 //============================================================
 //  create_path_recursive
 //============================================================
@@ -528,6 +569,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = ((char *) result) + sizeof(*result);
 	result->type = S_ISDIR(st.st_mode) ? ENTTYPE_DIR : ENTTYPE_FILE;
 	result->size = (UINT64)st.st_size;
+	result->modified = (UINT64)st.st_mtime;
 
 	return result;
 }
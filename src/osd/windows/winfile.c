@@ -333,6 +333,51 @@ done:
 }
 
 
+//============================================================
+//  osd_map_file
+//============================================================
+
+file_error osd_map_file(const char *path, UINT64 length, void **base)
+{
+	*base = NULL;
+
+	TCHAR *t_path = tstring_from_utf8(path);
+	if (t_path == NULL)
+		return FILERR_OUT_OF_MEMORY;
+	HANDLE file = CreateFile(t_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	osd_free(t_path);
+	if (file == INVALID_HANDLE_VALUE)
+		return win_error_to_file_error(GetLastError());
+
+	// a copy-on-write view gives writers their own copy of each page they touch
+	file_error filerr = FILERR_NONE;
+	HANDLE mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (mapping == NULL)
+		filerr = win_error_to_file_error(GetLastError());
+	else
+	{
+		*base = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, (SIZE_T)length);
+		if (*base == NULL)
+			filerr = win_error_to_file_error(GetLastError());
+
+		// the view keeps the mapping alive
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+	return filerr;
+}
+
+
+//============================================================
+//  osd_unmap_file
+//============================================================
+
+void osd_unmap_file(void *base, UINT64 length)
+{
+	UnmapViewOfFile(base);
+}
+
+
 //============================================================
 //  osd_get_physical_drive_geometry
 //============================================================
@@ -487,6 +532,7 @@ osd_directory_entry *osd_stat(const char *path)
 	result->name = ((char *) result) + sizeof(*result);
 	result->type = win_attributes_to_entry_type(find_data.dwFileAttributes);
 	result->size = find_data.nFileSizeLow | ((UINT64) find_data.nFileSizeHigh << 32);
+	result->modified = find_data.ftLastWriteTime.dwLowDateTime | ((UINT64) find_data.ftLastWriteTime.dwHighDateTime << 32);
 
 done:
 	if (t_path != NULL)
@@ -550,12 +550,13 @@ void windows_osd_interface::init(running_machine &machine)
 	// determine if we are benchmarking, and adjust options appropriately
 	int bench = options.bench();
 	astring error_string;
-	if (bench > 0)
+	if (bench > 0 || options.bench_frames() > 0)
 	{
 		options.set_value(OPTION_THROTTLE, false, OPTION_PRIORITY_MAXIMUM, error_string);
 		options.set_value(OSDOPTION_SOUND, "none", OPTION_PRIORITY_MAXIMUM, error_string);
 		options.set_value(OSDOPTION_VIDEO, "none", OPTION_PRIORITY_MAXIMUM, error_string);
-		options.set_value(OPTION_SECONDS_TO_RUN, bench, OPTION_PRIORITY_MAXIMUM, error_string);
+		if (bench > 0)
+			options.set_value(OPTION_SECONDS_TO_RUN, bench, OPTION_PRIORITY_MAXIMUM, error_string);
 		assert(!error_string);
 	}
 
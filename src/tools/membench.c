@@ -0,0 +1,816 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    membench.c
+
+    Memory system microbenchmark.
+
+****************************************************************************
+
+    This builds a tiny machine containing one address space for each
+    interesting combination of data bus width, endianness and address
+    bus width, and installs the same four regions in each of them:
+
+        0000-3FFF   RAM
+        4000-7FFF   ROM
+        8000-BFFF   a named bank
+        C000-FFFF   read/write handlers
+
+    Once the machine is running, every access path is timed against
+    every region, both walking sequentially and hopping around at
+    random, and the cost is reported in nanoseconds per access. The
+    direct_read_data opcode fetch path is timed against the regions it
+    supports. Finally, a watchpoint is set at the top of the handler
+    region, away from the RAM, and the native-width RAM accesses are
+    timed again, to measure the cost of the watchpoint lookup table.
+
+    The ROM region is left unmapped for writes, as a driver would leave
+    it, so writes to it measure the unmapped path. Logging of unmapped
+    accesses is turned off so that they don't measure log formatting
+    instead; the debugger, which is on for the watchpoints, would
+    otherwise leave it on.
+
+    Results can be written to a CSV file and compared against an
+    earlier run with -baseline; any measurement slower than its
+    baseline by more than the tolerance is reported, and the tool
+    exits with a non-zero result. Running once with the default and
+    once with -flatbits 22 compares the flat and two-level lookups on
+    the 22-bit space.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "emuopts.h"
+#include "drivenum.h"
+#include "osdepend.h"
+#include "debug/debugcpu.h"
+#include <ctype.h>
+
+
+
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+#define APPNAME                 "MAME"
+#define APPNAME_LOWER           "mame"
+#define CONFIGNAME              "mame"
+#define APPLONGNAME             "M.A.M.E."
+#define FULLLONGNAME            "Multiple Arcade Machine Emulator"
+#define CAPGAMENOUN             "GAME"
+#define CAPSTARTGAMENOUN        "Game"
+#define GAMENOUN                "game"
+#define GAMESNOUN               "games"
+#define COPYRIGHT               "Copyright Nicola Salmoria\nand the MAME team\nhttp://mamedev.org"
+#define COPYRIGHT_INFO          "Copyright Nicola Salmoria and the MAME team"
+#define DISCLAIMER              ""
+#define USAGE                   "Usage:  %s [%s] [options]"
+#define XML_ROOT                "mame"
+#define XML_TOP                 "game"
+#define STATE_MAGIC_NUM         "MAMESAVE"
+
+// layout of each address space
+const offs_t REGION_SIZE = 0x4000;
+const offs_t RAM_BASE = 0x0000;
+const offs_t ROM_BASE = 0x4000;
+const offs_t BANK_BASE = 0x8000;
+const offs_t HANDLER_BASE = 0xc000;
+const offs_t WATCH_ADDRESS = 0xfff0;
+
+// number of distinct addresses in each pattern
+const int ADDRESS_COUNT = 1024;
+
+// number of times each measurement is repeated; the best one is kept
+const int TRIALS = 3;
+
+// default number of accesses per measurement
+const UINT32 DEFAULT_ACCESSES = 1 << 18;
+
+// default tolerance for baseline comparisons, in percent
+const int DEFAULT_TOLERANCE = 10;
+
+
+
+//**************************************************************************
+//  TYPE DEFINITIONS
+//**************************************************************************
+
+// access operations
+enum
+{
+	OP_READ_BYTE,
+	OP_READ_WORD,
+	OP_READ_DWORD,
+	OP_READ_QWORD,
+	OP_WRITE_BYTE,
+	OP_WRITE_WORD,
+	OP_WRITE_DWORD,
+	OP_WRITE_QWORD,
+	OP_READ_DWORD_UNALIGNED,
+	OP_WRITE_DWORD_UNALIGNED,
+	OP_FETCH_BYTE,
+	OP_FETCH_WORD,
+	OP_FETCH_DWORD,
+	OP_FETCH_QWORD
+};
+
+
+// description of a single access operation
+struct operation_info
+{
+	const char *    name;           // name used in the results
+	int             size;           // size of each access in bytes
+	bool            fetch;          // true if this goes through direct_read_data
+	bool            unaligned;      // true if the addresses are deliberately misaligned
+	UINT64          (*execute)(address_space &space, const offs_t *addrlist, int count, int passes);
+};
+
+
+// a single measurement
+struct bench_result
+{
+	char            name[64];       // space,region,operation,pattern
+	double          nsec;           // nanoseconds per access
+};
+
+
+// a region within each space
+struct region_info
+{
+	const char *    name;           // name used in the results
+	offs_t          base;           // base address
+	bool            fetchable;      // true if opcode fetches make sense here
+};
+
+
+// command line options
+struct bench_options
+{
+	UINT32          accesses;       // accesses per measurement
+	const char *    csvname;        // file to write results to
+	const char *    baselinename;   // file to compare results against
+	int             tolerance;      // allowable slowdown, in percent
+	bool            watchpoints;    // measure the watchpoint path
+	int             flatbits;       // -mem_flat_bits to run with, or -1 for the default
+};
+
+
+
+//**************************************************************************
+//  GLOBAL VARIABLES
+//**************************************************************************
+
+static bench_options s_options;
+static dynamic_array<bench_result> s_results;
+static volatile UINT64 s_sink;
+
+static const region_info s_regions[] =
+{
+	{ "ram",        RAM_BASE,       true },
+	{ "rom",        ROM_BASE,       true },
+	{ "bank",       BANK_BASE,      true },
+	{ "handler",    HANDLER_BASE,   false }
+};
+
+
+
+//**************************************************************************
+//  EMULATOR INFO
+//**************************************************************************
+
+const char * emulator_info::get_appname() { return APPNAME;}
+const char * emulator_info::get_appname_lower() { return APPNAME_LOWER;}
+const char * emulator_info::get_configname() { return CONFIGNAME;}
+const char * emulator_info::get_applongname() { return APPLONGNAME;}
+const char * emulator_info::get_fulllongname() { return FULLLONGNAME;}
+const char * emulator_info::get_capgamenoun() { return CAPGAMENOUN;}
+const char * emulator_info::get_capstartgamenoun() { return CAPSTARTGAMENOUN;}
+const char * emulator_info::get_gamenoun() { return GAMENOUN;}
+const char * emulator_info::get_gamesnoun() { return GAMESNOUN;}
+const char * emulator_info::get_copyright() { return COPYRIGHT;}
+const char * emulator_info::get_copyright_info() { return COPYRIGHT_INFO;}
+const char * emulator_info::get_disclaimer() { return DISCLAIMER;}
+const char * emulator_info::get_usage() { return USAGE;}
+const char * emulator_info::get_xml_root() { return XML_ROOT;}
+const char * emulator_info::get_xml_top() { return XML_TOP;}
+const char * emulator_info::get_state_magic_num() { return STATE_MAGIC_NUM;}
+void emulator_info::printf_usage(const char *par1, const char *par2) { osd_printf_info(USAGE, par1, par2); }
+
+
+
+//**************************************************************************
+//  ACCESS LOOPS
+//**************************************************************************
+
+//-------------------------------------------------
+//  run_accesses - perform one kind of access over
+//  a list of addresses, several times over
+//-------------------------------------------------
+
+template<int _Operation>
+static UINT64 run_accesses(address_space &space, const offs_t *addrlist, int count, int passes)
+{
+	direct_read_data &direct = space.direct();
+	UINT64 sum = 0;
+
+	for (int pass = 0; pass < passes; pass++)
+		for (int index = 0; index < count; index++)
+		{
+			offs_t address = addrlist[index];
+			switch (_Operation)
+			{
+				case OP_READ_BYTE:              sum += space.read_byte(address);                            break;
+				case OP_READ_WORD:              sum += space.read_word(address);                            break;
+				case OP_READ_DWORD:             sum += space.read_dword(address);                           break;
+				case OP_READ_QWORD:             sum += space.read_qword(address);                           break;
+				case OP_WRITE_BYTE:             space.write_byte(address, (UINT8)index);                    break;
+				case OP_WRITE_WORD:             space.write_word(address, (UINT16)index);                   break;
+				case OP_WRITE_DWORD:            space.write_dword(address, (UINT32)index);                  break;
+				case OP_WRITE_QWORD:            space.write_qword(address, (UINT64)index);                  break;
+				case OP_READ_DWORD_UNALIGNED:   sum += space.read_dword_unaligned(address);                 break;
+				case OP_WRITE_DWORD_UNALIGNED:  space.write_dword_unaligned(address, (UINT32)index);        break;
+				case OP_FETCH_BYTE:             sum += direct.read_decrypted_byte(address);                 break;
+				case OP_FETCH_WORD:             sum += direct.read_decrypted_word(address);                 break;
+				case OP_FETCH_DWORD:            sum += direct.read_decrypted_dword(address);                break;
+				case OP_FETCH_QWORD:            sum += direct.read_decrypted_qword(address);                break;
+			}
+		}
+	return sum;
+}
+
+
+static const operation_info s_operations[] =
+{
+	{ "read_byte",              1, false, false, run_accesses<OP_READ_BYTE> },
+	{ "read_word",              2, false, false, run_accesses<OP_READ_WORD> },
+	{ "read_dword",             4, false, false, run_accesses<OP_READ_DWORD> },
+	{ "read_qword",             8, false, false, run_accesses<OP_READ_QWORD> },
+	{ "write_byte",             1, false, false, run_accesses<OP_WRITE_BYTE> },
+	{ "write_word",             2, false, false, run_accesses<OP_WRITE_WORD> },
+	{ "write_dword",            4, false, false, run_accesses<OP_WRITE_DWORD> },
+	{ "write_qword",            8, false, false, run_accesses<OP_WRITE_QWORD> },
+	{ "read_dword_unaligned",   4, false, true,  run_accesses<OP_READ_DWORD_UNALIGNED> },
+	{ "write_dword_unaligned",  4, false, true,  run_accesses<OP_WRITE_DWORD_UNALIGNED> },
+	{ "fetch_byte",             1, true,  false, run_accesses<OP_FETCH_BYTE> },
+	{ "fetch_word",             2, true,  false, run_accesses<OP_FETCH_WORD> },
+	{ "fetch_dword",            4, true,  false, run_accesses<OP_FETCH_DWORD> },
+	{ "fetch_qword",            8, true,  false, run_accesses<OP_FETCH_QWORD> }
+};
+
+
+//-------------------------------------------------
+//  build_addresses - fill in a list of addresses
+//  within a region, either sequential or random
+//-------------------------------------------------
+
+static void build_addresses(offs_t *addrlist, offs_t base, int size, bool israndom, bool unaligned)
+{
+	// leave room at the end for the widest, misaligned access
+	UINT32 slots = (REGION_SIZE - 8) / size;
+	UINT32 seed = 0x9d14abd7;
+
+	for (int index = 0; index < ADDRESS_COUNT; index++)
+	{
+		UINT32 slot;
+		if (israndom)
+		{
+			seed = seed * 1103515245 + 12345;
+			slot = (seed >> 8) % slots;
+		}
+		else
+			slot = index % slots;
+		addrlist[index] = base + slot * size + (unaligned ? 1 : 0);
+	}
+}
+
+
+//-------------------------------------------------
+//  measure - time a single operation and record
+//  the result
+//-------------------------------------------------
+
+static void measure(address_space &space, const char *spacename, const char *regionname, const operation_info &op, bool israndom, const offs_t *addrlist)
+{
+	int passes = MAX(1, s_options.accesses / ADDRESS_COUNT);
+
+	// keep the best of a few trials, to filter out interruptions
+	osd_ticks_t best = 0;
+	for (int trial = 0; trial < TRIALS; trial++)
+	{
+		osd_ticks_t start = osd_ticks();
+		s_sink += (*op.execute)(space, addrlist, ADDRESS_COUNT, passes);
+		osd_ticks_t elapsed = osd_ticks() - start;
+		if (trial == 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	bench_result &result = s_results.append();
+	snprintf(result.name, ARRAY_LENGTH(result.name), "%s,%s,%s,%s", spacename, regionname, op.name, israndom ? "random" : "sequential");
+	result.nsec = (double)best * 1.0e9 / (double)osd_ticks_per_second() / ((double)passes * ADDRESS_COUNT);
+	printf("%-56s %8.2f ns\n", result.name, result.nsec);
+}
+
+
+
+//**************************************************************************
+//  BENCHMARK BUS DEVICE
+//**************************************************************************
+
+#define MCFG_MEMBENCH_BUS_ADD(_tag, _databus_width, _endianness, _addrbus_width) \
+	MCFG_DEVICE_ADD(_tag, MEMBENCH_BUS, 0) \
+	membench_bus_device::static_set_bus(*device, _databus_width, _endianness, _addrbus_width);
+
+
+// ======================> membench_bus_device
+
+class membench_bus_device : public device_t,
+							public device_memory_interface
+{
+public:
+	// construction/destruction
+	membench_bus_device(const machine_config &mconfig, const char *tag, device_t *owner, UINT32 clock);
+
+	// static configuration
+	static void static_set_bus(device_t &device, UINT8 databus_width, endianness_t endianness, UINT8 addrbus_width);
+
+	// run all the measurements on our space
+	void run_benchmarks();
+
+	// handlers
+	DECLARE_READ8_MEMBER(read8) { return offset; }
+	DECLARE_READ16_MEMBER(read16) { return offset; }
+	DECLARE_READ32_MEMBER(read32) { return offset; }
+	DECLARE_READ64_MEMBER(read64) { return offset; }
+	DECLARE_WRITE8_MEMBER(write8) { m_latch = data; }
+	DECLARE_WRITE16_MEMBER(write16) { m_latch = data; }
+	DECLARE_WRITE32_MEMBER(write32) { m_latch = data; }
+	DECLARE_WRITE64_MEMBER(write64) { m_latch = data; }
+
+protected:
+	// device-level overrides
+	virtual void device_config_complete();
+	virtual void device_start();
+
+	// device_memory_interface overrides
+	virtual const address_space_config *memory_space_config(address_spacenum spacenum = AS_0) const { return (spacenum == AS_PROGRAM) ? &m_space_config : NULL; }
+
+private:
+	// internal state
+	UINT8                   m_databus_width;
+	endianness_t            m_endianness;
+	UINT8                   m_addrbus_width;
+	address_space_config    m_space_config;
+	astring                 m_banktag;
+	dynamic_buffer          m_ram;
+	dynamic_buffer          m_rom;
+	dynamic_buffer          m_bankdata;
+	UINT64                  m_latch;
+};
+
+
+// device type definition
+extern const device_type MEMBENCH_BUS;
+const device_type MEMBENCH_BUS = &device_creator<membench_bus_device>;
+
+
+//-------------------------------------------------
+//  membench_bus_device - constructor
+//-------------------------------------------------
+
+membench_bus_device::membench_bus_device(const machine_config &mconfig, const char *tag, device_t *owner, UINT32 clock)
+	: device_t(mconfig, MEMBENCH_BUS, "Benchmark Bus", tag, owner, clock, "membench_bus", __FILE__),
+		device_memory_interface(mconfig, *this),
+		m_databus_width(8),
+		m_endianness(ENDIANNESS_LITTLE),
+		m_addrbus_width(16),
+		m_latch(0)
+{
+}
+
+
+//-------------------------------------------------
+//  static_set_bus - configure the shape of our
+//  address space
+//-------------------------------------------------
+
+void membench_bus_device::static_set_bus(device_t &device, UINT8 databus_width, endianness_t endianness, UINT8 addrbus_width)
+{
+	membench_bus_device &bus = downcast<membench_bus_device &>(device);
+	bus.m_databus_width = databus_width;
+	bus.m_endianness = endianness;
+	bus.m_addrbus_width = addrbus_width;
+}
+
+
+//-------------------------------------------------
+//  device_config_complete - build our space
+//  configuration from the static settings
+//-------------------------------------------------
+
+void membench_bus_device::device_config_complete()
+{
+	m_space_config = address_space_config("program", m_endianness, m_databus_width, m_addrbus_width);
+}
+
+
+//-------------------------------------------------
+//  device_start - install the regions
+//-------------------------------------------------
+
+void membench_bus_device::device_start()
+{
+	address_space &space = this->space(AS_PROGRAM);
+
+	// fill the backing memory with something other than zeroes
+	m_ram.resize(REGION_SIZE);
+	m_rom.resize(REGION_SIZE);
+	m_bankdata.resize(REGION_SIZE);
+	for (int offset = 0; offset < REGION_SIZE; offset++)
+		m_ram[offset] = m_rom[offset] = m_bankdata[offset] = offset ^ (offset >> 8);
+
+	// writes to the ROM are unmapped; don't let logging them swamp the timing
+	space.set_log_unmap(false);
+
+	// RAM and ROM
+	space.install_ram(RAM_BASE, RAM_BASE + REGION_SIZE - 1, m_ram);
+	space.install_rom(ROM_BASE, ROM_BASE + REGION_SIZE - 1, m_rom);
+
+	// a named bank
+	m_banktag.cpy(basetag()).cat("_bank");
+	space.install_readwrite_bank(BANK_BASE, BANK_BASE + REGION_SIZE - 1, m_banktag);
+	owner()->membank(m_banktag)->set_base(m_bankdata);
+
+	// handlers at the native width
+	switch (m_databus_width)
+	{
+		case 8:
+			space.install_readwrite_handler(HANDLER_BASE, HANDLER_BASE + REGION_SIZE - 1, read8_delegate(FUNC(membench_bus_device::read8), this), write8_delegate(FUNC(membench_bus_device::write8), this));
+			break;
+
+		case 16:
+			space.install_readwrite_handler(HANDLER_BASE, HANDLER_BASE + REGION_SIZE - 1, read16_delegate(FUNC(membench_bus_device::read16), this), write16_delegate(FUNC(membench_bus_device::write16), this));
+			break;
+
+		case 32:
+			space.install_readwrite_handler(HANDLER_BASE, HANDLER_BASE + REGION_SIZE - 1, read32_delegate(FUNC(membench_bus_device::read32), this), write32_delegate(FUNC(membench_bus_device::write32), this));
+			break;
+
+		case 64:
+			space.install_readwrite_handler(HANDLER_BASE, HANDLER_BASE + REGION_SIZE - 1, read64_delegate(FUNC(membench_bus_device::read64), this), write64_delegate(FUNC(membench_bus_device::write64), this));
+			break;
+	}
+
+	save_item(NAME(m_latch));
+}
+
+
+//-------------------------------------------------
+//  run_benchmarks - time every operation on every
+//  region of our space
+//-------------------------------------------------
+
+void membench_bus_device::run_benchmarks()
+{
+	address_space &space = this->space(AS_PROGRAM);
+	offs_t addrlist[ADDRESS_COUNT];
+
+	// name the space after its shape
+	char spacename[32];
+	snprintf(spacename, ARRAY_LENGTH(spacename), "%d%s-a%d", m_databus_width, (m_endianness == ENDIANNESS_LITTLE) ? "le" : "be", m_addrbus_width);
+
+	// every operation on every region, both patterns
+	for (int regnum = 0; regnum < ARRAY_LENGTH(s_regions); regnum++)
+	{
+		const region_info &region = s_regions[regnum];
+		for (int opnum = 0; opnum < ARRAY_LENGTH(s_operations); opnum++)
+		{
+			const operation_info &op = s_operations[opnum];
+			if (op.fetch && !region.fetchable)
+				continue;
+
+			for (int israndom = 0; israndom < 2; israndom++)
+			{
+				build_addresses(addrlist, region.base, op.size, israndom, op.unaligned);
+				measure(space, spacename, region.name, op, israndom, addrlist);
+			}
+		}
+	}
+
+	// then the native-width RAM accesses again, with watchpoints enabled
+	if (s_options.watchpoints && debug() != NULL)
+	{
+		int wpnum = debug()->watchpoint_set(space, WATCHPOINT_READWRITE, WATCH_ADDRESS, 1, NULL, NULL);
+		for (int opnum = 0; opnum < ARRAY_LENGTH(s_operations); opnum++)
+		{
+			const operation_info &op = s_operations[opnum];
+			if (op.fetch || op.unaligned || op.size != m_databus_width / 8)
+				continue;
+
+			for (int israndom = 0; israndom < 2; israndom++)
+			{
+				build_addresses(addrlist, RAM_BASE, op.size, israndom, false);
+				measure(space, spacename, "ram+watchpoint", op, israndom, addrlist);
+			}
+		}
+		debug()->watchpoint_clear(wpnum);
+	}
+}
+
+
+
+//**************************************************************************
+//  DRIVER
+//**************************************************************************
+
+class membench_state : public driver_device
+{
+public:
+	// constructor
+	membench_state(const machine_config &mconfig, device_type type, const char *tag)
+		: driver_device(mconfig, type, tag)
+	{
+	}
+
+	virtual void machine_start()
+	{
+		// run once everything has been started and reset
+		machine().scheduler().timer_set(attotime::zero, timer_expired_delegate(FUNC(membench_state::run_benchmarks), this));
+	}
+
+	TIMER_CALLBACK_MEMBER(run_benchmarks)
+	{
+		device_iterator iter(machine().root_device());
+		for (device_t *device = iter.first(); device != NULL; device = iter.next())
+		{
+			membench_bus_device *bus = dynamic_cast<membench_bus_device *>(device);
+			if (bus != NULL)
+				bus->run_benchmarks();
+		}
+		machine().schedule_exit();
+	}
+};
+
+
+static MACHINE_CONFIG_START( membench, membench_state )
+
+	// spaces small enough for a flat lookup table at the default -mem_flat_bits
+	MCFG_MEMBENCH_BUS_ADD("bus8le_a16", 8, ENDIANNESS_LITTLE, 16)
+	MCFG_MEMBENCH_BUS_ADD("bus16be_a20", 16, ENDIANNESS_BIG, 20)
+
+	// spaces that need a two-level lookup, unless -flatbits says otherwise
+	MCFG_MEMBENCH_BUS_ADD("bus8le_a22", 8, ENDIANNESS_LITTLE, 22)
+	MCFG_MEMBENCH_BUS_ADD("bus8le_a24", 8, ENDIANNESS_LITTLE, 24)
+	MCFG_MEMBENCH_BUS_ADD("bus8be_a24", 8, ENDIANNESS_BIG, 24)
+	MCFG_MEMBENCH_BUS_ADD("bus16le_a24", 16, ENDIANNESS_LITTLE, 24)
+	MCFG_MEMBENCH_BUS_ADD("bus16be_a24", 16, ENDIANNESS_BIG, 24)
+	MCFG_MEMBENCH_BUS_ADD("bus32le_a32", 32, ENDIANNESS_LITTLE, 32)
+	MCFG_MEMBENCH_BUS_ADD("bus32be_a32", 32, ENDIANNESS_BIG, 32)
+	MCFG_MEMBENCH_BUS_ADD("bus64le_a32", 64, ENDIANNESS_LITTLE, 32)
+	MCFG_MEMBENCH_BUS_ADD("bus64be_a32", 64, ENDIANNESS_BIG, 32)
+MACHINE_CONFIG_END
+
+
+ROM_START( membench )
+ROM_END
+
+
+GAME( 2015, membench, 0, membench, 0, driver_device, 0, ROT0, "MAME", "Memory system benchmark", GAME_NO_SOUND )
+
+
+// our driver list: just the empty driver and ourselves, sorted by name
+GAME_EXTERN(___empty);
+
+const game_driver * const driver_list::s_drivers_sorted[2] =
+{
+	&GAME_NAME(___empty),
+	&GAME_NAME(membench),
+};
+
+int driver_list::s_driver_count = 2;
+
+
+
+//**************************************************************************
+//  MINIMAL OSD INTERFACE
+//**************************************************************************
+
+class membench_osd_interface : public osd_interface, public osd_output
+{
+public:
+	// general overridables
+	virtual void init(running_machine &machine) { }
+	virtual void update(bool skip_redraw) { }
+
+	// debugger overridables
+	virtual void init_debugger() { }
+	virtual void wait_for_debugger(device_t &device, bool firststop) { }
+
+	// audio overridables
+	virtual void update_audio_stream(const INT16 *buffer, int samples_this_frame) { }
+	virtual void set_mastervolume(int attenuation) { }
+	virtual bool no_sound() { return true; }
+
+	// input overridables
+	virtual void customize_input_type_list(simple_list<input_type_entry> &typelist) { }
+
+	// video overridables
+	virtual void *get_slider_list() { return NULL; }
+
+	// font interface
+	virtual osd_font *font_alloc() { return NULL; }
+
+	// command option overrides
+	virtual bool execute_command(const char *command) { return false; }
+
+	// midi interface
+	virtual osd_midi_device *create_midi_device() { return NULL; }
+
+	// output; only errors and warnings are interesting
+	virtual void output_callback(osd_output_channel channel, const char *msg, va_list args)
+	{
+		if (channel == OSD_OUTPUT_CHANNEL_ERROR || channel == OSD_OUTPUT_CHANNEL_WARNING)
+			vfprintf(stderr, msg, args);
+	}
+};
+
+
+
+//**************************************************************************
+//  RESULTS
+//**************************************************************************
+
+//-------------------------------------------------
+//  write_results - write all the results out as
+//  CSV
+//-------------------------------------------------
+
+static int write_results(const char *filename)
+{
+	FILE *file = fopen(filename, "w");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error opening output file '%s'\n", filename);
+		return 1;
+	}
+
+	fprintf(file, "space,region,operation,pattern,ns\n");
+	for (int index = 0; index < s_results.count(); index++)
+		fprintf(file, "%s,%.3f\n", s_results[index].name, s_results[index].nsec);
+	fclose(file);
+	return 0;
+}
+
+
+//-------------------------------------------------
+//  compare_baseline - compare the results to an
+//  earlier run; returns the number of
+//  regressions found
+//-------------------------------------------------
+
+static int compare_baseline(const char *filename, int tolerance)
+{
+	FILE *file = fopen(filename, "r");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Error opening baseline file '%s'\n", filename);
+		return 1;
+	}
+
+	int regressions = 0;
+	int compared = 0;
+	char line[256];
+	while (fgets(line, ARRAY_LENGTH(line), file) != NULL)
+	{
+		// the measurement is everything after the last comma
+		char *comma = strrchr(line, ',');
+		if (comma == NULL)
+			continue;
+		*comma = 0;
+		double basensec;
+		if (sscanf(comma + 1, "%lf", &basensec) != 1 || basensec <= 0)
+			continue;
+
+		// find the matching result
+		for (int index = 0; index < s_results.count(); index++)
+			if (strcmp(s_results[index].name, line) == 0)
+			{
+				double change = (s_results[index].nsec - basensec) * 100.0 / basensec;
+				if (change > tolerance)
+				{
+					printf("REGRESSION: %-56s %8.2f ns -> %8.2f ns (%+.1f%%)\n", line, basensec, s_results[index].nsec, change);
+					regressions++;
+				}
+				compared++;
+				break;
+			}
+	}
+	fclose(file);
+
+	printf("%d measurements compared against baseline, %d regressions beyond %d%%\n", compared, regressions, tolerance);
+	return regressions;
+}
+
+
+
+//**************************************************************************
+//  MAIN
+//**************************************************************************
+
+//-------------------------------------------------
+//  parse_options - parse the command line
+//-------------------------------------------------
+
+static int parse_options(int argc, char *argv[], bench_options *opts)
+{
+	opts->accesses = DEFAULT_ACCESSES;
+	opts->csvname = NULL;
+	opts->baselinename = NULL;
+	opts->tolerance = DEFAULT_TOLERANCE;
+	opts->watchpoints = true;
+	opts->flatbits = -1;
+
+	for (int arg = 1; arg < argc; arg++)
+	{
+		const char *curarg = argv[arg];
+		const char *nextarg = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+		if (core_stricmp(curarg, "-output") == 0 && nextarg != NULL)
+			opts->csvname = argv[++arg];
+		else if (core_stricmp(curarg, "-baseline") == 0 && nextarg != NULL)
+			opts->baselinename = argv[++arg];
+		else if (core_stricmp(curarg, "-tolerance") == 0 && nextarg != NULL && sscanf(nextarg, "%d", &opts->tolerance) == 1)
+			arg++;
+		else if (core_stricmp(curarg, "-accesses") == 0 && nextarg != NULL && sscanf(nextarg, "%u", &opts->accesses) == 1)
+			arg++;
+		else if (core_stricmp(curarg, "-nowatchpoints") == 0)
+			opts->watchpoints = false;
+		else if (core_stricmp(curarg, "-flatbits") == 0 && nextarg != NULL && sscanf(nextarg, "%d", &opts->flatbits) == 1)
+			arg++;
+		else
+			goto usage;
+	}
+	return 0;
+
+usage:
+	fprintf(stderr,
+		"Usage:\n"
+		"   membench [-output <file.csv>] [-baseline <file.csv>] [-tolerance <percent>]\n"
+		"            [-accesses <count>] [-nowatchpoints] [-flatbits <bits>]\n"
+		"\n"
+		"   -output        write the results to a CSV file\n"
+		"   -baseline      compare the results to a CSV file from an earlier run\n"
+		"   -tolerance     percentage slowdown allowed before a regression is reported (default %d)\n"
+		"   -accesses      number of accesses per measurement (default %d)\n"
+		"   -nowatchpoints skip the watchpoint measurements\n"
+		"   -flatbits      widest address space given a flat lookup table (default: -mem_flat_bits)\n",
+		DEFAULT_TOLERANCE, DEFAULT_ACCESSES);
+	return 1;
+}
+
+
+//-------------------------------------------------
+//  main - main entry point
+//-------------------------------------------------
+
+int CLIB_DECL main(int argc, char *argv[])
+{
+	if (parse_options(argc, argv, &s_options) != 0)
+		return 1;
+
+	// run our machine, with the debugger enabled so that watchpoints work, and no intrusions
+	emu_options options;
+	astring errors;
+	options.set_value(OPTION_READCONFIG, 0, OPTION_PRIORITY_CMDLINE, errors);
+	options.set_value(OPTION_SKIP_GAMEINFO, 1, OPTION_PRIORITY_CMDLINE, errors);
+	options.set_value(OPTION_THROTTLE, 0, OPTION_PRIORITY_CMDLINE, errors);
+	options.set_value(OPTION_DEBUG, s_options.watchpoints ? 1 : 0, OPTION_PRIORITY_CMDLINE, errors);
+	if (s_options.flatbits >= 0)
+		options.set_value(OPTION_MEM_FLAT_BITS, s_options.flatbits, OPTION_PRIORITY_CMDLINE, errors);
+	options.set_system_name("membench");
+
+	membench_osd_interface osd;
+	osd_output::push(&osd);
+	int result;
+	try
+	{
+		machine_manager *manager = machine_manager::instance(options, osd);
+		result = manager->execute();
+		global_free(manager);
+	}
+	catch (emu_fatalerror &fatal)
+	{
+		fprintf(stderr, "%s\n", fatal.string());
+		result = MAMERR_FATALERROR;
+	}
+	osd_output::pop(&osd);
+	if (result != MAMERR_NONE)
+		return result;
+
+	// write out and compare the results
+	if (s_options.csvname != NULL && write_results(s_options.csvname) != 0)
+		return 1;
+	if (s_options.baselinename != NULL && compare_baseline(s_options.baselinename, s_options.tolerance) != 0)
+		return 1;
+	return 0;
+}
@@ -81,6 +81,7 @@ struct options_entry oplist[] =
 {
 	{ "time_to_run;t",   "1.0", OPTION_FLOAT,   "time to run the emulation (seconds)" },
 	{ "logs;l",          "",    OPTION_STRING,  "colon separated list of terminals to log" },
+	{ "params;p",        "",    OPTION_STRING,  "colon separated list of parameter=value overrides, e.g. Solver.SPARSE_THRESHOLD=0" },
 	{ "f",               "-",   OPTION_STRING,  "file to process (default is stdin)" },
 	{ "listdevices;ld",  "",    OPTION_BOOLEAN, "list all devices available for use" },
 	{ "help;h",          "0",   OPTION_BOOLEAN, "display help" },
@@ -135,7 +136,7 @@ class netlist_tool_t : public netlist_base_t
 public:
 
 	netlist_tool_t()
-	: netlist_base_t(), m_logs(""), m_setup(NULL)
+	: netlist_base_t(), m_logs(""), m_params(""), m_setup(NULL)
 	{
 	}
 
@@ -158,6 +159,7 @@ public:
 		sources.parse(*m_setup,"");
 		//m_setup->parse(buffer);
 		log_setup();
+		param_setup();
 
 		// start devices
 		m_setup->start_devices();
@@ -178,7 +180,20 @@ public:
 		}
 	}
 
+	void param_setup()
+	{
+		nl_util::pstring_list ll = nl_util::split(m_params, ":");
+		for (int i=0; i < ll.count(); i++)
+		{
+			int eq = ll[i].find('=');
+			if (eq <= 0)
+				this->error("Parameter override %s is not of the form name=value\n", ll[i].cstr());
+			m_setup->override_param(ll[i].substr(0, eq), ll[i].substr(eq + 1));
+		}
+	}
+
 	pstring m_logs;
+	pstring m_params;
 protected:
 
 	void verror(const loglevel_e level, const char *format, va_list ap) const
@@ -222,6 +237,7 @@ static void run(core_options &opts)
 
 	nt.init();
 	nt.m_logs = opts.value("l");
+	nt.m_params = opts.value("p");
 	nt.read_netlist(filetobuf(opts.value("f")));
 	double ttr = opts.float_value("t");
 
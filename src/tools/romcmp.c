@@ -494,6 +494,9 @@ static int load_files(int i, int *found, const char *path)
 	/* if not, try to open as a ZIP file */
 	else
 	{
+		static zip_file_request requests[MAX_FILES + 1];
+		static fileinfo *reqfiles[MAX_FILES + 1];
+		int numrequests = 0, reqnum;
 		zip_file *zip;
 		const zip_file_header* zipent;
 		zip_error ziperr;
@@ -530,11 +533,11 @@ static int load_files(int i, int *found, const char *path)
 					printf("%s: out of memory!\n",file->name);
 				else
 				{
-					if (zip_file_decompress(zip, (char *)file->buf, file->size) != ZIPERR_NONE)
-					{
-						free(file->buf);
-						file->buf = 0;
-					}
+					/* decompress everything at once below */
+					requests[numrequests].header = zipent;
+					requests[numrequests].buffer = file->buf;
+					requests[numrequests].length = file->size;
+					reqfiles[numrequests++] = file;
 				}
 
 				file->listed = 0;
@@ -546,6 +549,15 @@ static int load_files(int i, int *found, const char *path)
 				found[i]++;
 			}
 		}
+
+		/* decompress all the files in parallel, and drop any that failed */
+		zip_file_decompress_multiple(zip, requests, numrequests);
+		for (reqnum = 0; reqnum < numrequests; reqnum++)
+			if (requests[reqnum].error != ZIPERR_NONE)
+			{
+				free(reqfiles[reqnum]->buf);
+				reqfiles[reqnum]->buf = 0;
+			}
 		zip_file_close(zip);
 	}
 	return 0;
@@ -0,0 +1,210 @@
+// license:BSD-3-Clause
+// copyright-holders:MAME contributors
+/***************************************************************************
+
+    sndbench.c
+
+    Sound resampling and mixing microbenchmark.
+
+****************************************************************************
+
+    This times the kernels in src/emu/resample.h that sound_stream and
+    the mixers use, on their own, outside of any machine. For each pair
+    of input and output sample rates, one stream's worth of audio is
+    converted with the linear and the band-limited resamplers, with a
+    non-unity gain applied afterwards, and the result is reported as
+    millions of output samples per second for a single stream. The
+    mixing and final clamp/interleave steps are timed the same way.
+
+    Each measurement is the best of several trials. Pass a number of
+    seconds of audio per trial on the command line to override the
+    default.
+
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "osdcore.h"
+#include "resample.h"
+
+
+
+//**************************************************************************
+//  CONSTANTS
+//**************************************************************************
+
+#define DEFAULT_SECONDS         10
+#define TRIALS                  5
+#define OUTPUT_RATE             48000
+#define CHUNK_SAMPLES           (OUTPUT_RATE / 50)
+
+// input rates to test: some common chip rates either side of the output
+static const int input_rates[] =
+{
+	8000,       // low-rate PCM
+	22050,
+	44100,
+	48000,      // no conversion
+	55930,      // YM2151 at 3.579545MHz
+	96000,
+	192000      // the limit for the band-limited filter
+};
+
+
+
+//**************************************************************************
+//  BENCHMARKS
+//**************************************************************************
+
+//-------------------------------------------------
+//  rate - convert a sample count and elapsed
+//  ticks to millions of samples per second
+//-------------------------------------------------
+
+static double rate(UINT64 samples, osd_ticks_t ticks)
+{
+	return (ticks == 0) ? 0.0 : double(samples) * double(osd_ticks_per_second()) / double(ticks) / 1000000.0;
+}
+
+
+//-------------------------------------------------
+//  time_resample - time converting the given
+//  number of seconds of audio from one rate to
+//  the output rate, in chunks the size of one
+//  sound update
+//-------------------------------------------------
+
+static osd_ticks_t time_resample(const INT32 *source, INT32 *dest, int inrate, int seconds, const float *filter, int taps)
+{
+	UINT32 step = (UINT64(inrate) << RESAMPLE_FRAC_BITS) / OUTPUT_RATE;
+	int history = (taps == 0) ? 0 : taps / 2 - 1;
+	osd_ticks_t best = 0;
+
+	for (int trial = 0; trial < TRIALS; trial++)
+	{
+		osd_ticks_t start = osd_ticks();
+		for (int chunk = 0; chunk < seconds * 50; chunk++)
+		{
+			// the source buffer is one second long, so wrap around within it
+			UINT32 basefrac = (UINT64(chunk % 50) * CHUNK_SAMPLES * step) & RESAMPLE_FRAC_MASK;
+			const INT32 *base = &source[history + ((UINT64(chunk % 50) * CHUNK_SAMPLES * step) >> RESAMPLE_FRAC_BITS)];
+			if (taps == 0)
+				stream_resample_linear(dest, base, CHUNK_SAMPLES, basefrac, step);
+			else
+				stream_resample_bandlimited(dest, base - history, CHUNK_SAMPLES, basefrac, step, filter, taps);
+			stream_scale_samples(dest, CHUNK_SAMPLES, 0xc0);
+		}
+		osd_ticks_t elapsed = osd_ticks() - start;
+		if (trial == 0 || elapsed < best)
+			best = elapsed;
+	}
+	return best;
+}
+
+
+//-------------------------------------------------
+//  time_mix - time adding one stream into a mix
+//  and clamping and interleaving the result
+//-------------------------------------------------
+
+static void time_mix(const INT32 *source, INT32 *left, INT32 *right, INT16 *final, int seconds, osd_ticks_t &addticks, osd_ticks_t &clampticks)
+{
+	addticks = clampticks = 0;
+	for (int trial = 0; trial < TRIALS; trial++)
+	{
+		osd_ticks_t add = 0, clamp = 0;
+		for (int chunk = 0; chunk < seconds * 50; chunk++)
+		{
+			const INT32 *base = &source[(chunk % 50) * CHUNK_SAMPLES];
+			osd_ticks_t start = osd_ticks();
+			stream_add_samples(left, base, CHUNK_SAMPLES);
+			stream_add_samples(right, base, CHUNK_SAMPLES);
+			osd_ticks_t mid = osd_ticks();
+			stream_clamp_interleave(final, left, right, CHUNK_SAMPLES);
+			clamp += osd_ticks() - mid;
+			add += mid - start;
+		}
+		if (trial == 0 || add < addticks)
+			addticks = add;
+		if (trial == 0 || clamp < clampticks)
+			clampticks = clamp;
+	}
+}
+
+
+
+//**************************************************************************
+//  MAIN
+//**************************************************************************
+
+//-------------------------------------------------
+//  main - main entry point
+//-------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	int seconds = (argc > 1) ? atoi(argv[1]) : DEFAULT_SECONDS;
+	if (argc > 2 || seconds <= 0)
+	{
+		fprintf(stderr, "Usage:\n  sndbench [<seconds per trial>]\n");
+		return 1;
+	}
+
+	// one second of source audio at the highest rate, with room for the filter on either side
+	int maxrate = input_rates[ARRAY_LENGTH(input_rates) - 1];
+	int sourcecount = maxrate + 2 * RESAMPLE_MAX_TAPS * 2;
+	INT32 *source = new INT32[sourcecount];
+	for (int index = 0; index < sourcecount; index++)
+		source[index] = (rand() & 0xffff) - 0x8000;
+	INT32 *dest = new INT32[CHUNK_SAMPLES];
+	float *filter = new float[RESAMPLE_PHASES * RESAMPLE_MAX_TAPS];
+
+	printf("Resampling to %d Hz, %d seconds per trial, best of %d%s\n", OUTPUT_RATE, seconds, TRIALS,
+#ifdef RESAMPLE_SSE2
+		", SSE2"
+#else
+		""
+#endif
+	);
+	printf("%10s %16s %16s %6s\n", "input Hz", "linear Msamp/s", "filtered Msamp/s", "taps");
+
+	UINT64 total = UINT64(seconds) * 50 * CHUNK_SAMPLES;
+	for (int ratenum = 0; ratenum < ARRAY_LENGTH(input_rates); ratenum++)
+	{
+		int inrate = input_rates[ratenum];
+		UINT32 step = (UINT64(inrate) << RESAMPLE_FRAC_BITS) / OUTPUT_RATE;
+
+		// linear is always available
+		osd_ticks_t linear = time_resample(source, dest, inrate, seconds, NULL, 0);
+
+		// band-limited only when the rates differ and are close enough
+		int taps = (inrate == OUTPUT_RATE) ? 0 : stream_resample_taps(step);
+		if (taps != 0)
+		{
+			stream_build_resample_filter(filter, taps, step);
+			osd_ticks_t filtered = time_resample(source, dest, inrate, seconds, filter, taps);
+			printf("%10d %16.1f %16.1f %6d\n", inrate, rate(total, linear), rate(total, filtered), taps);
+		}
+		else
+			printf("%10d %16.1f %16s %6s\n", inrate, rate(total, linear), "-", "-");
+	}
+
+	// then the mixing
+	INT32 *left = new INT32[CHUNK_SAMPLES];
+	INT32 *right = new INT32[CHUNK_SAMPLES];
+	INT16 *final = new INT16[CHUNK_SAMPLES * 2];
+	memset(left, 0, CHUNK_SAMPLES * sizeof(*left));
+	memset(right, 0, CHUNK_SAMPLES * sizeof(*right));
+	osd_ticks_t addticks, clampticks;
+	time_mix(source, left, right, final, seconds, addticks, clampticks);
+	printf("\nMixing one stream into stereo: %.1f Msamp/s\n", rate(total, addticks));
+	printf("Final clamp and interleave: %.1f Msamp/s\n", rate(total, clampticks));
+
+	delete[] final;
+	delete[] right;
+	delete[] left;
+	delete[] filter;
+	delete[] dest;
+	delete[] source;
+	return 0;
+}
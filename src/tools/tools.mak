@@ -63,6 +63,10 @@ TOOLS += \
 	$(BIN)split$(EXE) \
 	$(BIN)pngcmp$(EXE) \
 	$(BIN)nltool$(EXE) \
+	$(BIN)sndbench$(EXE) \
+
+# membench links the whole core, so it is only built by 'make benchtools'
+MEMBENCH = $(BIN)membench$(EXE)
 
 
 #-------------------------------------------------
@@ -221,3 +225,28 @@ $(BIN)nltool$(EXE): $(NLTOOLOBJS) $(LIBUTIL) $(LIBOCORE) $(ZLIB) $(EXPAT)
 	@echo Linking $@...
 	$(LD) $(LDFLAGS) $^ $(BASELIBS) -o $@
 
+
+
+#-------------------------------------------------
+# membench
+#-------------------------------------------------
+
+MEMBENCHOBJS = \
+	$(TOOLSOBJ)/membench.o \
+
+$(BIN)membench$(EXE): $(VERSIONOBJ) $(MEMBENCHOBJS) $(LIBBUS) $(LIBOPTIONAL) $(LIBEMU) $(LIBDASM) $(LIBUTIL) $(EXPAT) $(SOFTFLOAT) $(JPEG_LIB) $(FLAC_LIB) $(7Z_LIB) $(FORMATS_LIB) $(LUA_LIB) $(SQLITE3_LIB) $(WEB_LIB) $(ZLIB) $(LIBOCORE)
+	@echo Linking $@...
+	$(LD) $(LDFLAGS) $^ $(BASELIBS) $(LIBS) -o $@
+
+
+
+#-------------------------------------------------
+# sndbench
+#-------------------------------------------------
+
+SNDBENCHOBJS = \
+	$(TOOLSOBJ)/sndbench.o \
+
+$(BIN)sndbench$(EXE): $(SNDBENCHOBJS) $(LIBOCORE)
+	@echo Linking $@...
+	$(LD) $(LDFLAGS) $^ $(BASELIBS) -o $@